@@ -2,6 +2,6 @@
 #define VERSION_H
 
 // 格式通常遵循语义化版本 (Semantic Versioning): 主版本.次版本.修订号
-#define APP_VERSION "1.2.6" 
+#define APP_VERSION "1.3.0" 
 
 #endif // VERSION_H
\ No newline at end of file
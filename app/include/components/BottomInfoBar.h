@@ -22,6 +22,8 @@ public:
 
 private slots:
     void updateUi();
+    // AgvData 字段变化通知
+    void onFieldsChanged(quint64 mask);
 
 signals:
     void mapIdChanged(int mapId);
@@ -44,9 +46,6 @@ private:
     // 特别记录 mapId
     int m_mapId = -1;
 
-    // 定时器更新 UI
-    QTimer *m_updateTimer;
-    const int UPDATE_INTERVAL_MS = 100;
 
     // 解析 label 需要显示的内容
     const QString handleMoveDir(int moveDir);
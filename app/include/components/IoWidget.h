@@ -20,6 +20,8 @@ protected:
 private slots:
     // 定时刷新槽函数
     void updateIoStatus();
+    // AgvData 字段变化通知
+    void onFieldsChanged(quint64 mask);
 
 private:
     // 初始化界面布局
@@ -35,8 +37,6 @@ private:
     QVector<QLabel *> m_xLamps; // 对应 X1-X24
     QVector<QLabel *> m_yLamps; // 对应 Y1-Y24
 
-    QTimer *m_updateTimer;
-    const int UPDATE_INTERVAL_MS = 100;
 
     QWidget *m_scrollContainer;
 };
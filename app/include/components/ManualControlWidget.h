@@ -34,6 +34,8 @@ protected:
 
 private slots:
     void updateUi();
+    // AgvData 字段变化通知
+    void onFieldsChanged(quint64 mask);
 
 private:
     // 日志管理器
@@ -52,10 +54,6 @@ private:
     ConfigManager *cfg = ConfigManager::instance();
 
     QCheckBox *chargeCheck; // 手动充电选择框
-
-    // 定时器更新 UI
-    QTimer *m_updateTimer;
-    const int UPDATE_INTERVAL_MS = 5000;
 };
 
 #endif
\ No newline at end of file
@@ -12,6 +12,8 @@
 #include <QJsonObject>
 #include "LogManager.h"
 #include "AgvData.h"
+#include "FrameLatencyMeter.h"
+#include <QElapsedTimer>
 
 // 前向声明，减少头文件耦合
 class BaseLayer;
@@ -54,6 +56,7 @@ protected:
     void mouseReleaseEvent(QMouseEvent *event) override;
     bool event(QEvent *event) override;
     void showEvent(QShowEvent *event) override;
+    void hideEvent(QHideEvent *event) override;
 
 signals:
     void pointClicked(int id);
@@ -64,10 +67,16 @@ public slots:
 
 private slots:
     // 业务回调与按钮逻辑
-    void updatePointCloud(const QVector<QPointF> &points);
+    void updatePointCloud(const PointCloudBufferPtr &cloud);
     void updateAgvState(const QVector<int> &agvState);
     // 响应固定重定位的返回数据
     void handleFixedRelocation(bool state, int x, int y, int angle);
+    // 按系统设置更新点云历史轨迹的帧数与内存上限
+    void applyCloudTrailConfig();
+    // 实时栅格地图：整幅替换或写入局部更新
+    void updateOccupancyGrid(const OccupancyGridPatch &grid);
+    // 关闭实时地图后恢复本地 PNG 地图
+    void applyMapSourceConfig();
 
 private:
     // 内部私有辅助逻辑
@@ -75,6 +84,8 @@ private:
     void handleMapJsonName(int mapId);
     bool isInDrawingArea(const QPointF &pos);
     void checkPointClick(const QPointF &screenPos);
+    // 绘制完成后登记点云的端到端时延，并定期输出统计
+    void recordCloudLatency();
 
 private:
     AgvData *agvData = AgvData::instance();
@@ -91,6 +102,7 @@ private:
     QPushButton *m_switchBtn = nullptr;
     QPushButton *m_confirmBtn = nullptr;
     QPushButton *m_cancelBtn = nullptr;
+    QLabel *m_fitLabel = nullptr; // 自由重定位时扫描与地图的匹配度
 
     // 视图变换变量
     double m_scale = 50.0;
@@ -103,6 +115,8 @@ private:
     double m_mapResolution = 0.05;
     QString m_mapName = "";
     QString m_mapJsonName = "";
+    int m_mapId = -1;       // 当前地图编号
+    bool m_liveMap = false; // 是否正在显示 /map 实时栅格地图
 
     // AGV 状态缓存
     int m_agvX = 0;
@@ -121,6 +135,13 @@ private:
     PointCloudLayer *m_pointCloudLayer = nullptr;
     RelocationLayer *m_reloLayer = nullptr;
     FixedRelocationLayer *m_fixedReloLayer = nullptr;
+
+    // 点云端到端时延：最新一帧的发出时刻在下一次绘制完成时结算
+    qint64 m_pendingCloudStampUs = -1;
+    qint64 m_lastCloudStampUs = -1; // 最近一次收到的帧时刻，用于识别重新降采样的同一帧
+    FrameLatencyMeter m_cloudLatency;
+    QElapsedTimer m_cloudLatencyReport;
+    const int CLOUD_LATENCY_REPORT_MS = 5000;
 };
 
 #endif // MONITORWIDGET_H
\ No newline at end of file
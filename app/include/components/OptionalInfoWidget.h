@@ -20,6 +20,8 @@ public:
 
 private slots:
     void updateUi();
+    // AgvData 字段变化通知
+    void onFieldsChanged(quint64 mask);
 
 private:
     // 日志管理器
@@ -28,8 +30,6 @@ private:
     QWidget *m_contentWidget;     
     QVBoxLayout *m_contentLayout; 
 
-    QTimer *m_updateTimer;
-    const int UPDATE_INTERVAL_MS = 100;
 
     // [新增] 注册表：Key -> 显示数值的 Label 指针
     // 用于快速查找某一行是否存在，从而决定是 update 还是 new
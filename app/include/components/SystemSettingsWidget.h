@@ -60,10 +60,18 @@ private:
     // 网络设置
     QLineEdit *m_commIpEdit;
     QSpinBox *m_commPortBox;
+    QCheckBox *m_commSubscribeCheck;
+    QSpinBox *m_commSubscribeRateBox;
+    QSpinBox *m_commTouchHeartbeatBox;
+    QCheckBox *m_commCborCheck;
+    QSpinBox *m_networkThreadsBox;
     QLineEdit *m_truckLoadingIpEdit;
     QSpinBox *m_truckLoadingPortBox;
     QLineEdit *m_rosBridgeIpEdit;
     QSpinBox *m_rosBridgePortBox;
+    QSpinBox *m_rosIdleLaserBox;    // 监控页面隐藏时的点云订阅
+    QSpinBox *m_rosIdleAgvStateBox; // 监控页面隐藏时的位姿订阅
+    QCheckBox *m_rosLiveMapCheck;
     QLineEdit *m_serverIpEdit;
     QSpinBox *m_serverPortBox;
 
@@ -76,6 +84,11 @@ private:
     QCheckBox *m_defaultFixedRelocationCheck;
     QCheckBox *m_debugModeCheck;
     QCheckBox *m_fullScreenCheck;
+    QComboBox *m_trafficCaptureCombo;
+    QSpinBox *m_trafficRingMinutesBox;
+    QSpinBox *m_cloudTrailScansBox;
+    QSpinBox *m_cloudTrailMemoryBox;
+    QSpinBox *m_relocationMinFitBox;
 
     // 按钮
     QPushButton *m_saveBtn;
@@ -5,6 +5,7 @@
 #include <QWidget>
 #include <QTimer>
 #include "NetworkCheckThread.h"
+#include "LinkLatencyTracker.h"
 #include "utils/ConfigManager.h"
 #include <QTimer>
 #include <QEvent>
@@ -32,6 +33,7 @@ public:
     void setAgvStatus(const QString &status);
     void setLightColor(const QString &colorStr); // 设置指示灯颜色的接口
     void setNetworkServerIp(const QString &ip);  // 设置要Ping的服务器IP
+    void setLinkLatency(const LinkLatencyStats &stats); // 显示数据通讯往返时延
 
 protected:
     // 重写事件过滤器
@@ -40,6 +42,8 @@ protected:
 private slots:
     void updateInfoFromConfig(); // 新增槽函数
     void updateUi();
+    // AgvData 字段变化通知
+    void onFieldsChanged(quint64 mask);
     void onNetworkStatusChanged(QString text, bool isNormal); // 处理网络线程返回的状态
     void onLogoLongPressed();                                 // 长按触发的槽函数
 
@@ -59,6 +63,8 @@ private:
     QLabel *m_ipLabel;
     QLabel *m_networkCheckNameLabel;
     QLabel *m_networkCheckValueLabel;
+    QLabel *m_linkLatencyLabel; // 网络状态右侧的往返时延 p50/p99
+    quint64 m_lastLinkLost = 0; // 上次显示时的累计丢包数，用于判断本周期是否新增丢包
     QLabel *m_runModeNameLabel; // 显示 "运行模式："
     QLabel *m_runModeValueLabel;
     QLabel *m_agvStatusNameLabel; // 显示 "当前状态："
@@ -69,10 +75,6 @@ private:
     // 辅助函数：给 Pixmap 染色
     QPixmap colorizePixmap(const QPixmap &src, const QColor &color);
 
-    // 定时器更新 UI
-    QTimer *m_updateTimer;
-    const int UPDATE_INTERVAL_MS = 100;
-
     void handleUserRoleUpdate(UserRole role);
     void handleLightUpdate(int light);
     void handleAgvModeUpdate(int agvMode);
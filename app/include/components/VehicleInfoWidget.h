@@ -49,6 +49,8 @@ protected:
 
 private slots:
     void updateUi();
+    // AgvData 字段变化通知
+    void onFieldsChanged(quint64 mask);
 
 private:
     // 日志管理器
@@ -73,9 +75,6 @@ private:
     void drawBumper(QPainter &painter, const QRect &rect, bool isTriggered);
     void drawRadarBox(QPainter &painter, const QRect &rect, SensorState state);
 
-    // 定时器更新 UI
-    QTimer *m_updateTimer;
-    const int UPDATE_INTERVAL_MS = 100;
 
     SensorState parseRadarState(int state);
     void handleArea(int backArea, int backRight, int backLeft, int frontArea, int frontLeft, int frontRight);
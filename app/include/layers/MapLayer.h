@@ -2,41 +2,144 @@
 #define MAPLAYER_H
 
 #include "BaseLayer.h"
+#include <QPaintDevice>
+#include <QImage>
+#include <QPixmap>
+#include <QVector>
+#include <cstring>
 
+// 本地 PNG 整幅载入，以一个 QPixmap 一次绘制
+// 实时栅格地图（/map）保留灰度图像并按 TILE x TILE 像素切分为瓦片绘制，/map_updates 只写入变化的区域，
+// 对应瓦片标记为脏，在下一次绘制且可见时才重新生成 QPixmap
 class MapLayer : public BaseLayer
 {
 public:
+    static constexpr int TILE = 256;
+
+    // 整幅替换（本地 PNG）：不保留源图像，之后不能局部更新
     void updateMap(const QPixmap &pixmap, double res, double ox, double oy)
     {
+        m_image = QImage();
         m_pixmap = pixmap;
-        m_res = res;
-        m_ox = ox;
-        m_oy = oy;
+        setGeometry(pixmap.width(), pixmap.height(), res, ox, oy);
+    }
+
+    // 整幅替换（实时栅格地图）：保留图像供局部更新，瓦片按需生成
+    void updateMap(const QImage &image, double res, double ox, double oy)
+    {
+        m_image = image;
+        m_pixmap = QPixmap();
+        setGeometry(image.width(), image.height(), res, ox, oy);
+    }
+
+    // 局部更新：patch 写入 topLeft（图像坐标）处，只标记相交的瓦片
+    // 当前地图不是可更新的栅格地图或格式不一致时返回 false
+    bool updateRegion(const QImage &patch, const QPoint &topLeft)
+    {
+        if (m_image.isNull() || patch.format() != m_image.format())
+            return false;
+
+        const QRect target = QRect(topLeft, patch.size()).intersected(m_image.rect());
+        if (target.isEmpty())
+            return true;
+
+        const int bpp = m_image.depth() / 8;
+        const int bytes = target.width() * bpp;
+        const int srcX = (target.x() - topLeft.x()) * bpp;
+        for (int y = target.top(); y <= target.bottom(); ++y)
+            std::memcpy(m_image.scanLine(y) + target.x() * bpp, patch.constScanLine(y - topLeft.y()) + srcX, static_cast<size_t>(bytes));
+
+        for (int row = target.top() / TILE; row <= target.bottom() / TILE; ++row)
+            for (int col = target.left() / TILE; col <= target.right() / TILE; ++col)
+                m_tiles[row * m_cols + col].dirty = true;
+        return true;
     }
 
+    // 地图尺寸（像素）
+    QSize size() const { return QSize(m_width, m_height); }
+    // 是否为可局部更新的栅格地图
+    bool isGrid() const { return !m_image.isNull(); }
+    // 实时栅格地图的当前图像（已合入局部更新），本地 PNG 时为空
+    const QImage &image() const { return m_image; }
+
     void draw(QPainter *painter) override
     {
-        if (m_pixmap.isNull())
+        if (m_pixmap.isNull() && m_tiles.isEmpty())
             return;
 
         painter->save();
         painter->translate(m_ox, m_oy);
+        const double h = m_height * m_res;
+
+        if (!m_pixmap.isNull())
+        {
+            // 显式使用 QRectF 确保匹配重载列表
+            QRectF targetRect(0, -h, m_width * m_res, h);
+            painter->drawPixmap(targetRect, m_pixmap, QRectF(m_pixmap.rect()));
+            painter->restore();
+            return;
+        }
 
-        double w = m_pixmap.width() * m_res;
-        double h = m_pixmap.height() * m_res;
+        // 瓦片边界落在小数像素上，开启抗锯齿或平滑缩放时相邻瓦片的边缘各自半透明混合，会留下接缝；
+        // 关闭后相邻瓦片按同一条边光栅化，栅格按最近邻放大，格子边界清晰
+        painter->setRenderHint(QPainter::Antialiasing, false);
+        painter->setRenderHint(QPainter::SmoothPixmapTransform, false);
 
-        // 显式使用 QRectF 确保匹配重载列表
-        QRectF targetRect(0.0, -h, w, h);
-        QRectF sourceRect(m_pixmap.rect()); // 将 QRect 转换为 QRectF
+        // 地图坐标下的可见范围，只绘制（和生成）与之相交的瓦片
+        const QRectF device(0, 0, painter->device()->width(), painter->device()->height());
+        const QRectF visible = painter->deviceTransform().inverted().mapRect(device);
 
-        painter->drawPixmap(targetRect, m_pixmap, sourceRect);
+        for (Tile &tile : m_tiles)
+        {
+            QRectF targetRect(tile.rect.x() * m_res, tile.rect.y() * m_res - h, tile.rect.width() * m_res, tile.rect.height() * m_res);
+            if (!visible.intersects(targetRect))
+                continue;
+            if (tile.dirty)
+            {
+                tile.pixmap = QPixmap::fromImage(m_image.copy(tile.rect));
+                tile.dirty = false;
+            }
+            painter->drawPixmap(targetRect, tile.pixmap, QRectF(tile.pixmap.rect()));
+        }
 
         painter->restore();
     }
 
 private:
-    QPixmap m_pixmap;
-    double m_res, m_ox, m_oy;
+    struct Tile
+    {
+        QRect rect; // 在地图图像中的位置
+        QPixmap pixmap;
+        bool dirty = true;
+    };
+
+    void setGeometry(int width, int height, double res, double ox, double oy)
+    {
+        m_width = width;
+        m_height = height;
+        m_res = res;
+        m_ox = ox;
+        m_oy = oy;
+        m_cols = (width + TILE - 1) / TILE;
+        const int rows = (height + TILE - 1) / TILE;
+
+        // 只有实时栅格地图切分瓦片
+        m_tiles.clear();
+        if (m_image.isNull())
+            return;
+        m_tiles.reserve(m_cols * rows);
+        for (int row = 0; row < rows; ++row)
+            for (int col = 0; col < m_cols; ++col)
+                m_tiles.append(Tile{QRect(col * TILE, row * TILE, qMin(TILE, width - col * TILE), qMin(TILE, height - row * TILE)), QPixmap(), true});
+    }
+
+    QVector<Tile> m_tiles;  // 实时栅格地图的瓦片，本地 PNG 时为空
+    QPixmap m_pixmap;       // 本地 PNG 地图，实时栅格地图时为空
+    QImage m_image; // 实时栅格地图的灰度图像，本地 PNG 时为空
+    int m_width = 0;
+    int m_height = 0;
+    int m_cols = 0;
+    double m_res = 0.05, m_ox = 0, m_oy = 0;
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -5,87 +5,96 @@
 #include <QVector>
 #include <QPointF>
 #include <QPainter>
+#include "utils/PointCloudBuffer.h"
+#include "utils/PointCloudRaster.h"
+#include "utils/PointCloudTrail.h"
+#include <QElapsedTimer>
 
 class PointCloudLayer : public BaseLayer
 {
 public:
-    PointCloudLayer() {}
+    PointCloudLayer() { m_clock.start(); }
 
-    void updatePoints(const QVector<QPointF> &points)
+    // 只持有共享缓冲区，不复制点；旧缓冲区在此释放后回到 PointCloudPool
+    // 开启历史轨迹时，被替换的上一帧连同其采集时的位姿复制进轨迹；重新降采样的同一帧不计入
+    void updatePoints(const PointCloudBufferPtr &cloud)
     {
-        m_points = points;
+        if (m_cloud && cloud && m_trail.maxScans() > 0 && (cloud->seq != m_cloud->seq || cloud->seq == 0))
+            m_trail.push(*m_cloud, m_cloudPos, m_cloudRad, m_clock.elapsed());
+        m_cloud = cloud;
+        m_cloudPos = m_agvPos;
+        m_cloudRad = m_agvRad;
     }
 
+    // 当前 AGV 位姿（m、rad），作为之后到达的点云的采集位姿
+    void updatePose(const QPointF &pos, double rad)
+    {
+        m_agvPos = pos;
+        m_agvRad = rad;
+    }
+
+    // 历史轨迹的帧数（0 表示关闭）与内存上限
+    void setTrailLimits(int scans, qint64 maxBytes) { m_trail.setLimits(scans, maxBytes); }
+    void clearTrail() { m_trail.clear(); }
+
     // 进入重定位时，将世界坐标点转换为相对于 AGV 的局部坐标点
     void lockToLocal(const QPointF &agvPos, double agvRad)
     {
-        m_localPoints.clear();
-        for (const QPointF &worldP : m_points)
+        const int n = m_cloud ? m_cloud->size() : 0;
+        m_localXy.resize(static_cast<size_t>(2 * n));
+        const double c = qCos(agvRad);
+        const double s = qSin(agvRad);
+        const float *xy = m_cloud ? m_cloud->xy() : nullptr;
+        for (int i = 0; i < n; ++i)
         {
             // 1. 平移到原点
-            double dx = worldP.x() - agvPos.x();
-            double dy = worldP.y() - agvPos.y();
+            double dx = xy[2 * i] - agvPos.x();
+            double dy = xy[2 * i + 1] - agvPos.y();
             // 2. 逆旋转 (x' = xcos + ysin, y' = -xsin + ycos)
-            double lx = dx * qCos(agvRad) + dy * qSin(agvRad);
-            double ly = -dx * qSin(agvRad) + dy * qCos(agvRad);
-            m_localPoints.append(QPointF(lx, ly));
+            m_localXy[2 * i] = static_cast<float>(dx * c + dy * s);
+            m_localXy[2 * i + 1] = static_cast<float>(-dx * s + dy * c);
         }
         m_isLocked = true;
     }
 
     void unlock() { m_isLocked = false; }
 
-    // 重写 draw，支持局部坐标绘制
+    // lockToLocal 得到的局部坐标点（x y 交错），供重定位评估与地图的吻合度
+    const std::vector<float> &localPoints() const { return m_localXy; }
+
+    // 当前持有的点数（降采样后）
+    int pointCount() const { return m_cloud ? m_cloud->size() : 0; }
+
+    // 世界坐标 (ROS 规范：y向上)，由 PointCloudRaster 一次变换全部点并写入固定大小的圆点
+    // 历史轨迹先于当前帧写入同一批次，最后只合成一次
     void draw(QPainter *painter) override
     {
-        if (m_isLocked || m_points.isEmpty())
+        if (m_isLocked || !m_cloud)
             return;
 
-        painter->save();
-        // 同样，避免直接 scale 轴，改为在绘制点时取反 y
-        painter->setPen(Qt::NoPen);
-        painter->setBrush(Qt::red);
-
-        double currentScale = qSqrt(qAbs(painter->transform().determinant()));
-        double pointRadius = 2.0 / currentScale;
-
-        for (const QPointF &p : m_points)
-        {
-            // p 为世界坐标 (ROS 规范：y向上)
-            painter->drawEllipse(QPointF(p.x(), -p.y()), pointRadius, pointRadius);
-        }
-        painter->restore();
+        m_raster.begin(painter);
+        m_trail.draw(m_raster, m_clock.elapsed(), qRgb(255, 0, 0));
+        m_raster.drawPoints(m_cloud->xy(), m_cloud->size(), qRgb(255, 0, 0));
+        m_raster.end();
     }
 
     // 提供给外部：直接绘制局部点（由外部 Painter 决定 AGV 位姿）
+    // 外部 painter 已经移到了 AGV 中心并旋转了角度，圆点大小固定为设备像素，不受旋转和缩放影响
     void drawLocal(QPainter *painter)
     {
-        // 外部 painter 已经移到了 AGV 中心并旋转了角度
-        painter->save();
-
-        // 1. 核心修正：绝对不要在这里调用 painter->scale(1, -1)！
-
-        // 2. 禁用画笔，防止出现黑色线团
-        painter->setPen(Qt::NoPen);
-        painter->setBrush(Qt::red);
-
-        // 3. 稳健地计算半径：使用 transform 的行列式或平均缩放比例
-        // 这样即便旋转，半径也保持恒定
-        double currentScale = qSqrt(qAbs(painter->transform().determinant()));
-        double pointRadius = 2.0 / currentScale;
-
-        for (const QPointF &p : m_localPoints)
-        {
-            // 4. 手动翻转坐标点的 Y 值，以适配 Qt 坐标系 (y向下)
-            // 而不是去翻转整个 Painter 坐标轴
-            painter->drawEllipse(QPointF(p.x(), -p.y()), pointRadius, pointRadius);
-        }
-        painter->restore();
+        m_raster.draw(painter, m_localXy.data(), static_cast<int>(m_localXy.size() / 2), qRgb(255, 0, 0));
     }
 
 private:
-    QVector<QPointF> m_points;      // 世界坐标点
-    QVector<QPointF> m_localPoints; // 局部坐标点
+    PointCloudBufferPtr m_cloud;    // 世界坐标点（与解码线程共享的只读缓冲区）
+    std::vector<float> m_localXy;   // 局部坐标点，x y 交错存放
+    PointCloudRaster m_raster;
+    PointCloudTrail m_trail;        // 历史帧
+    QElapsedTimer m_clock;          // 轨迹淡出的时间基准
+    QPointF m_agvPos;               // 最新 AGV 位姿
+    double m_agvRad = 0.0;
+    QPointF m_cloudPos;             // 当前帧的采集位姿
+    double m_cloudRad = 0.0;
     bool m_isLocked = false;
 };
 
@@ -3,7 +3,13 @@
 
 #include <QObject>
 #include <QPointF>
+#include <QImage>
+#include <QMutex>
+#include <QThread>
+#include <QTimer>
+#include <QWaitCondition>
 #include "LogManager.h"
+#include "MapDistanceField.h"
 
 class MonitorWidget;
 
@@ -19,6 +25,7 @@ public:
     };
 
     explicit RelocationController(MonitorWidget *parent);
+    ~RelocationController() override;
 
     // 业务接口
     void start();  // 进入重定位模式
@@ -30,13 +37,58 @@ public:
     void setMode(ReloMode mode);
     ReloMode currentMode() const { return m_currentMode; }
 
+    // 地图载入后在工作线程中计算距离变换，参数与 MapLayer::updateMap 一致
+    void setMap(const QImage &map, double res, double ox, double oy);
+    // 实时栅格地图局部更新（/map_updates）后调用：距离场延迟重建，连续的局部更新合并为一次
+    // 重建完成前沿用旧距离场，指示标签注明地图已更新，且不按吻合度拦截确认
+    void mapPatched();
+    // 自由重定位拖动中，按重定位图层的当前位姿评估锁定点云与地图的吻合度并更新指示
+    // 每次绘制调用一次，位姿与距离场都没有变化时直接返回
+    void updateFit();
+
 private:
     void exitMode(); // 统一退出逻辑
+    // 在工作线程中按 m_mapRes / m_mapOx / m_mapOy 计算距离场，完成后替换 m_field
+    void buildField(const QImage &map);
+    void fieldWorkerLoop();                                          // 距离场工作线程主循环
+    void applyField(int seq, const MapDistanceFieldPtr &field, qint64 ms); // 主线程中接收计算结果
+    // 吻合度低于系统设置的下限时返回 true（距离场未就绪或没有点云时不拦截）
+    bool fitTooLow() const;
+    void showFit(const QString &text, const QString &color);
 
 private:
     MonitorWidget *w;
     ReloMode m_currentMode = FreeMode; // 默认为自由模式
 
+    // 距离场：每次载入地图重新计算，m_fieldSeq 用于丢弃过期的计算结果
+    MapDistanceFieldPtr m_field;
+    int m_fieldSeq = 0;
+    double m_mapRes = 0.05, m_mapOx = 0, m_mapOy = 0;
+    // 局部更新后的延迟重建
+    QTimer *m_fieldRebuildTimer;
+    const int FIELD_REBUILD_DELAY_MS = 1000; // 最后一次局部更新之后的等待时间
+    bool m_fieldStale = false;               // 地图已局部更新，距离场尚未重建
+    // 距离场工作线程，随控制器创建、析构时等待退出
+    // 只保留最新的一个待计算请求，计算期间的新请求覆盖旧请求，不会有两次计算同时进行
+    struct FieldJob
+    {
+        int seq = 0;
+        QImage map;
+        double res = 0.05, ox = 0, oy = 0;
+    };
+    QThread *m_fieldWorker;
+    QMutex m_fieldMutex; // 保护以下三项
+    QWaitCondition m_fieldWake;
+    FieldJob m_fieldJob;
+    bool m_fieldJobPending = false;
+    bool m_fieldQuit = false;
+    // 最近一次评估的位姿与结果
+    bool m_fitValid = false;
+    QPointF m_fitPos;
+    double m_fitRad = 0.0;
+    MapDistanceField::Fit m_fit;
+    QString m_fitColor; // 指示标签当前的背景色
+
     // 日志管理器
     LogManager *logger = &LogManager::instance();
 };
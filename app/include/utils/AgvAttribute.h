@@ -3,18 +3,23 @@
 
 #include <QString>
 #include <QMetaType> // 用于信号槽传递自定义类型
+#include "AgvColorPalette.h"
 
 // 定义一个模板类，T 可以是 double, int, QString 等
+// 颜色以 AgvColorPalette 中的编号保存，T 为 int 时整个结构可以按位拷贝
 template <typename T>
 struct AgvAttribute {
     T value;        // 实际的值
-    QString color;  // 服务端指定的颜色
+    quint16 color;  // 服务端指定的颜色，AgvColorPalette 中的编号
 
     // 默认构造
-    AgvAttribute() : value(T()), color("#000000") {}
+    AgvAttribute() : value(T()), color(AgvColorPalette::DEFAULT_COLOR) {}
 
     // 构造函数
-    AgvAttribute(T v, const QString &c) : value(v), color(c) {}
+    AgvAttribute(T v, quint16 c = AgvColorPalette::DEFAULT_COLOR) : value(v), color(c) {}
+
+    // 颜色字符串，如 "#00FF00"
+    QString colorName() const { return AgvColorPalette::instance()->name(color); }
 
     // 重载 != 运算符，用于判断数据是否发生变化，减少无效 UI 刷新
     bool operator!=(const AgvAttribute<T> &other) const {
@@ -25,4 +30,4 @@ struct AgvAttribute {
 
 // 必须注册，否则不能在信号槽中直接作为参数传递
 // 注意：模板类的注册比较特殊，通常我们在使用的地方声明别名
-#endif // AGVATTRIBUTE_H
\ No newline at end of file
+#endif // AGVATTRIBUTE_H
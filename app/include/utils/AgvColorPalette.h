@@ -0,0 +1,42 @@
+#ifndef AGVCOLORPALETTE_H
+#define AGVCOLORPALETTE_H
+
+#include <QMutex>
+#include <QString>
+#include <QStringView>
+#include <atomic>
+
+// 服务端颜色字符串的驻留表
+// 协议中每个字段都带一个颜色（如 "#00FF00"），实际只会出现少数几种；
+// 按原始字符串登记一次后，AgvAttribute 只保存 16 位编号，解析和比较时不再有字符串拷贝
+// 登记项只增不删，查找无锁，登记新颜色时加锁
+// 保存原始字符串而不是解析后的 QRgb：目前没有界面读取颜色，解析只是多余的开销，
+// 且原文保存时 colorName() 能原样取回服务端给出的写法（大小写、简写形式）
+class AgvColorPalette
+{
+public:
+    static constexpr quint16 DEFAULT_COLOR = 0; // "#000000"，协议未给出颜色时使用
+    static constexpr int CAPACITY = 256;        // 颜色种类上限，超出后统一记为默认色
+
+    static AgvColorPalette *instance();
+
+    // 查找颜色字符串（区分大小写，按原文匹配）对应的编号，首次出现时登记
+    quint16 intern(QStringView name);
+
+    // 编号对应的颜色字符串，越界时返回默认色
+    QString name(quint16 index) const;
+
+    // 已登记的颜色数
+    int size() const { return m_count.load(std::memory_order_acquire); }
+
+private:
+    AgvColorPalette();
+
+    QString m_names[CAPACITY];
+    std::atomic<int> m_count{0}; // 已发布的登记项数，之前的项不再修改
+    QMutex m_writeMutex;         // 登记者之间互斥
+
+    int find(QStringView name, int count) const;
+};
+
+#endif // AGVCOLORPALETTE_H
@@ -1,25 +1,34 @@
 #ifndef AGVDATA_H
 #define AGVDATA_H
 
-#include "AgvAttribute.h"
+#include "AgvSnapshot.h"
+#include "AgvFrameDecoder.h"
 #include <QObject>
 #include <QMutex>
-#include <QReadWriteLock>
-#include <functional>
-#include <QHash>
 #include <QJsonObject>
 #include <atomic>
+#include <memory>
 #include "RosBridgeClient.h"
 #include <QThread>
 #include "LogManager.h"
-
-// 为了让信号槽能用，建议定义别名
-using AgvInt = AgvAttribute<int>;
-using AgvString = AgvAttribute<QString>;
-
-// 必须在类外注册元类型 (Qt 5/6)
-Q_DECLARE_METATYPE(AgvInt)
-Q_DECLARE_METATYPE(AgvString)
+#include "LatestMailbox.h"
+#include <QTimer>
+#include <QVector>
+#include <QPointF>
+
+// 网络线程到主线程的帧计数：frames 为收到的帧数，conflated 为主线程来不及处理而被合并的帧数，
+// dropped 为监控页面隐藏时丢弃的未送达帧数
+struct AgvMailboxStats
+{
+    quint64 stateFrames = 0;
+    quint64 stateConflated = 0;
+    quint64 pointCloudFrames = 0;
+    quint64 pointCloudConflated = 0;
+    quint64 pointCloudDropped = 0;
+    quint64 rosStateFrames = 0;
+    quint64 rosStateConflated = 0;
+    quint64 rosStateDropped = 0;
+};
 
 class AgvData : public QObject
 {
@@ -29,69 +38,28 @@ public:
     // 获取单例实例
     static AgvData *instance();
 
+    // 获取当前 AGV 状态快照（无锁，返回的快照在持有期间保持不变）
+    AgvSnapshotPtr snapshot() const;
+
+    // 状态、点云、/agv_state 三路数据的接收与合并计数
+    AgvMailboxStats mailboxStats() const;
+
+    // JSON 帧中 AGVInfo、OptionalINFO、AGV_TASK 因原文未变化而跳过解析的计数
+    AgvDecodeStats decodeStats() const;
+
     // --- Getters ---
+    // 单字段读取，内部同样基于 snapshot()；同一处需要读取多个字段时请直接使用 snapshot()
+#define AGV_DECLARE_GETTER(type, member, getter, key, init) type getter() const;
     // AGVInfo
-    AgvString agvErr() const;
-    AgvInt agvXin1() const;
-    AgvInt agvXin2() const;
-    AgvInt agvXin3() const;
-    AgvInt agvYout1() const;
-    AgvInt agvYout2() const;
-    AgvInt agvYout3() const;
-    AgvInt agvId() const;
-    AgvString agvName() const;
-    AgvInt battery() const;
-    AgvInt mapId() const;
-    AgvInt slamX() const;
-    AgvInt slamY() const;
-    AgvInt slamAngle() const;
-    AgvInt slamCov() const;
-    AgvInt vX() const;
-    AgvInt vY() const;
-    AgvInt vAngle() const;
-    AgvInt agvMode() const;
-    AgvInt agvState() const;
-    AgvInt light() const;
-    AgvInt frontArea() const;
-    AgvInt frontLeft() const;
-    AgvInt frontRight() const;
-    AgvInt backArea() const;
-    AgvInt backLeft() const;
-    AgvInt backRight() const;
-    AgvInt bumpBack() const;
-    AgvInt bumpFront() const;
-    AgvInt bumpLeft() const;
-    AgvInt bumpRight() const;
-    AgvInt eStopState() const;
-    AgvInt goodsState() const;
-    AgvInt moveDir() const;
-    AgvInt pointId() const;
-    AgvInt taskAct() const;
-    AgvInt taskParam() const;
-    AgvString taskDescription() const;
-    AgvInt runLength() const;
-    AgvInt runTime() const;
+    AGV_INFO_FIELDS(AGV_DECLARE_GETTER)
 
     // OptionalINFO
     QJsonObject optionalInfo() const;
-    AgvInt liftHeight() const;
+    AGV_OPTIONAL_INFO_FIELDS(AGV_DECLARE_GETTER)
 
     // AGV_TASK
-    AgvInt taskState() const;
-    AgvString taskId() const;
-    AgvInt taskStartId() const;
-    AgvInt taskStartX() const;
-    AgvInt taskStartY() const;
-    AgvInt taskEndId() const;
-    AgvInt taskEndX() const;
-    AgvInt taskEndY() const;
-    AgvInt pathStartId() const;
-    AgvInt pathStartX() const;
-    AgvInt pathStartY() const;
-    AgvInt pathEndId() const;
-    AgvInt pathEndX() const;
-    AgvInt pathEndY() const;
-    AgvString taskErr() const;
+    AGV_TASK_FIELDS(AGV_DECLARE_GETTER)
+#undef AGV_DECLARE_GETTER
 
     // TOUCH_STATE
     bool pageControl() const;
@@ -127,25 +95,53 @@ public:
     void setIniW(int value);
     void setMusic(int value);
 
-    // 解析来自 Websocket 的 JSON 数据
-    void parseAgvState(const QJsonObject &data);
-
-    // 校验并获取 json 数据
-    bool tryParseAgvJson(const QString &jsonStr, QJsonObject &resultObj);
-    void handleAgvInfo(const QJsonObject &data);
-    void handleOptionalInfo(const QJsonObject &data);
-    void handleAgvTask(const QJsonObject &data);
+    // 主线程：同步视图缩放（像素/米），点云在网络线程中按对应档位降采样；档位变化时重新降采样最近一帧
+    void setPointCloudViewScale(double pixelsPerMeter);
+    // 主线程：监控页面显示 / 隐藏，隐藏时点云与位姿按 ConfigManager 中的空闲策略退订或节流
+    void setRosViewActive(bool active);
 
 public slots:
     // --- 数据处理接口 ---
+    // 由 CommunicationWsClient 的通讯子线程直接调用 (DirectConnection)，不占用主线程
     void parseMsg(const QString &msg);
+    // CBOR 二进制帧入口，协商成功后由控制器发送，同样在通讯子线程中直接调用
+    void parseCborMsg(const QByteArray &data);
 
 signals:
     // --- 信号 ---
-    // 定义转发给 UI 的信号
-    void pointCloudDataReady(const QVector<QPointF> &points);
+    // 定义转发给 UI 的信号，均在主线程中发出，且只携带最新一帧
+    // 点云为只读共享缓冲区，接收方可长期持有，释放后由 PointCloudPool 回收
+    void pointCloudDataReady(const PointCloudBufferPtr &cloud);
     void agvStateChanged(const QVector<int> &state);
+    // 字段变化通知，mask 中的位由 agvFieldBit(AgvField::xxx) 给出；
+    // 主线程处理不及时时多帧的变化合并为一次通知
+    void fieldsChanged(quint64 mask);
+    // TOUCH_STATE 中任一字段的值发生变化（在调用 setter 的线程中发出）
+    void touchStateChanged();
+    // 收到控制器对 SUBSCRIBE 的应答，accepted 为 false 表示控制器拒绝订阅
+    void subscribeAckReceived(bool accepted, int rateMs);
+    // 收到控制器对 SET_ENCODING 的应答，encoding 为控制器确认使用的编码
+    void encodingAckReceived(bool accepted, const QString &encoding);
+    // 收到 AGV_STATE / AGV_TASK 时给出事件名与其中的 DataStamps（在通讯子线程中发出，缺失时为 -1）
+    void responseStampReceived(const QString &event, qint64 dataStamps);
     void requestInitialPose(const QPointF &pos, double angle);
+    // 点云降采样档位发生变化
+    void pointCloudZoomChanged();
+    // 监控页面显示状态发生变化
+    void rosViewActiveChanged(bool active);
+    // /map 与 /map_updates（主线程中按到达顺序逐帧发出，不合并）
+    void occupancyGridReady(const OccupancyGridPatch &grid);
+
+private slots:
+    // 在 I/O 线程中调用，写入邮箱
+    void onPointCloudReceived(PointCloudBufferPtr cloud);
+    void onRosAgvStateReceived(QVector<int> state);
+    // 在主线程中调用，取出最新帧并发出信号
+    void deliverFieldsChanged();
+    void deliverPointCloud();
+    void deliverRosAgvState();
+    void reportMailboxStats();
+    void reportDecodeStats();
 
 private:
     explicit AgvData(QObject *parent = nullptr);
@@ -154,84 +150,42 @@ private:
     // 初始化值
     void initData();
 
+    // 解码后的日志、应答信号与变化通知，JSON 与 CBOR 两种载体共用
+    void handleFrame(bool ok, const AgvFrame &frame, const QString &error);
+
     // 日志管理器
     LogManager *logger = &LogManager::instance();
 
-    // rosClient
+    // rosClient，托管在 NetworkReactor 的 I/O 线程中
     RosBridgeClient *m_rosClient;
-    QThread *m_rosThread;
-
-    // 定义一个解析器函数类型
-    using ParserFunc = std::function<void(const QJsonObject &)>;
-    // AGVInfo 映射表：Key -> 解析函数
-    QHash<QString, ParserFunc> m_agvInfoParsers;
-    QHash<QString, ParserFunc> m_optionalInfoParsers;
-    QHash<QString, ParserFunc> m_agvTaskParsers;
-    // 初始化映射表的函数
-    void initParsers();
-
-    // 成员变量
-    // AGVInfo
-    AgvString m_agvErr;          // agv 错误信息，Null 代表无错误
-    AgvInt m_xin1;               // 单片机输入端 X01-X08， 0 红，1 绿
-    AgvInt m_xin2;               // 单片机输入端 X09-X16， 0 红，1 绿
-    AgvInt m_xin3;               // 单片机输入端 X17-X24， 0 红，1 绿
-    AgvInt m_yout1;              // 单片机输出端 Y01-Y08， 0 红，1 绿
-    AgvInt m_yout2;              // 单片机输出端 Y09-Y16， 0 红，1 绿
-    AgvInt m_yout3;              // 单片机输出端 Y17-Y24， 0 红，1 绿
-    AgvInt m_agvId;              // AGV 编号
-    AgvString m_agvName;         // AGV 名称
-    AgvInt m_battery;            // AGV 剩余电量，单位 %
-    AgvInt m_mapId;              // 当前地图编号
-    AgvInt m_slamX;              // slam 定位的 X 坐标，单位 mm
-    AgvInt m_slamY;              // slam 定位的 Y 坐标，单位 mm
-    AgvInt m_slamAngle;          // slam 定位的角度，除以 100 后单位为度
-    AgvInt m_slamCov;            // slam 定位的协方差，实际值需要除以 1000
-    AgvInt m_vX;                 // AGV 的 X 方向线速度，单位 mm/s
-    AgvInt m_vY;                 // AGV 的 Y 方向线速度，单位 mm/s
-    AgvInt m_vAngle;             // AGV 的角速度，单位 百度/s
-    AgvInt m_agvMode;            // AGV 手自动状态，0 手动，1 自动
-    AgvInt m_agvState;           // AGV自动模式状态，0 待命，1 自动行走，2 自动动作，3 充电中，10 暂停
-    AgvInt m_light;              // 状态灯颜色，0 无色，1 红，2 绿，3 蓝，4 黄，5 紫，6 淡蓝，7 白
-    AgvInt m_frontArea;          // 前避障，0 不触发，1 触发减速，2 触发停车，Null 为无该区域信号
-    AgvInt m_frontLeft;          // 左前避障，0 不触发，1 触发减速，2 触发停车，Null 为无该区域信号
-    AgvInt m_frontRight;         // 右前避障，0 不触发，1 触发减速，2 触发停车，Null 为无该区域信号
-    AgvInt m_backArea;           // 后避障，0 不触发，1 触发减速，2 触发停车，Null 为无该区域信号
-    AgvInt m_backLeft;           // 左后避障，0 不触发，1 触发减速，2 触发停车，Null 为无该区域信号
-    AgvInt m_backRight;          // 右后避障，0 不触发，1 触发减速，2 触发停车，Null 为无该区域信号
-    AgvInt m_bumpBack;           // 后防撞条，0 不触发，1 触发，Null 为无该区域信号
-    AgvInt m_bumpFront;          // 前防撞条，0 不触发，1 触发，Null 为无该区域信号
-    AgvInt m_bumpLeft;           // 左防撞条，0 不触发，1 触发，Null 为无该区域信号
-    AgvInt m_bumpRight;          // 右防撞条，0 不触发，1 触发，Null 为无该区域信号
-    AgvInt m_estopState;         // 急停状态，0 未急停，1 急停按下
-    AgvInt m_goodsState;         // 载货状态，0无货，1单左货，2单右货，3左右货（双叉车型0123均有效，单叉或潜伏式0、3有效，Null为无货物信号）
-    AgvInt m_moveDir;            // 运动方向，0 停车，1 前进，2 后退，3 左横移，4 右横移，5 逆原，6 顺原（3、4仅全向车有效）
-    AgvInt m_pointId;            // AGV 当前对应地图点位号，Null代表附近无地图点位
-    AgvInt m_taskAct;            // AGV 自动模式下的任务动作号
-    AgvInt m_taskParam;          // AGV 自动模式下的任务动参
-    AgvString m_taskDescription; // AGV 自动模式下的任务描述
-    AgvInt m_runLength;          // 开机运行里程，单位 m
-    AgvInt m_runTime;            // 开机运行事件，单位 s
 
-    // OptionalINFO
-    AgvInt m_liftHeight; // 举升高度，单位 mm
-
-    // AGV_TASK
-    AgvInt m_taskState;   // AGV 自动模式下的当前任务状态，0 车上无任务，1 车上有任务，2 任务已完成，3 任务取消
-    AgvString m_taskId;   // AGV 自动模式下的当前任务号，若当前无任务则为 null
-    AgvInt m_taskStartId; // 任务起点
-    AgvInt m_taskStartX;  // 任务起点 x 坐标
-    AgvInt m_taskStartY;  // 任务起点 y 坐标
-    AgvInt m_taskEndId;   // 任务终点
-    AgvInt m_taskEndX;    // 任务终点 x 坐标
-    AgvInt m_taskEndY;    // 任务终点 y 坐标
-    AgvInt m_pathStartId; // 路径起点
-    AgvInt m_pathStartX;  // 路径起点 x 坐标
-    AgvInt m_pathStartY;  // 路径起点 y 坐标
-    AgvInt m_pathEndId;   // 路径终点
-    AgvInt m_pathEndX;    // 路径终点 x 坐标
-    AgvInt m_pathEndY;    // 路径终点 y 坐标
-    AgvString m_taskErr;  // 任务错误信息，为 Null 代表无错误
+    // 写线程持有的工作副本，每帧解析完成后整体发布
+    AgvSnapshot m_work;
+    // 当前已发布的快照，读写均通过 std::atomic_load / std::atomic_store 完成
+    AgvSnapshotPtr m_snapshot;
+    // 写者之间互斥（读者不参与）
+    QMutex m_writeMutex;
+    // 控制器帧解码器，仅在持有 m_writeMutex 时访问
+    AgvFrameDecoder m_decoder;
+    // 将 m_work 复制为新的不可变快照并发布
+    void publishSnapshot();
+
+    // 网络线程 -> 主线程：只保留最新帧，主线程来不及处理时合并而不是排队
+    std::atomic<quint64> m_notifyMask{0}; // 尚未送达主线程的字段变化位掩码
+    std::atomic<quint64> m_stateFrames{0};
+    std::atomic<quint64> m_stateConflated{0};
+    LatestMailbox<PointCloudBufferPtr> m_pointCloudBox;
+    bool m_rosViewActive = false; // 监控页面是否显示，仅在主线程访问
+    LatestMailbox<QVector<int>> m_rosStateBox;
+    void notifyFieldsChanged(quint64 mask);
+
+    QTimer *m_mailboxReportTimer;
+    const int MAILBOX_REPORT_MS = 10000; // 合并与丢弃计数的检查周期
+    AgvMailboxStats m_lastReported;      // 上次检查时的计数
+
+    QTimer *m_decodeReportTimer;
+    const int DECODE_REPORT_MS = 60000; // 段落跳过命中率的输出周期
+    AgvDecodeStats m_lastDecodeReported;
 
     // TOUCH_STATE
     std::atomic<bool> m_pageControl; // 页面控制信号，0启用，1关闭
@@ -250,10 +204,6 @@ private:
     std::atomic<int> m_iniW;  // 重定位w
     std::atomic<int> m_music; // 喇叭操作，0无，1切歌，2音量+，3音量-
 
-    // OptionalInfo 需要单独备份
-    QJsonObject m_optionalInfo;
-
-    mutable QReadWriteLock m_lock;
 };
 
 #endif // AGVDATA_H
\ No newline at end of file
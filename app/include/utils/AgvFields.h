@@ -0,0 +1,95 @@
+#ifndef AGVFIELDS_H
+#define AGVFIELDS_H
+
+#include <QtGlobal>
+
+// AGV 状态字段定义表，AgvSnapshot 成员、AgvData 的 Getter、初始值以及解析分发表均由此生成
+// 格式：X(类型, 快照成员名, Getter 名, 协议键名, 初始值)
+// 新增字段只需在对应段落添加一行
+
+// AGVInfo
+#define AGV_INFO_FIELDS(X) \
+    X(AgvString, agvErr, agvErr, "AGV_Err_Msg", "Initializing") /* agv 错误信息，Null 代表无错误 */ \
+    X(AgvInt, xin1, agvXin1, "Xin1", 0xff) /* 单片机输入端 X01-X08， 0 红，1 绿 */ \
+    X(AgvInt, xin2, agvXin2, "Xin2", 0xff) /* 单片机输入端 X09-X16， 0 红，1 绿 */ \
+    X(AgvInt, xin3, agvXin3, "Xin3", 0xff) /* 单片机输入端 X17-X24， 0 红，1 绿 */ \
+    X(AgvInt, yout1, agvYout1, "Yout1", 0x00) /* 单片机输出端 Y01-Y08， 0 红，1 绿 */ \
+    X(AgvInt, yout2, agvYout2, "Yout2", 0x00) /* 单片机输出端 Y09-Y16， 0 红，1 绿 */ \
+    X(AgvInt, yout3, agvYout3, "Yout3", 0x00) /* 单片机输出端 Y17-Y24， 0 红，1 绿 */ \
+    X(AgvInt, agvId, agvId, "agv_id", -1) /* AGV 编号 */ \
+    X(AgvString, agvName, agvName, "agv_name", "Unconnected") /* AGV 名称 */ \
+    X(AgvInt, battery, battery, "battery", 100) /* AGV 剩余电量，单位 % */ \
+    X(AgvInt, mapId, mapId, "map_id", 1) /* 当前地图编号 */ \
+    X(AgvInt, slamX, slamX, "slam_x", -1) /* slam 定位的 X 坐标，单位 mm */ \
+    X(AgvInt, slamY, slamY, "slam_y", -1) /* slam 定位的 Y 坐标，单位 mm */ \
+    X(AgvInt, slamAngle, slamAngle, "slam_angle", -1) /* slam 定位的角度，除以 100 后单位为度 */ \
+    X(AgvInt, slamCov, slamCov, "slam_cov", -1) /* slam 定位的协方差，实际值需要除以 1000 */ \
+    X(AgvInt, vX, vX, "v_x", -1) /* AGV 的 X 方向线速度，单位 mm/s */ \
+    X(AgvInt, vY, vY, "v_y", -1) /* AGV 的 Y 方向线速度，单位 mm/s */ \
+    X(AgvInt, vAngle, vAngle, "v_angle", -1) /* AGV 的角速度，单位 百度/s */ \
+    X(AgvInt, agvMode, agvMode, "agv_mode", 0) /* AGV 手自动状态，0 手动，1 自动 */ \
+    X(AgvInt, agvState, agvState, "agv_state", 0) /* AGV自动模式状态，0 待命，1 自动行走，2 自动动作，3 充电中，10 暂停 */ \
+    X(AgvInt, light, light, "light", 0) /* 状态灯颜色，0 无色，1 红，2 绿，3 蓝，4 黄，5 紫，6 淡蓝，7 白 */ \
+    X(AgvInt, frontArea, frontArea, "front_area", 2) /* 前避障，0 不触发，1 触发减速，2 触发停车，Null 为无该区域信号 */ \
+    X(AgvInt, frontLeft, frontLeft, "front_left", 2) /* 左前避障，0 不触发，1 触发减速，2 触发停车，Null 为无该区域信号 */ \
+    X(AgvInt, frontRight, frontRight, "front_right", 2) /* 右前避障，0 不触发，1 触发减速，2 触发停车，Null 为无该区域信号 */ \
+    X(AgvInt, backArea, backArea, "back_area", 2) /* 后避障，0 不触发，1 触发减速，2 触发停车，Null 为无该区域信号 */ \
+    X(AgvInt, backLeft, backLeft, "back_left", 2) /* 左后避障，0 不触发，1 触发减速，2 触发停车，Null 为无该区域信号 */ \
+    X(AgvInt, backRight, backRight, "back_right", 2) /* 右后避障，0 不触发，1 触发减速，2 触发停车，Null 为无该区域信号 */ \
+    X(AgvInt, bumpBack, bumpBack, "bump_back", 1) /* 后防撞条，0 不触发，1 触发，Null 为无该区域信号 */ \
+    X(AgvInt, bumpFront, bumpFront, "bump_front", 1) /* 前防撞条，0 不触发，1 触发，Null 为无该区域信号 */ \
+    X(AgvInt, bumpLeft, bumpLeft, "bump_left", 1) /* 左防撞条，0 不触发，1 触发，Null 为无该区域信号 */ \
+    X(AgvInt, bumpRight, bumpRight, "bump_right", 1) /* 右防撞条，0 不触发，1 触发，Null 为无该区域信号 */ \
+    X(AgvInt, estopState, eStopState, "estop_state", 1) /* 急停状态，0 未急停，1 急停按下 */ \
+    X(AgvInt, goodsState, goodsState, "goods_state", 0) /* 载货状态，0无货，1单左货，2单右货，3左右货（双叉车型0123均有效，单叉或潜伏式0、3有效，Null为无货物信号） */ \
+    X(AgvInt, moveDir, moveDir, "move_dir", 0) /* 运动方向，0 停车，1 前进，2 后退，3 左横移，4 右横移，5 逆原，6 顺原（3、4仅全向车有效） */ \
+    X(AgvInt, pointId, pointId, "point_id", 0) /* AGV 当前对应地图点位号，Null代表附近无地图点位 */ \
+    X(AgvInt, taskAct, taskAct, "task_act", 0) /* AGV 自动模式下的任务动作号 */ \
+    X(AgvInt, taskParam, taskParam, "task_param", 0) /* AGV 自动模式下的任务动参 */ \
+    X(AgvString, taskDescription, taskDescription, "task_description", "") /* AGV 自动模式下的任务描述 */ \
+    X(AgvInt, runLength, runLength, "run_length", 0) /* 开机运行里程，单位 m */ \
+    X(AgvInt, runTime, runTime, "run_time", 0) /* 开机运行事件，单位 s */
+
+// OptionalINFO
+#define AGV_OPTIONAL_INFO_FIELDS(X) \
+    X(AgvInt, liftHeight, liftHeight, "lift_height", 0) /* 举升高度，单位 mm */
+
+// AGV_TASK
+#define AGV_TASK_FIELDS(X) \
+    X(AgvInt, taskState, taskState, "task_state", 0) /* AGV 自动模式下的当前任务状态，0 车上无任务，1 车上有任务，2 任务已完成，3 任务取消 */ \
+    X(AgvString, taskId, taskId, "task_id", "NULL") /* AGV 自动模式下的当前任务号，若当前无任务则为 null */ \
+    X(AgvInt, taskStartId, taskStartId, "task_start_id", 0) /* 任务起点 */ \
+    X(AgvInt, taskStartX, taskStartX, "task_start_x", 0) /* 任务起点 x 坐标 */ \
+    X(AgvInt, taskStartY, taskStartY, "task_start_y", 0) /* 任务起点 y 坐标 */ \
+    X(AgvInt, taskEndId, taskEndId, "task_end_id", 0) /* 任务终点 */ \
+    X(AgvInt, taskEndX, taskEndX, "task_end_x", 0) /* 任务终点 x 坐标 */ \
+    X(AgvInt, taskEndY, taskEndY, "task_end_y", 0) /* 任务终点 y 坐标 */ \
+    X(AgvInt, pathStartId, pathStartId, "path_start_id", 0) /* 路径起点 */ \
+    X(AgvInt, pathStartX, pathStartX, "path_start_x", 0) /* 路径起点 x 坐标 */ \
+    X(AgvInt, pathStartY, pathStartY, "path_start_y", 0) /* 路径起点 y 坐标 */ \
+    X(AgvInt, pathEndId, pathEndId, "path_end_id", 0) /* 路径终点 */ \
+    X(AgvInt, pathEndX, pathEndX, "path_end_x", 0) /* 路径终点 x 坐标 */ \
+    X(AgvInt, pathEndY, pathEndY, "path_end_y", 0) /* 路径终点 y 坐标 */ \
+    X(AgvString, taskErr, taskErr, "TASK_Err_Msg", "NULL") /* 任务错误信息，为 Null 代表无错误 */
+
+// 字段编号，每个字段对应 AgvData::fieldsChanged 位掩码中的一位
+enum class AgvField : int
+{
+#define AGV_FIELD_ENUM(type, member, getter, key, init) member,
+    AGV_INFO_FIELDS(AGV_FIELD_ENUM)
+    optionalInfo, // OptionalINFO 原始对象整体
+    AGV_OPTIONAL_INFO_FIELDS(AGV_FIELD_ENUM)
+    AGV_TASK_FIELDS(AGV_FIELD_ENUM)
+#undef AGV_FIELD_ENUM
+    Count
+};
+
+static_assert(static_cast<int>(AgvField::Count) <= 64, "字段数量超过 64，fieldsChanged 的位掩码需要扩展");
+
+// 获取字段在位掩码中对应的位
+constexpr quint64 agvFieldBit(AgvField field)
+{
+    return quint64(1) << static_cast<int>(field);
+}
+
+#endif // AGVFIELDS_H
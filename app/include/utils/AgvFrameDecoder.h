@@ -0,0 +1,81 @@
+#ifndef AGVFRAMEDECODER_H
+#define AGVFRAMEDECODER_H
+
+#include "AgvSnapshot.h"
+#include <QString>
+#include <QStringView>
+#include <QByteArray>
+#include <QJsonObject>
+#include <atomic>
+
+// 一帧控制器消息的解码结果
+struct AgvFrame
+{
+    QString event;         // Event，常见事件名引用静态字符串，不产生分配
+    bool isSucceed = false; // IsSucceed
+    qint64 dataStamps = -1; // DataStamps，缺失时为 -1
+    quint64 changed = 0;    // 写入快照时发生变化的字段位掩码，位由 agvFieldBit(AgvField::xxx) 给出
+    QJsonObject body;       // 非状态事件（SUBSCRIBE_ACK 等）的 Body；AGV_STATE / AGV_TASK 直接写入快照，此处为空
+    QString warning;        // 帧结构不完整但已部分写入时的提示，如缺少 OptionalINFO
+};
+
+// 流式解析按原文哈希跳过未变化段落的计数
+// xxxSections 为收到的段落数，xxxSkipped 为与上一帧相同而跳过解析的段落数
+struct AgvDecodeStats
+{
+    quint64 agvInfoSections = 0;
+    quint64 agvInfoSkipped = 0;
+    quint64 optionalInfoSections = 0;
+    quint64 optionalInfoSkipped = 0;
+    quint64 agvTaskSections = 0;
+    quint64 agvTaskSkipped = 0;
+};
+
+// 控制器帧解码器：把 AGV_STATE / AGV_TASK 的字段直接写入 AgvSnapshot
+// 不是线程安全的，由调用方（AgvData）在持有写锁时使用
+class AgvFrameDecoder
+{
+public:
+    // JSON 文本帧，单遍流式解析：在 QWebSocket 交付的 UTF-16 文本上逐 token 读取，不构建 QJsonDocument
+    // 返回 false 表示帧非法，error 给出原因；此时 frame.changed 仍记录已写入 dst 的字段
+    bool decodeJson(QStringView msg, AgvSnapshot &dst, AgvFrame &frame, QString &error);
+
+    // JSON 文本帧，DOM 解析（QJsonDocument 建树后取值），结果与 decodeJson 一致
+    // 保留作为 AgvBench 的对照基准
+    bool decodeJsonDom(const QString &msg, AgvSnapshot &dst, AgvFrame &frame, QString &error);
+
+    // CBOR 二进制帧，帧结构与 JSON 相同
+    bool decodeCbor(const QByteArray &data, AgvSnapshot &dst, AgvFrame &frame, QString &error);
+
+    // 段落跳过计数，可在其他线程读取
+    AgvDecodeStats stats() const;
+
+private:
+    // 段落原文的哈希与长度，length 为 -1 表示无效
+    struct SectionHash
+    {
+        quint64 hash = 0;
+        int length = -1;
+    };
+
+    // 上一次写入快照的 AGVInfo、OptionalINFO、AGV_TASK 原文摘要，未变化时整段跳过解析和变化比较
+    // 只对流式路径有效，其他路径写入快照后清空
+    SectionHash m_agvInfoHash;
+    SectionHash m_optionalInfoHash;
+    SectionHash m_agvTaskHash;
+
+    std::atomic<quint64> m_agvInfoSections{0};
+    std::atomic<quint64> m_agvInfoSkipped{0};
+    std::atomic<quint64> m_optionalInfoSections{0};
+    std::atomic<quint64> m_optionalInfoSkipped{0};
+    std::atomic<quint64> m_agvTaskSections{0};
+    std::atomic<quint64> m_agvTaskSkipped{0};
+
+    // 原文与上一次相同时返回 true，否则记下新的摘要并返回 false
+    static bool sameSection(SectionHash &last, QStringView raw);
+    void resetSectionHashes();
+
+    bool decodeAgvStateBody(QStringView body, AgvSnapshot &dst, AgvFrame &frame, QString &error);
+};
+
+#endif // AGVFRAMEDECODER_H
@@ -0,0 +1,76 @@
+#ifndef AGVJSONREADER_H
+#define AGVJSONREADER_H
+
+#include <QString>
+#include <QStringView>
+
+class QJsonObject;
+class QJsonValue;
+
+// 面向控制器协议的 JSON 拉取式解析器（SAX 风格）
+// 直接在 QWebSocket 交付的 UTF-16 文本上逐个读取 token，不构建 QJsonDocument；
+// 调用方按协议结构依次调用 beginObject / nextKey / readXxx / skipValue
+// 遇到非法输入时置错误标志，之后的所有读取都返回失败
+class AgvJsonReader
+{
+public:
+    enum class Type
+    {
+        Object,
+        Array,
+        String,
+        Number,
+        Bool,
+        Null,
+        Invalid
+    };
+
+    explicit AgvJsonReader(QStringView text);
+
+    bool hasError() const { return m_error; }
+    // 是否已到达输入末尾（忽略空白）
+    bool atEnd();
+
+    // 下一个值的类型（不消费）
+    Type peekType();
+
+    // 消费 '{'
+    bool beginObject();
+    // 读取下一个键名并消费其后的 ':'；遇到 '}' 时消费并返回 false
+    // 成员之间必须恰好有一个逗号，缺少或重复的逗号以及 '}' 前多余的逗号都置错误标志
+    // 键名不含转义时 key 直接指向原文，否则指向内部缓冲区，在下一次 nextKey 前有效
+    bool nextKey(QStringView &key);
+
+    // 读取各类标量值
+    bool readString(QString &out);
+    // 读取字符串但不复制：无转义时 out 直接指向原文，否则指向内部缓冲区，在下一次 readString 前有效
+    bool readString(QStringView &out);
+    bool readNumber(double &out);
+    bool readBool(bool &out);
+
+    // 跳过任意一个值（包括嵌套的对象和数组）
+    bool skipValue();
+    // 跳过一个值并返回其原始文本
+    bool readRaw(QStringView &raw);
+    // 读取一个对象并构建 QJsonObject，仅用于需要保存原始对象的段落
+    bool readObject(QJsonObject &out);
+
+private:
+    const QChar *m_pos;
+    const QChar *m_end;
+    bool m_error = false;
+    bool m_firstMember = false; // 刚消费 '{'，下一个成员前不应有逗号
+    QString m_keyBuf; // 含转义字符的键名解码后存放于此
+    QString m_strBuf; // 含转义字符的字符串值解码后存放于此
+
+    void skipWhitespace();
+    bool fail();
+    // m_pos 指向起始 '"'；解码到 out，或在无转义时仅返回原文范围
+    bool scanString(QStringView &view, bool &escaped);
+    bool decodeString(const QChar *from, const QChar *to, QString &out);
+    bool skipString();
+    bool readJsonValue(QJsonValue &out, int depth);
+    bool readJsonObject(QJsonObject &out, int depth);
+};
+
+#endif // AGVJSONREADER_H
@@ -0,0 +1,52 @@
+#ifndef AGVSNAPSHOT_H
+#define AGVSNAPSHOT_H
+
+#include "AgvAttribute.h"
+#include "AgvFields.h"
+#include <QJsonObject>
+#include <memory>
+#include <type_traits>
+
+// 为了让信号槽能用，建议定义别名
+using AgvInt = AgvAttribute<int>;
+using AgvString = AgvAttribute<QString>;
+
+// 整数字段不含字符串，解析写入与变化比较都是按位操作
+static_assert(std::is_trivially_copyable<AgvInt>::value, "AgvInt 应当可以按位拷贝");
+
+// 必须在类外注册元类型 (Qt 5/6)
+Q_DECLARE_METATYPE(AgvInt)
+Q_DECLARE_METATYPE(AgvString)
+
+// AGV 状态的不可变快照
+// 通讯线程每解析完一帧就发布一份新的快照，UI 线程通过 AgvData::snapshot() 一次性取得同一帧的全部字段，读取过程不加锁
+struct AgvSnapshot
+{
+#define AGV_DECLARE_MEMBER(type, member, getter, key, init) type member;
+    // AGVInfo
+    AGV_INFO_FIELDS(AGV_DECLARE_MEMBER)
+
+    // OptionalINFO
+    QJsonObject optionalInfo; // OptionalINFO 原始对象，供 OptionalInfoWidget 遍历显示
+    AGV_OPTIONAL_INFO_FIELDS(AGV_DECLARE_MEMBER)
+
+    // AGV_TASK
+    AGV_TASK_FIELDS(AGV_DECLARE_MEMBER)
+#undef AGV_DECLARE_MEMBER
+
+    // 各字段取 AgvFields.h 中的初始值，AgvData 与基准程序共用
+    static AgvSnapshot initial()
+    {
+        AgvSnapshot snap;
+#define AGV_INIT_FIELD(type, member, getter, key, init) snap.member = type(init);
+        AGV_INFO_FIELDS(AGV_INIT_FIELD)
+        AGV_OPTIONAL_INFO_FIELDS(AGV_INIT_FIELD)
+        AGV_TASK_FIELDS(AGV_INIT_FIELD)
+#undef AGV_INIT_FIELD
+        return snap;
+    }
+};
+
+using AgvSnapshotPtr = std::shared_ptr<const AgvSnapshot>;
+
+#endif // AGVSNAPSHOT_H
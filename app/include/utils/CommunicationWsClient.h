@@ -4,12 +4,19 @@
 #include <QObject>
 #include <QThread>
 #include <QJsonObject>
+#include <QJsonArray>
 #include <QJsonDocument>
 #include <QDateTime>
+#include <QCborValue>
+#include <QElapsedTimer>
+#include <atomic>
 #include "WebsocketClient.h" // 引用之前的底层客户端
 #include "ManualControlWidget.h"
 #include "utils/ConfigManager.h"
 #include "AgvData.h"
+#include "LinkLatencyTracker.h"
+#include "NetworkReactor.h"
+#include "FrameEncoder.h"
 
 class CommunicationWsClient : public QObject
 {
@@ -26,45 +33,104 @@ public:
     // --- 业务接口 ---
     // 发送 AGV 状态请求 (封装具体的 JSON 协议)
     void sendAgvStateRequest();
+    // 发送 TOUCH_STATE（控制帧，优先发送）
+    void sendTouchState();
 
 signals:
     // --- 向外（UI）暴露的信号 ---
     // 连接状态改变：true=在线，false=离线
     void connectionStatusChanged(bool isConnected);
-    void textReceived(const QString &msg);
-    // --- 内部信号 (用于跨线程通讯) ---
-    void sigInternalSendText(const QString &msg);
+    // 往返时延统计，每秒更新一次
+    void linkLatencyUpdated(const LinkLatencyStats &stats);
 
 private slots:
     // 内部处理底层连接成功
     void onInternalConnected();
     // 内部处理底层断开
     void onInternalDisconnected();
-    // 内部处理底层消息
-    void onInternalTextReceived(const QString &msg);
+    // 控制器对 SUBSCRIBE 的应答
+    void onSubscribeAck(bool accepted, int rateMs);
+    // 等待 SUBSCRIBE_ACK 超时，回退到轮询
+    void onSubscribeAckTimeout();
+    // 订阅模式下检查推送是否中断
+    void onPushWatchdog();
+    // AgvData 的 TOUCH_STATE 字段发生变化
+    void onTouchStateChanged();
+    // 控制器对 SET_ENCODING 的应答
+    void onEncodingAck(bool accepted, const QString &encoding);
+    // 等待 SET_ENCODING_ACK 超时，保持 JSON 文本帧
+    void onEncodingAckTimeout();
+    // 汇总并发出时延统计
+    void onLatencyReport();
 
 private:
-    WebsocketClient *m_client;
-    QThread *m_thread;
+    WebsocketClient *m_client; // 托管在 NetworkReactor 的 I/O 线程中
 
     // 日志管理器
     LogManager *logger = &LogManager::instance();
     
     QTimer *m_pollTimer;             // 用于持续触发请求
     const int POLL_INTERVAL_MS = 50; // 轮询间隔
-    uint64_t dataStamps;             // 数据戳
 
-    QJsonObject requestState; // 轮询 AGV_STATE
-    QJsonObject requestTask;  // 轮询 AGV_TASK
-    QJsonObject touchState;   // 轮询 TOUCH_STATE
+    // TOUCH_STATE 在值变化时立即发送，空闲时按心跳周期补发，维持控制器看门狗
+    // 心跳周期取自 ConfigManager::commTouchHeartbeatMs，默认 200 ms（5 Hz）的低频心跳；控制器看门狗超时更短时在系统设置中调小
+    QTimer *m_touchHeartbeatTimer;
+    const int MIN_TOUCH_HEARTBEAT_MS = 20; // 配置值的下限
+    bool m_touchSendPending = false;    // 已投递一次合并发送，同一轮事件中的多次变化只发一帧
+    bool m_connected = false;           // 当前是否在线
+    // 数据戳：每个轮询周期取一个新值，AGV_STATE 与 AGV_TASK 共用并各自回显
+    // 控制器按 int 解析，到达 int 上限后显式回绕到 0
+    qint64 dataStamps;
+    qint64 nextDataStamps();
+
+    // 往返时延：按数据戳匹配请求与应答，同一周期的两路应答以位掩码区分
+    LinkLatencyTracker m_latency;
+    static constexpr quint32 RESPONSE_STATE = 0x1; // AGV_STATE 应答
+    static constexpr quint32 RESPONSE_TASK = 0x2;  // AGV_TASK 应答
+    QTimer *m_latencyReportTimer;
+    const int LATENCY_REPORT_MS = 1000; // 统计上报周期
+
+    // 高频帧使用预编译模板，每次只写入时间、数据戳和 Body 的值
+    FrameEncoder requestState; // 轮询 AGV_STATE
+    FrameEncoder requestTask;  // 轮询 AGV_TASK
+    FrameEncoder touchState;   // 轮询 TOUCH_STATE
+    // 低频的协商帧 Body 结构不固定，仍使用 QJsonObject
+    QJsonObject subscribeReq; // 订阅 AGV_STATE / AGV_TASK
+    QJsonObject encodingReq;  // 协商帧编码
+
+    // 订阅模式
+    bool m_subscribed = false;                 // 控制器已确认订阅，此时不再轮询 AGV_STATE / AGV_TASK
+    QTimer *m_subscribeAckTimer;               // 等待 SUBSCRIBE_ACK 的超时定时器
+    const int SUBSCRIBE_ACK_TIMEOUT_MS = 1000; // 超时未应答则认为控制器不支持订阅
+    void sendSubscribeRequest();
+
+    // 推送看门狗：订阅后超过 m_pushTimeoutMs 未收到 AGV_STATE / AGV_TASK，回退到轮询并重新订阅
+    // 定周期推送取确认周期的若干倍；变化即推送时车辆静止也不会有数据，只能用较长的超时
+    QTimer *m_pushWatchdogTimer;
+    QElapsedTimer m_pushClock;
+    std::atomic<qint64> m_lastResponseMs{0}; // 最近一次收到 AGV_STATE / AGV_TASK 的时刻（m_pushClock），通讯子线程写入
+    int m_pushTimeoutMs = 0;
+    const int PUSH_WATCHDOG_RATE_MULTIPLE = 4;    // 定周期推送：超时为确认周期的倍数
+    const int PUSH_WATCHDOG_MIN_MS = 1000;        // 定周期推送：超时下限
+    const int PUSH_WATCHDOG_ON_CHANGE_MS = 10000; // 变化即推送：超时
+
+    // 帧编码协商：JSON 文本帧始终可用，控制器确认后改用 CBOR 二进制帧发送
+    bool m_binaryFraming = false;             // 控制器已确认 CBOR，发送改走二进制帧
+    QTimer *m_encodingAckTimer;               // 等待 SET_ENCODING_ACK 的超时定时器
+    const int ENCODING_ACK_TIMEOUT_MS = 1000; // 超时未应答则认为控制器只支持 JSON
+    void sendEncodingRequest();
 
     void initalReqJson(); // 初始化请求 json
 
     ConfigManager *cfg = ConfigManager::instance(); // cfg
     AgvData *agvData = AgvData::instance();         // agvData
 
-    // 处理 TOUCH_STATE Body 的赋值
-    QJsonObject getTouchStateBody();
+    // 处理 TOUCH_STATE Body 的赋值，返回是否需要打印本帧
+    bool fillTouchStateBody();
+
+    // 按当前协商的编码序列化并通过底层客户端的发送队列发送
+    void sendFrame(const QJsonObject &frame, WebsocketClient::SendPriority priority);
+    void sendFrame(FrameEncoder &frame, WebsocketClient::SendPriority priority);
 };
 
 #endif // COMMUNICATIONWSCLIENT_H
\ No newline at end of file
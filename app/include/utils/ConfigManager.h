@@ -50,10 +50,18 @@ public:
     // 网络通信
     QString commIp() const;
     int commPort() const;
+    bool commSubscribe() const;
+    int commSubscribeRateMs() const;
+    int commTouchHeartbeatMs() const;
+    bool commCbor() const;
+    int networkThreads() const;
     QString truckLoadingIp() const;
     int truckLoadingPort() const;
     QString rosBridgeIp() const;
     int rosBridgePort() const;
+    int rosIdleLaserPointsMs() const;
+    int rosIdleAgvStateMs() const;
+    bool rosLiveMap() const;
     QString serverIp() const;
     int serverPort() const;
     // 其他通讯
@@ -64,6 +72,11 @@ public:
     bool defaultFixedRelocation() const;
     bool debugMode() const;
     bool fullScreen() const;
+    int trafficCapture() const;
+    int trafficRingMinutes() const;
+    int cloudTrailScans() const;
+    int cloudTrailMemoryMb() const;
+    int relocationMinFit() const;
 
     // --- Setters (供设置界面修改) ---
     // 车体参数
@@ -83,10 +96,18 @@ public:
     // 网络通信
     void setCommIp(const QString &ip);
     void setCommPort(int port);
+    void setCommSubscribe(bool enable);
+    void setCommSubscribeRateMs(int rateMs);
+    void setCommTouchHeartbeatMs(int intervalMs);
+    void setCommCbor(bool enable);
+    void setNetworkThreads(int count);
     void setTruckLoadingIp(const QString &ip);
     void setTruckLoadingPort(int port);
     void setRosBridgeIp(const QString &ip);
     void setRosBridgePort(int port);
+    void setRosIdleLaserPointsMs(int ms);
+    void setRosIdleAgvStateMs(int ms);
+    void setRosLiveMap(bool enable);
     void setServerIp(const QString &ip);
     void setServerPort(int port);
     // 其他通讯
@@ -97,6 +118,11 @@ public:
     void setDefaultFixedRelocation(bool enable);
     void setDebugMode(bool enable);
     void setFullScreen(bool enable);
+    void setTrafficCapture(int mode);
+    void setTrafficRingMinutes(int minutes);
+    void setCloudTrailScans(int scans);
+    void setCloudTrailMemoryMb(int mb);
+    void setRelocationMinFit(int percent);
 
 signals:
     // 当保存配置时触发，所有监听者(如Header)收到此信号后自我刷新
@@ -130,10 +156,18 @@ private:
     // 网络通信
     QString m_commIp;
     std::atomic<int> m_commPort;
+    std::atomic<bool> m_commSubscribe;      // 是否启用订阅模式（服务端主动推送 AGV_STATE / AGV_TASK）
+    std::atomic<int> m_commSubscribeRateMs; // 订阅模式下的推送周期，0 表示数据变化时推送
+    std::atomic<int> m_commTouchHeartbeatMs; // TOUCH_STATE 无变化时的补发周期，需短于控制器看门狗超时
+    std::atomic<bool> m_commCbor;           // 是否协商 CBOR 二进制帧，控制器不支持时保持 JSON 文本帧
+    std::atomic<int> m_networkThreads;      // 网络 I/O 共享线程数（数据通讯链路始终独占），0 表示每个连接独占一个线程；重启生效
     QString m_truckLoadingIp;
     std::atomic<int> m_truckLoadingPort;
     QString m_rosbridgeIp;
     std::atomic<int> m_rosbridgePort;
+    std::atomic<int> m_rosIdleLaserPointsMs; // 监控页面隐藏时 /laser_points 的订阅：-1 退订，0 全速，>0 为 throttle_rate（ms）
+    std::atomic<int> m_rosIdleAgvStateMs;    // 监控页面隐藏时 /agv_state 的订阅，取值同上
+    std::atomic<bool> m_rosLiveMap;          // 是否订阅 /map 与 /map_updates，收到后代替本地 PNG 地图
     QString m_serverIp;
     std::atomic<int> m_serverPort;
     // 其他通讯
@@ -144,6 +178,11 @@ private:
     std::atomic<bool> m_defaultFixedRelocation; // 是否默认是固定重定位模式
     std::atomic<bool> m_debugMode;
     std::atomic<bool> m_fullScreen;
+    std::atomic<int> m_trafficCapture;     // 入站流量录制：0 关闭，1 完整录制，2 环形录制；重启生效
+    std::atomic<int> m_trafficRingMinutes; // 环形录制保留的分钟数
+    std::atomic<int> m_cloudTrailScans;    // 点云历史轨迹保留的帧数，0 表示关闭
+    std::atomic<int> m_cloudTrailMemoryMb; // 点云历史轨迹的内存上限
+    std::atomic<int> m_relocationMinFit;   // 自由重定位确认所需的最低匹配度（%），0 表示不检查
 
     // mutable 允许在 const 函数中加锁
     mutable QReadWriteLock m_lock;
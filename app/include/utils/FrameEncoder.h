@@ -0,0 +1,131 @@
+#ifndef FRAMEENCODER_H
+#define FRAMEENCODER_H
+
+#include <QString>
+#include <QByteArray>
+#include <QVector>
+
+// 出站帧编码器
+// 帧结构在构建阶段一次性确定：键名、常量值以及 JSON 的括号、逗号被预先拼成连续的文本片段，
+// 每次发送只把当前时间、DataStamps 和各个值槽位写入可复用的缓冲区，不再构建 QJsonObject 树；
+// 缓冲区容量稳定后，编码过程不产生堆分配
+// 不是线程安全的，由所属对象在自己的线程中使用
+class FrameEncoder
+{
+public:
+    // --- 构建模板 ---
+    // 对象与数组需给出成员个数（CBOR 的 map / array 头需要），键按调用顺序输出
+    void beginObject(int size);
+    void endObject();
+    void beginArray(int size);
+    void endArray();
+    void key(const QString &name);
+
+    // 常量值
+    void literal(const QString &value);
+    void literal(bool value);
+    void literal(int value);
+    void literal(double value);
+
+    // 值槽位，返回槽位编号，供 setXxx 使用
+    int intSlot();
+    int boolSlot();
+    int doubleSlot();
+    // 当前本地时间 "yyyy-MM-dd hh:mm:ss.zzz"，每次编码时写入
+    void dateTimeSlot();
+    // DataStamps，由 setStamps 设置
+    void stampsSlot();
+
+    // --- 每次发送 ---
+    void setInt(int slot, int value);
+    void setBool(int slot, bool value);
+    void setDouble(int slot, double value);
+    void setStamps(qint64 stamps);
+
+    // 编码为 JSON 文本 / CBOR 二进制，返回的缓冲区在下一次编码前有效
+    // 调用方可以直接把返回值交给发送队列（隐式共享）；发送完成后缓冲区重新独占，下一次编码仍不分配
+    const QString &encodeJson();
+    const QByteArray &encodeCbor();
+
+    // 最近一次编码的结果，不重新编码；用于日志记录实际发出的帧
+    const QString &lastJson() const;
+    const QByteArray &lastCbor() const;
+
+private:
+    enum class OpKind : quint8
+    {
+        Literal, // 预先拼好的 JSON 文本与 CBOR 字节
+        Int,
+        Bool,
+        Double,
+        DateTime,
+        Stamps
+    };
+
+    struct Op
+    {
+        OpKind kind = OpKind::Literal;
+        int slot = -1;
+        QString json;
+        QByteArray cbor;
+    };
+
+    struct Slot
+    {
+        OpKind kind = OpKind::Int;
+        int intValue = 0;
+        bool boolValue = false;
+        double doubleValue = 0.0;
+    };
+
+    QVector<Op> m_ops;
+    QVector<Slot> m_slots;
+    qint64 m_stamps = 0;
+
+    // 构建阶段的容器状态：当前层是否还没有成员、上一个输出是否为键
+    QVector<bool> m_first;
+    bool m_afterKey = false;
+
+    QString m_json;
+    QByteArray m_cbor;
+    int m_jsonHint = 256; // 历史最大长度，编码前按此预留容量
+    int m_cborHint = 256;
+
+    void beforeValue();
+    void appendLiteral(const QString &json, const QByteArray &cbor);
+    void appendOp(OpKind kind, int slot);
+    int addSlot(OpKind kind);
+};
+
+// 控制器通讯协议的帧模板，外壳为
+// {"Body": ..., "DataStamps": n, "DateTime": "...", "ErrorMessage": "", "Event": event, "IsSucceed": true}
+// 键名顺序与 QJsonDocument 的输出一致
+namespace ControllerFrames
+{
+    // Body 为空字符串的请求帧（REQUEST_AGV_STATE、REQUEST_AGV_TASK）
+    FrameEncoder request(const QString &event);
+
+    // TOUCH_STATE 的 Body 字段，槽位编号与枚举值一致（按键名排序）
+    enum TouchStateSlot
+    {
+        TouchChargeCmd,   // charge_cmd
+        TouchIniW,        // ini_w
+        TouchIniX,        // ini_x
+        TouchIniY,        // ini_y
+        TouchManualAct,   // manual_act
+        TouchManualDir,   // manual_dir
+        TouchManualVth,   // manual_vth
+        TouchManualVx,    // manual_vx
+        TouchManualVy,    // manual_vy
+        TouchMusic,       // music
+        TouchPageControl, // page_control
+        TouchTaskCancel,  // task_cancel
+        TouchTaskPause,   // task_pause
+        TouchTaskResume,  // task_resume
+        TouchTaskStart,   // task_start
+        TouchSlotCount
+    };
+    FrameEncoder touchState();
+}
+
+#endif // FRAMEENCODER_H
@@ -0,0 +1,43 @@
+#ifndef FRAMELATENCYMETER_H
+#define FRAMELATENCYMETER_H
+
+#include <QVector>
+#include "LatencyPercentiles.h"
+
+// 端到端时延统计结果：窗口内的分位数，以及累计的有效 / 丢弃样本数
+struct FrameLatencyStats : LatencyPercentiles
+{
+    quint64 recorded = 0;  // 累计有效样本数
+    quint64 discarded = 0; // 本轮被判定为时钟不一致而丢弃的样本数
+};
+
+// 端到端时延统计：数据源在帧内携带的发出时刻（墙钟 µs）到界面绘制完成
+// 目前只有本地模拟器在点云中附带 sim_stamp_us，真实 rosbridge 不携带，此时不产生样本
+// 只在主线程使用，不加锁
+class FrameLatencyMeter
+{
+public:
+    static constexpr int WINDOW_SIZE = 512;               // 参与分位数计算的最近样本数
+    static constexpr qint64 MAX_VALID_US = 60LL * 1000000; // 为负或超过 60 s 视为两端时钟不一致（跨主机、回放录制数据），丢弃
+
+    // 与模拟器相同的墙钟（µs）
+    static qint64 nowUs();
+
+    // 登记一帧；stampUs < 0 表示该帧未携带时间戳
+    void record(qint64 stampUs);
+
+    // 当前窗口内的统计结果
+    FrameLatencyStats stats() const;
+
+    // 清空窗口，开始新一轮统计
+    void reset();
+
+private:
+    QVector<qint64> m_latencyUs = QVector<qint64>(WINDOW_SIZE, 0); // 环形写入
+    int m_next = 0;
+    int m_count = 0;
+    quint64 m_total = 0;
+    quint64 m_discarded = 0;
+};
+
+#endif // FRAMELATENCYMETER_H
@@ -0,0 +1,20 @@
+#ifndef LATENCYPERCENTILES_H
+#define LATENCYPERCENTILES_H
+
+#include <QVector>
+
+// 一组时延样本的分位数（单位 ms）
+struct LatencyPercentiles
+{
+    int samples = 0; // 样本数，0 表示暂无数据
+    double p50Ms = 0.0;
+    double p95Ms = 0.0;
+    double p99Ms = 0.0;
+    double maxMs = 0.0;
+};
+
+// 对样本排序后按最近秩法取分位数；unitsPerMs 为样本单位换算到 ms 的倍数（ns 为 1e6，µs 为 1e3）
+// 样本按值传入并在原地排序，调用方通常已在锁内拷贝出一份
+LatencyPercentiles computeLatencyPercentiles(QVector<qint64> samples, double unitsPerMs);
+
+#endif // LATENCYPERCENTILES_H
@@ -0,0 +1,74 @@
+#ifndef LATESTMAILBOX_H
+#define LATESTMAILBOX_H
+
+#include <QMutex>
+#include <atomic>
+#include <utility>
+
+// 只保留最新一帧的单槽邮箱
+// 生产者（网络线程）每帧调用 post，消费者（主线程）调用 take；
+// 消费者来不及处理时，新帧直接覆盖未取走的旧帧，而不是排队重放过期数据
+// 计数：posted 为投递总数，conflated 为被新帧覆盖的帧数，dropped 为被 discard 丢弃、未送达的帧数
+template <typename T>
+class LatestMailbox
+{
+public:
+    // 投递一帧；返回 true 表示邮箱此前为空，调用方需要通知消费者，
+    // 返回 false 表示覆盖了尚未取走的旧帧（已有通知在途，无需再次通知）
+    bool post(T value)
+    {
+        m_posted.fetch_add(1, std::memory_order_relaxed);
+
+        QMutexLocker locker(&m_mutex);
+        m_value = std::move(value);
+        if (m_full)
+        {
+            m_conflated.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        m_full = true;
+        return true;
+    }
+
+    // 丢弃尚未取走的帧（消费者不再需要时调用）；返回 true 表示确有一帧被丢弃
+    bool discard()
+    {
+        QMutexLocker locker(&m_mutex);
+        if (!m_full)
+            return false;
+        m_value = T();
+        m_full = false;
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    // 取走最新一帧；邮箱为空时返回 false
+    bool take(T &out)
+    {
+        QMutexLocker locker(&m_mutex);
+        if (!m_full)
+            return false;
+        out = std::move(m_value);
+        m_value = T();
+        m_full = false;
+        return true;
+    }
+
+    // 累计投递的帧数
+    quint64 posted() const { return m_posted.load(std::memory_order_relaxed); }
+    // 累计被新帧覆盖、未送达消费者的帧数
+    quint64 conflated() const { return m_conflated.load(std::memory_order_relaxed); }
+    // 累计被 discard 丢弃、未送达消费者的帧数
+    quint64 dropped() const { return m_dropped.load(std::memory_order_relaxed); }
+
+private:
+    QMutex m_mutex;
+    T m_value{};
+    bool m_full = false;
+
+    std::atomic<quint64> m_posted{0};
+    std::atomic<quint64> m_conflated{0};
+    std::atomic<quint64> m_dropped{0};
+};
+
+#endif // LATESTMAILBOX_H
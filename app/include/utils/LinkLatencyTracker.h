@@ -0,0 +1,82 @@
+#ifndef LINKLATENCYTRACKER_H
+#define LINKLATENCYTRACKER_H
+
+#include <QMetaType>
+#include <QMutex>
+#include <QElapsedTimer>
+#include <QVector>
+
+// 通讯链路时延统计结果（单位 ms）
+struct LinkLatencyStats
+{
+    int samples = 0;         // 参与分位数计算的样本数，0 表示暂无数据
+    double p50Ms = 0.0;
+    double p95Ms = 0.0;
+    double p99Ms = 0.0;
+    double maxMs = 0.0;
+    quint64 sent = 0;        // 已登记的请求数（一个数据戳计一次）
+    quint64 received = 0;    // 全部应答都已收到的请求数
+    quint64 lost = 0;        // 超时仍有应答未到的请求数
+    quint64 outOfOrder = 0;  // 比已收到的应答更早发出、却更晚到达的应答数
+};
+
+Q_DECLARE_METATYPE(LinkLatencyStats)
+
+// 基于 DataStamps 的往返时延统计
+// 发送请求时按数据戳登记发送时间，收到回显相同数据戳的应答时计算往返时间
+// 一个数据戳可以对应多路应答（如同一轮询周期的 AGV_STATE 与 AGV_TASK），各路以位掩码区分，每路各计一个样本
+// markSent 在主线程调用，markReceived 在通讯子线程调用，内部以互斥锁保护
+class LinkLatencyTracker
+{
+public:
+    static constexpr int RING_SIZE = 256;        // 在途请求环形表大小（按数据戳取模索引）
+    static constexpr int WINDOW_SIZE = 512;      // 参与分位数计算的最近样本数
+    static constexpr qint64 LOSS_TIMEOUT_MS = 1000; // 超过该时间未应答视为丢失
+
+    LinkLatencyTracker();
+
+    // 清空全部统计（重新连接、切换订阅模式时调用）
+    void reset();
+
+    // 登记一次请求的发送，expected 为需要等待的应答位掩码
+    void markSent(qint64 stamp, quint32 expected = 1);
+    // 登记一路应答，数据戳不在表中（如订阅推送、已判定丢失）或该路已收到的应答被忽略
+    void markReceived(qint64 stamp, quint32 response = 1);
+
+    // 计算当前统计结果，同时把超时未应答的请求计为丢失
+    LinkLatencyStats stats();
+
+private:
+    enum class SlotState : quint8
+    {
+        Empty,
+        Pending,
+        Done
+    };
+
+    struct Slot
+    {
+        qint64 stamp = -1;
+        qint64 sentNs = 0;
+        quint32 pending = 0; // 尚未收到的应答位
+        SlotState state = SlotState::Empty;
+    };
+
+    void expireLocked(qint64 nowNs);
+
+    QMutex m_mutex;
+    QElapsedTimer m_clock;
+
+    QVector<Slot> m_ring;
+    QVector<qint64> m_rttNs; // 最近 WINDOW_SIZE 个往返时间，环形写入
+    int m_rttNext = 0;
+    int m_rttCount = 0;
+
+    qint64 m_maxReceivedStamp = -1;
+    quint64 m_sent = 0;
+    quint64 m_received = 0;
+    quint64 m_lost = 0;
+    quint64 m_outOfOrder = 0;
+};
+
+#endif // LINKLATENCYTRACKER_H
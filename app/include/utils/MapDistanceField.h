@@ -0,0 +1,54 @@
+#ifndef MAPDISTANCEFIELD_H
+#define MAPDISTANCEFIELD_H
+
+#include <QImage>
+#include <QPointF>
+#include <memory>
+#include <vector>
+
+// 地图的距离变换：每个格子到最近障碍物的欧氏距离
+// 由 build 在工作线程中一次算好，之后只读，可在线程之间共享
+// 用于重定位时评估扫描点与地图的吻合程度
+class MapDistanceField
+{
+public:
+    static constexpr int OCCUPIED_GRAY = 100;    // 灰度不超过该值的像素视为障碍物（map_server 的 PNG 占据为 0，未知为 205）
+    static constexpr double FIT_TOLERANCE_M = 0.2; // 吻合度的截断距离，超出即视为不吻合
+
+    // 吻合度评估结果
+    struct Fit
+    {
+        double score = 0.0;    // 0..1，各点 max(0, 1 - d / FIT_TOLERANCE_M) 的平均，越大越吻合
+        double meanDist = 0.0; // 截断距离以内各点的平均距离（m）
+        int points = 0;        // 参与评估的点数
+    };
+
+    // 由地图图像计算距离变换；res 与 ox、oy 与 MapLayer::updateMap 的参数一致（绘制坐标系，y 向下）
+    // 图像为空时返回 nullptr
+    static std::shared_ptr<const MapDistanceField> build(const QImage &map, double res, double ox, double oy);
+
+    // 世界坐标（m，y 向上）处到最近障碍物的距离（m）；地图范围外返回负值
+    double distanceAt(double wx, double wy) const;
+
+    // 局部坐标点（xy 交错，y 向上）按位姿 (pos, rad) 变换到世界坐标后评估吻合度
+    // 地图范围外的点按不吻合计入
+    Fit fit(const float *localXy, int n, const QPointF &pos, double rad) const;
+
+    int width() const { return m_width; }
+    int height() const { return m_height; }
+
+private:
+    // 距离以 1/8 格为单位存放，超过 255 的截断；吻合度只关心截断距离以内的部分
+    static constexpr int UNITS_PER_CELL = 8;
+
+    int m_width = 0;
+    int m_height = 0;
+    double m_res = 0.05;
+    double m_ox = 0.0;
+    double m_oy = 0.0;
+    std::vector<quint8> m_dist; // 行 0 为图像最上一行
+};
+
+using MapDistanceFieldPtr = std::shared_ptr<const MapDistanceField>;
+
+#endif // MAPDISTANCEFIELD_H
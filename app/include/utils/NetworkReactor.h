@@ -0,0 +1,62 @@
+#ifndef NETWORKREACTOR_H
+#define NETWORKREACTOR_H
+
+#include <QObject>
+#include <QThread>
+#include <QVector>
+#include <QHash>
+#include "LogManager.h"
+
+// 网络 I/O 线程池
+// WebSocket 客户端（装车、rosbridge）托管在少量共享的事件循环线程上，
+// 每个连接仍是独立的对象，只是不再各自独占一个线程
+// 线程数由 ConfigManager::networkThreads() 决定，0 表示沿用每个连接独占一个线程的布局
+// 数据通讯链路以 Placement::Dedicated 托管，始终独占一个线程，不会被 rosbridge 的地图、点云解码阻塞
+// attach / detach 只在主线程调用
+class NetworkReactor : public QObject
+{
+    Q_OBJECT
+public:
+    static NetworkReactor *instance();
+
+    // 托管方式
+    enum class Placement
+    {
+        Shared,   // 轮询分配到共享线程（共享线程数为 0 时独占）
+        Dedicated // 始终独占一个线程
+    };
+
+    // 托管网络对象：移动到某个 I/O 线程；对象不能有 parent
+    // 返回后对象已在目标线程中，需要通过 QueuedConnection 调用其方法
+    void attach(QObject *worker, Placement placement = Placement::Shared);
+
+    // 在对象所在的 I/O 线程中销毁对象并等待完成
+    void detach(QObject *worker);
+
+    // 当前运行中的 I/O 线程数
+    int threadCount() const;
+
+private slots:
+    // 程序退出前销毁所有托管对象并停止线程
+    void shutdown();
+
+private:
+    explicit NetworkReactor(QObject *parent = nullptr);
+    ~NetworkReactor();
+
+    QThread *createThread(const QString &name);
+    QThread *pickThread(Placement placement);
+    void destroyWorker(QObject *worker, QThread *thread);
+
+    // 日志管理器
+    LogManager *logger = &LogManager::instance();
+
+    int m_sharedCount;                    // 共享线程数，0 表示每个连接独占一个线程
+    QVector<QThread *> m_threads;         // 共享线程
+    int m_nextThread = 0;                 // 轮询分配的下一个线程
+    QHash<QObject *, QThread *> m_workers; // 托管对象 -> 所在线程
+    int m_dedicatedSeq = 0;               // 独占线程的命名序号
+    bool m_shutdown = false;
+};
+
+#endif // NETWORKREACTOR_H
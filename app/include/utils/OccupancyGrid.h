@@ -0,0 +1,44 @@
+#ifndef OCCUPANCYGRID_H
+#define OCCUPANCYGRID_H
+
+#include <QImage>
+#include <QMetaType>
+#include <QRect>
+
+// 一帧栅格地图的解码结果：/map（nav_msgs/OccupancyGrid）为整幅，
+// /map_updates（map_msgs/OccupancyGridUpdate）为局部更新
+// image 已转换为灰度并上下翻转（行 0 为栅格最上一行），可直接交给 MapLayer
+struct OccupancyGridPatch
+{
+    bool full = true;        // true 为整幅地图，false 为局部更新
+    int x = 0;               // 局部更新在整幅栅格中的位置（栅格坐标，行 0 在 origin 一侧）
+    int y = 0;
+    double resolution = 0.0; // m/格，仅整幅有效
+    double originX = 0.0;    // 栅格 (0, 0) 角点的世界坐标（m），仅整幅有效
+    double originY = 0.0;
+    QImage image;            // Format_Grayscale8
+
+    // 局部更新在整幅图像中的区域（图像坐标，行 0 在上）；gridHeight 为整幅栅格的行数
+    QRect imageRect(int gridHeight) const
+    {
+        return QRect(x, gridHeight - y - image.height(), image.width(), image.height());
+    }
+};
+Q_DECLARE_METATYPE(OccupancyGridPatch)
+
+// 占据栅格到灰度图像的转换
+// 占据值 0..100 线性映射为 254（空闲）..0（占据），-1 及其他值为未知 205，与 map_server 保存的 PNG 一致
+class OccupancyGrid
+{
+public:
+    static constexpr uchar GRAY_UNKNOWN = 205;
+
+    // int8 占据值（按 uint8 取下标）-> 灰度
+    static const uchar *grayLut();
+
+    // 把 width x height 的占据值（行 0 在 origin 一侧）查表写入灰度图像，图像按需重新分配
+    // cells 不足 width * height 或尺寸非法时返回 false
+    static bool toGray(const qint8 *cells, qsizetype count, int width, int height, QImage &out);
+};
+
+#endif // OCCUPANCYGRID_H
@@ -0,0 +1,70 @@
+#ifndef OUTBOUNDQUEUE_H
+#define OUTBOUNDQUEUE_H
+
+#include <QByteArray>
+#include <QMutex>
+#include <QString>
+#include <QVector>
+
+// 双通道发送队列：控制帧（如 TOUCH_STATE）总是先于普通请求取出
+// 入队与发送各持有一组 QVector，drain 时在锁内交换，发送完成后 clear（保留容量）；
+// 容量稳定后入队与发送都不产生堆分配，帧数据以隐式共享的方式传递，发送完成后即释放引用，
+// FrameEncoder 的缓冲区因此重新独占，下一次编码也不分配
+// push 可在任意线程调用，drain 只能在同一个发送线程中调用
+class OutboundQueue
+{
+public:
+    // 待发送的一帧，文本帧或二进制帧
+    struct Frame
+    {
+        QString text;
+        QByteArray binary;
+        bool isBinary = false;
+    };
+
+    // 入队；返回 true 表示这是本批次的第一帧，调用方需要安排一次 drain
+    bool push(const Frame &frame, bool control)
+    {
+        QMutexLocker locker(&m_mutex);
+        if (control)
+            m_control.append(frame);
+        else
+            m_normal.append(frame);
+
+        const bool first = !m_drainScheduled;
+        m_drainScheduled = true;
+        return first;
+    }
+
+    // 取出当前全部帧并逐一交给 send，先控制帧后普通帧
+    template <typename Send>
+    void drain(Send send)
+    {
+        {
+            QMutexLocker locker(&m_mutex);
+            m_controlSending.swap(m_control);
+            m_normalSending.swap(m_normal);
+            m_drainScheduled = false;
+        }
+
+        for (const Frame &frame : qAsConst(m_controlSending))
+            send(frame);
+        for (const Frame &frame : qAsConst(m_normalSending))
+            send(frame);
+
+        m_controlSending.clear();
+        m_normalSending.clear();
+    }
+
+private:
+    QMutex m_mutex;
+    QVector<Frame> m_control; // 控制帧，由 m_mutex 保护
+    QVector<Frame> m_normal;  // 普通请求，由 m_mutex 保护
+    bool m_drainScheduled = false; // 是否已安排过 drain，避免重复投递
+
+    // 正在发送的一批，只在 drain 所在线程访问
+    QVector<Frame> m_controlSending;
+    QVector<Frame> m_normalSending;
+};
+
+#endif // OUTBOUNDQUEUE_H
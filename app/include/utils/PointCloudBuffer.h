@@ -0,0 +1,70 @@
+#ifndef POINTCLOUDBUFFER_H
+#define POINTCLOUDBUFFER_H
+
+#include <QMetaType>
+#include <QMutex>
+#include <QPointF>
+#include <QVector>
+#include <memory>
+#include <vector>
+
+// 一帧点云：世界坐标（m）按 x0 y0 x1 y1 ... 紧凑存放的 float32
+// 由解码线程一次性填充后以只读共享指针发布，经 AgvData 邮箱到达图层，全程不复制
+class PointCloudBuffer
+{
+public:
+    int size() const { return m_size; }
+    bool isEmpty() const { return m_size == 0; }
+    int capacity() const { return static_cast<int>(m_xy.size() / 2); }
+
+    const float *xy() const { return m_xy.data(); }
+    float *xy() { return m_xy.data(); }
+    QPointF point(int i) const { return QPointF(m_xy[2 * i], m_xy[2 * i + 1]); }
+
+    // 设置点数；容量只增不减，复用时不再分配
+    void resize(int points);
+
+    // 解码器直接写入原始数据用：保证至少能容纳 floats 个 float（保留已有内容）并返回起始地址
+    float *rawStorage(int floats);
+    // 把已写入 rawStorage 的 points 组、每组 stride 个 float 的数据（如 x y z）原地压缩为 x y，并设置点数
+    void packFromStride(int points, int stride);
+
+    qint64 stampUs = -1; // 数据源发出时刻（sim_stamp_us），缺失时为 -1
+    quint64 seq = 0;     // 解码端的帧序号，同一帧重新降采样后序号不变；0 表示未编号
+
+private:
+    std::vector<float> m_xy;
+    int m_size = 0;
+};
+
+using PointCloudBufferPtr = std::shared_ptr<const PointCloudBuffer>;
+Q_DECLARE_METATYPE(PointCloudBufferPtr)
+
+// 点云缓冲池
+// 池中的缓冲区在没有任何外部持有者时（解码、邮箱、图层都已释放）被下一帧复用，
+// 控制块随缓冲区一起保留，稳态下每帧不产生堆分配
+class PointCloudPool
+{
+public:
+    static constexpr int MAX_POOLED = 8; // 同时在途的帧通常不超过 3 个（解码中、邮箱、图层）
+
+    static PointCloudPool *instance();
+
+    // 取一个空闲缓冲区并设置点数；池满且全部在用时临时分配一个不入池的缓冲区
+    std::shared_ptr<PointCloudBuffer> acquire(int points);
+
+    // 池中缓冲区数量、复用次数、池满时临时分配的次数
+    int pooled() const;
+    quint64 reused() const;
+    quint64 overflow() const;
+
+private:
+    PointCloudPool() = default;
+
+    mutable QMutex m_mutex;
+    QVector<std::shared_ptr<PointCloudBuffer>> m_buffers;
+    quint64 m_reused = 0;
+    quint64 m_overflow = 0;
+};
+
+#endif // POINTCLOUDBUFFER_H
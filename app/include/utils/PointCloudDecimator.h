@@ -0,0 +1,43 @@
+#ifndef POINTCLOUDDECIMATOR_H
+#define POINTCLOUDDECIMATOR_H
+
+#include <atomic>
+#include <vector>
+#include <QtGlobal>
+#include "PointCloudBuffer.h"
+
+// 按缩放级别的点云体素降采样
+// 缩放比例（像素/米）按 2 的幂分档，每档对应一个边长固定的世界坐标网格，
+// 每个网格只保留落入的第一个点，使绘制的点数只与屏幕上可分辨的格子数有关，与扫描仪密度无关
+// 视图档位为全局原子量：主线程在绘制前写入，网络线程在解码后读取
+// decimate 使用成员中的哈希表作为临时空间，每个实例只在一个线程中使用
+class PointCloudDecimator
+{
+public:
+    static constexpr int NO_DECIMATION = -1; // 尚未有视图设置缩放时不降采样
+    static constexpr double CELL_PX = 4.0;   // 网格在屏幕上的边长上限（像素），与点的直径相当
+
+    // 缩放比例对应的档位：floor(log2(scale))
+    static int bucketForScale(double pixelsPerMeter);
+    // 档位对应的网格边长（m）；档位内任意缩放下网格都不超过 CELL_PX 像素
+    static double cellSize(int bucket);
+
+    // 主线程：记录当前视图缩放；档位发生变化时返回 true
+    static bool setViewScale(double pixelsPerMeter);
+    // 当前视图档位
+    static int viewBucket();
+
+    // 每格保留一个点；结果取自 PointCloudPool，stampUs、seq 与源一致
+    // 档位为 NO_DECIMATION 或没有点被合并时直接返回 src，不复制
+    PointCloudBufferPtr decimate(const PointCloudBufferPtr &src, int bucket);
+
+private:
+    // 开放寻址哈希表，m_stamps 与 m_generation 相同的槽位有效，换帧时无需清空
+    std::vector<quint64> m_keys;
+    std::vector<quint32> m_stamps;
+    quint32 m_generation = 0;
+
+    static std::atomic<int> s_viewBucket;
+};
+
+#endif // POINTCLOUDDECIMATOR_H
@@ -0,0 +1,54 @@
+#ifndef POINTCLOUDRASTER_H
+#define POINTCLOUDRASTER_H
+
+#include <QImage>
+#include <QRect>
+#include <QRgb>
+#include <QTransform>
+#include <vector>
+
+class QPainter;
+
+// 点云的批量栅格化
+// 先把全部点一次性变换到设备像素（SSE2 每次处理 4 个点，其他平台走标量路径），
+// 再把固定大小的实心圆点直接写入 32 位图像的扫描线，代替逐点 drawEllipse
+// 绘制目标本身是无裁剪的 32 位 QImage 时直接写入；否则先写入缓存的透明叠加层，
+// 再以一次 drawImage 绘制被写过的区域（受 painter 裁剪约束）
+// 持有临时缓冲区，每个图层一个实例，只在主线程中使用
+class PointCloudRaster
+{
+public:
+    static constexpr int DOT_RADIUS = 2; // 圆点半径（设备像素），与原 drawEllipse 的 2 像素半径一致
+
+    // 绘制 n 个点（xy 交错存放，y 向上，绘制时取反以适配 Qt 坐标系），使用 painter 当前的变换
+    void draw(QPainter *painter, const float *xy, int n, QRgb color);
+
+    // 分批绘制：begin 与 end 之间的多组点写入同一目标，叠加层只合成一次
+    // 颜色带透明度时与已写入的像素做 source-over 混合，先写的组在下
+    void begin(QPainter *painter);
+    void drawPoints(const float *xy, int n, QRgb color);
+    // 绘制已按 transform() 变换好的设备像素（调用方缓存变换结果时使用）
+    void drawPixels(const qint32 *pxy, int n, QRgb color);
+    void end();
+    // begin 时 painter 的变换
+    const QTransform &transform() const { return m_transform; }
+
+    // 把 n 个点经 t 变换为四舍五入后的设备像素，写入 out[2n]；y 先取反
+    // 无法表示的坐标（NaN、溢出）写为 INT_MIN，在 splat 中被当作越界丢弃
+    static void transformPoints(const float *xy, int n, const QTransform &t, qint32 *out);
+
+    // 在 ARGB32 / ARGB32_Premultiplied / RGB32 图像上绘制圆点，越界部分裁掉
+    // dirty 扩展为被写过的像素范围；返回落在图像内的点数
+    static int splat(QImage &image, const qint32 *pxy, int n, QRgb color, QRect *dirty);
+
+private:
+    std::vector<qint32> m_pixels; // 变换后的设备像素
+    QImage m_overlay;             // 透明叠加层，绘制后只清除被写过的区域
+
+    QPainter *m_painter = nullptr;
+    QImage *m_target = nullptr; // 本批次写入的图像：绘制目标本身或叠加层
+    QTransform m_transform;
+    QRect m_dirty;
+};
+
+#endif // POINTCLOUDRASTER_H
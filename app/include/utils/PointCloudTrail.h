@@ -0,0 +1,63 @@
+#ifndef POINTCLOUDTRAIL_H
+#define POINTCLOUDTRAIL_H
+
+#include <QPointF>
+#include <QRgb>
+#include <QTransform>
+#include <vector>
+#include "PointCloudBuffer.h"
+
+class PointCloudRaster;
+
+// 最近 N 帧点云的环形缓冲，用于绘制随时间淡出的历史轨迹
+// 每帧复制为紧凑的 float32 xy 存放在固定的槽位中（不占用 PointCloudPool），
+// 并记录采集时的 AGV 位姿；槽位的容量在复用时保留，稳态下不分配内存
+// 每个槽位缓存变换后的设备像素，视图变换不变时直接复用，绘制轨迹只增加写像素的开销
+// 只在主线程中使用
+class PointCloudTrail
+{
+public:
+    static constexpr qint64 FADE_MS = 2000;     // 历史帧从出现到完全透明的时长，超时的帧被丢弃
+    static constexpr double POSE_JUMP_M = 1.0;  // 相邻两帧位姿跳变超过该距离时（重定位）清空轨迹
+    static constexpr int MAX_ALPHA = 160;       // 最新一帧历史点的不透明度
+
+    // 帧数上限（0 表示关闭）与内存上限（字节，含坐标与像素缓存）
+    void setLimits(int maxScans, qint64 maxBytes);
+    int maxScans() const { return static_cast<int>(m_slots.size()); }
+
+    // 记录一帧及其采集时的位姿（m、rad）
+    void push(const PointCloudBuffer &cloud, const QPointF &pos, double rad, qint64 nowMs);
+    void clear();
+
+    // 在 raster 的当前批次中由旧到新绘制，不透明度随帧龄线性衰减
+    void draw(PointCloudRaster &raster, qint64 nowMs, QRgb color);
+
+    int size() const { return m_count; }
+    // 所有槽位当前占用的内存（字节）
+    qint64 bytes() const;
+
+private:
+    struct Scan
+    {
+        std::vector<float> xy;
+        int points = 0;
+        QPointF pos;        // 采集时的 AGV 位置（m）
+        double rad = 0.0;   // 采集时的 AGV 朝向（rad）
+        qint64 timeMs = 0;  // 进入轨迹的时刻
+        std::vector<qint32> pixels; // 按 pixelTransform 变换后的设备像素
+        QTransform pixelTransform;
+        bool pixelsValid = false;
+    };
+
+    Scan &slot(int age) { return m_slots[static_cast<size_t>((m_head + age) % m_slots.size())]; }
+    static qint64 slotBytes(const Scan &scan);
+    // 丢弃最旧的一帧；release 为 true 时同时释放其内存
+    void dropOldest(bool release);
+
+    std::vector<Scan> m_slots;
+    int m_head = 0;  // 最旧一帧所在槽位
+    int m_count = 0; // 有效帧数
+    qint64 m_maxBytes = 0;
+};
+
+#endif // POINTCLOUDTRAIL_H
@@ -14,6 +14,10 @@
 #include <QJsonDocument>
 #include <QTimer>
 #include "LogManager.h"
+#include "FrameEncoder.h"
+#include "PointCloudBuffer.h"
+#include "RosBridgeDecoder.h"
+#include "PointCloudDecimator.h"
 
 class RosBridgeClient : public QObject
 {
@@ -26,16 +30,28 @@ public slots:
     // 改为 Slot，因为必须在线程启动后调用
     void connectToRos(const QString &url);
     void closeConnection();
-    void subscribe(const QString &topic, const QString &type);
+    // throttleMs > 0 时附带 throttle_rate 与 queue_length = 1，只接收最新帧
+    void subscribe(const QString &topic, const QString &type, int throttleMs = 0);
     void setInitialPose(const QPointF &pos, double angle);
+    // 回放录制的 rosbridge 帧，与从 socket 收到的帧走同一解析路径
+    void injectBinaryMessage(const QByteArray &message);
+    // 视图缩放档位变化后，按新档位重新降采样最近一帧点云并发出
+    void redecimateCloud();
+    // 是否有界面在显示点云与位姿；不显示时按各话题的空闲策略退订或节流
+    void setViewActive(bool active);
+    // 重新读取空闲策略并按当前状态更新订阅
+    void refreshSubscriptions();
 
 signals:
     void connected();
     void disconnected();
     // 数据信号发送给 UI
-    void pointCloudReceived(QVector<QPointF> points);
+    // 点云取自 PointCloudPool，解码完成后只读共享；stampUs 为帧内 sim_stamp_us（真实 rosbridge 不携带时为 -1）
+    void pointCloudReceived(PointCloudBufferPtr cloud);
     void mapNameReceived(QString mapName);
     void agvStateReceived(QVector<int> agvState);
+    // /map 与 /map_updates，已转换为灰度图像
+    void occupancyGridReceived(OccupancyGridPatch grid);
 
 private slots:
     void onConnected();
@@ -51,11 +67,45 @@ private slots:
 private:
     // 解析函数 (原 Worker 的逻辑)
     void processCborMessage(const QByteArray &rawData);
-    void parsePointCloudCbor(const QCborValue &msg);
-    void parseMapNameCbor(const QCborValue &msg);
-    void parseAgvStateCbor(const QCborValue &msg);
-    
-    QByteArray extractByteArray(const QCborValue &val);
+
+    // 订阅表：onConnected 时按表订阅，界面显示状态变化时只更新需要按需订阅的话题
+    static constexpr int NOT_SENT = -1;
+    enum class Policy
+    {
+        Always,   // 始终全速订阅
+        OnDemand, // 随界面显示状态调整
+        LiveMap   // 只在启用实时栅格地图时订阅
+    };
+    struct TopicSubscription
+    {
+        QString topic;
+        QString type;
+        Policy policy;
+        int sentRate = NOT_SENT;  // 当前已生效的订阅：NOT_SENT 未订阅，0 全速，>0 为 throttle_rate（ms）
+    };
+    QVector<TopicSubscription> m_topics;
+    bool m_viewActive = false; // 监控页面显示前按空闲策略订阅
+    // 按当前显示状态与配置计算期望的订阅（NOT_SENT 表示退订），与已生效的不同时重新订阅
+    void applySubscription(TopicSubscription &sub);
+    // 界面不显示时该话题的订阅：读取 ConfigManager 中的空闲策略
+    int idleRate(const QString &topic) const;
+    void unsubscribe(const QString &topic);
+    RosBridgeDecoder m_decoder;
+    RosBridgeMessage m_message; // 解码结果，跨帧复用
+
+    // 点云按视图缩放档位降采样后发出；保留最近一帧原始点云，档位变化时据此重新降采样
+    PointCloudDecimator m_decimator;
+    PointCloudBufferPtr m_rawCloud;
+    int m_cloudBucket = PointCloudDecimator::NO_DECIMATION;
+    quint64 m_cloudSeq = 0; // 点云帧序号
+
+    // /baseinipose 发布帧模板，只有位置和四元数随调用变化
+    void initPoseFrame();
+    FrameEncoder m_poseFrame;
+    int m_poseX = -1;
+    int m_poseY = -1;
+    int m_poseQz = -1;
+    int m_poseQw = -1;
 
 private:
     // 日志管理器
@@ -0,0 +1,62 @@
+#ifndef ROSBRIDGEDECODER_H
+#define ROSBRIDGEDECODER_H
+
+#include <QByteArray>
+#include <QString>
+#include <QVector>
+#include <memory>
+#include "PointCloudBuffer.h"
+#include "OccupancyGrid.h"
+
+class QCborStreamReader;
+class QCborValue;
+
+// 一帧 rosbridge publish 消息的解码结果，只有 topic 对应的字段有效
+struct RosBridgeMessage
+{
+    enum class Topic
+    {
+        Unknown,
+        LaserPoints, // /laser_points，std_msgs/Float32MultiArray
+        MapName,     // /map_name，std_msgs/String
+        AgvState,    // /agv_state，std_msgs/Int32MultiArray
+        Map,         // /map，nav_msgs/OccupancyGrid
+        MapUpdate    // /map_updates，map_msgs/OccupancyGridUpdate
+    };
+
+    Topic topic = Topic::Unknown;
+    std::shared_ptr<PointCloudBuffer> cloud; // 取自 PointCloudPool
+    QString mapName;
+    QVector<int> agvState;
+    OccupancyGridPatch grid; // Map / MapUpdate
+};
+
+// rosbridge CBOR 帧解码器
+// 不是线程安全的，每个 RosBridgeClient 持有一个，在其 I/O 线程中使用
+class RosBridgeDecoder
+{
+public:
+    // 流式解码（QCborStreamReader）：先读 op 与 topic，按话题表分派，
+    // 点云的 data 字节串直接读入 PointCloudBuffer，不构建 QCborValue 树、不复制中间字节串
+    // 返回 false 表示不是 publish 帧、话题未订阅或帧非法
+    bool decode(const QByteArray &frame, RosBridgeMessage &out);
+
+    // DOM 解码（QCborValue::fromCbor 建树后取值），结果与 decode 一致
+    // 保留作为 RuinapControlBench 的对照基准，也用于 msg 先于 topic 出现的帧
+    bool decodeDom(const QByteArray &frame, RosBridgeMessage &out);
+
+private:
+    bool readLaserPoints(QCborStreamReader &r, RosBridgeMessage &out);
+    bool readMapName(QCborStreamReader &r, RosBridgeMessage &out);
+    bool readAgvState(QCborStreamReader &r, RosBridgeMessage &out);
+    bool readOccupancyGrid(QCborStreamReader &r, RosBridgeMessage &out, bool full);
+    // 读取 int8[] 占据值到 m_gridCells，返回个数，出错时返回 -1
+    qsizetype readGridCells(QCborStreamReader &r);
+
+    static QByteArray extractByteArray(const QCborValue &val);
+
+    // 占据值暂存区，只增不减，跨帧复用；查表转换为灰度后即可覆盖
+    QByteArray m_gridCells;
+};
+
+#endif // ROSBRIDGEDECODER_H
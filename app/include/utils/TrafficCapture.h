@@ -0,0 +1,88 @@
+#ifndef TRAFFICCAPTURE_H
+#define TRAFFICCAPTURE_H
+
+#include <QByteArray>
+#include <QFile>
+#include <QString>
+#include <QStringList>
+
+// 入站流量录制文件格式，所有整数均为小端，文件只追加写入，读取时直接内存映射
+//
+// 文件头 32 字节：
+//   magic "RTRC" | version u16 | 保留 u16 | wallMs i64（本文件开始时的系统时间）
+//   | startNs i64（本文件开始时的单调时间）| 保留 8 字节
+// 记录头 16 字节，其后为 length 字节的负载，补齐到 8 字节边界：
+//   length u32 | channel u8 | kind u8 | 保留 u16 | timeNs i64（单调时间）
+//
+// 单调时间以录制开始为零点，环形录制的各段文件共用同一零点，按文件名顺序拼接即为连续的时间线
+namespace TrafficCapture
+{
+    enum class Channel : quint8
+    {
+        Comm = 0,      // 数据通讯（JSON 文本帧或 CBOR 二进制帧）
+        RosBridge = 1, // rosbridge CBOR（/laser_points、/agv_state、/map_name）
+        Truck = 2      // 装车通讯
+    };
+
+    enum class Kind : quint8
+    {
+        Text = 0,  // UTF-8 文本
+        Binary = 1 // 原始字节
+    };
+
+    constexpr quint16 VERSION = 1;
+    constexpr int FILE_HEADER_SIZE = 32;
+    constexpr int RECORD_HEADER_SIZE = 16;
+    constexpr int RECORD_ALIGN = 8;
+    extern const char MAGIC[4];
+    extern const char FILE_SUFFIX[]; // ".rtrc"
+
+    // 写出文件头 / 记录头（不含负载）
+    QByteArray fileHeader(qint64 wallMs, qint64 startNs);
+    void appendRecordHeader(QByteArray &out, Channel channel, Kind kind, qint64 timeNs, int length);
+    // 负载之后需要补齐的字节数
+    inline int paddingFor(int length) { return (RECORD_ALIGN - length % RECORD_ALIGN) % RECORD_ALIGN; }
+
+    const char *channelName(Channel channel);
+}
+
+// 录制文件的顺序读取器
+// path 为单个录制文件，或环形录制的目录（目录下的各段按文件名顺序拼接）
+class TrafficCaptureReader
+{
+public:
+    struct Record
+    {
+        TrafficCapture::Channel channel = TrafficCapture::Channel::Comm;
+        TrafficCapture::Kind kind = TrafficCapture::Kind::Text;
+        qint64 timeNs = 0;
+        const char *data = nullptr; // 指向映射的文件内容，在下一次 next 前有效
+        int size = 0;
+    };
+
+    ~TrafficCaptureReader();
+
+    bool open(const QString &path, QString &error);
+
+    // 读取下一条记录；全部读完返回 false
+    // 进程崩溃时最后一条记录可能只写了一半，读到这里时视为文件结束
+    bool next(Record &record);
+
+    int fileCount() const { return m_files.size(); }
+    // 读取过程中是否遇到过截断或格式错误的文件
+    bool truncated() const { return m_truncated; }
+
+private:
+    QStringList m_files;
+    int m_fileIndex = -1;
+    QFile m_file;
+    const uchar *m_map = nullptr;
+    qint64 m_size = 0;
+    qint64 m_pos = 0;
+    bool m_truncated = false;
+
+    bool openNextFile();
+    void closeFile();
+};
+
+#endif // TRAFFICCAPTURE_H
@@ -0,0 +1,105 @@
+#ifndef TRAFFICRECORDER_H
+#define TRAFFICRECORDER_H
+
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QMutex>
+#include <QQueue>
+#include <QString>
+#include <QThread>
+#include <QVector>
+#include <QWaitCondition>
+#include <atomic>
+#include "TrafficCapture.h"
+#include "LogManager.h"
+
+// 入站流量录制器
+// 数据通讯、rosbridge、装车三路连接收到的每一帧原样追加到录制文件（格式见 TrafficCapture.h），
+// 用于离线复现现场问题，也作为吞吐基准的负载来源
+// 环形模式下按分钟切分文件，只保留最近 N 分钟，程序崩溃后可取回崩溃前的流量
+// record 可在任意线程调用；未开启录制时只有一次原子读
+// 录制时调用方只把帧放入有界队列，由录制器自己的写线程批量写盘，不会阻塞网络线程；
+// 队列满（磁盘跟不上）时丢弃该帧并计数，停止录制时报告丢弃数量
+class TrafficRecorder
+{
+public:
+    enum class Mode
+    {
+        Off = 0,  // 不录制
+        File = 1, // 完整录制到单个文件
+        Ring = 2  // 环形录制，只保留最近 N 分钟
+    };
+
+    static TrafficRecorder *instance();
+
+    // 开始录制，文件写入 folder 下；程序启动时调用一次
+    void start(Mode mode, const QString &folder, int ringMinutes);
+    void stop();
+
+    bool isRecording() const { return m_recording.load(std::memory_order_relaxed); }
+
+    void record(TrafficCapture::Channel channel, const QString &text)
+    {
+        if (isRecording())
+            write(channel, TrafficCapture::Kind::Text, text.toUtf8());
+    }
+    void record(TrafficCapture::Channel channel, const QByteArray &data)
+    {
+        if (isRecording())
+            write(channel, TrafficCapture::Kind::Binary, data);
+    }
+
+private:
+    TrafficRecorder() = default;
+    ~TrafficRecorder();
+
+    // 日志管理器
+    LogManager *logger = &LogManager::instance();
+
+    static constexpr qint64 SEGMENT_NS = 60LL * 1000 * 1000 * 1000; // 环形模式每段 1 分钟
+    static constexpr int MAX_PENDING = 4096;                         // 待写队列上限（帧）
+    static constexpr int FLUSH_BYTES = 1024 * 1024;                  // 批量写出时缓冲区达到该大小即写一次
+
+    // 等待写盘的一帧，时间戳在入队时记录
+    struct PendingRecord
+    {
+        TrafficCapture::Channel channel;
+        TrafficCapture::Kind kind;
+        qint64 ns;
+        QByteArray payload;
+    };
+
+    std::atomic<bool> m_recording{false};
+    std::atomic<quint64> m_dropped{0}; // 队列满时丢弃的帧数
+
+    QMutex m_queueMutex; // 保护 m_pending 与 m_stopWriter
+    QWaitCondition m_queueNotEmpty;
+    QVector<PendingRecord> m_pending; // 入队一侧，容量预留后不再分配
+    bool m_stopWriter = false;
+
+    QMutex m_mutex; // 保护 start/stop；写线程运行期间以下成员只由写线程访问
+    QThread *m_writer = nullptr;
+    QVector<PendingRecord> m_writing; // 写线程正在写出的一批
+    Mode m_mode = Mode::Off;
+    QString m_folder;
+    int m_ringSegments = 0;      // 环形模式保留的段数
+    int m_segmentIndex = 0;      // 下一段的序号
+    QQueue<QString> m_segments;  // 环形模式下已写出的段，最旧的在前
+    qint64 m_segmentStartNs = 0; // 当前段开始的单调时间
+    QElapsedTimer m_clock;       // 录制开始为零点
+    QFile m_file;
+    QByteArray m_buffer;         // 一批记录头 + 负载，一次 write 写出
+    quint64 m_records = 0;
+    quint64 m_bytes = 0;
+
+    void write(TrafficCapture::Channel channel, TrafficCapture::Kind kind, const QByteArray &payload);
+    void writerLoop();
+    bool writeBatch();
+    bool flushBuffer();
+    void stopWriter();
+    bool openFile(const QString &path, qint64 startNs);
+    bool rotateSegment(qint64 nowNs);
+};
+
+#endif // TRAFFICRECORDER_H
@@ -0,0 +1,53 @@
+#ifndef TRAFFICREPLAY_H
+#define TRAFFICREPLAY_H
+
+#include <QThread>
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QString>
+#include <atomic>
+#include "LogManager.h"
+
+// 录制流量的回放源
+// 启动参数 --replay 指定录制文件或环形录制目录时，程序不再连接 socket，
+// 由本线程按录制时的时间间隔（可按倍速或最快速度）把各路入站帧交给原来的处理函数：
+//   数据通讯 -> AgvData::parseMsg / parseCborMsg（DirectConnection，在回放线程中解析，与 I/O 线程一致）
+//   rosbridge -> RosBridgeClient::injectBinaryMessage（BlockingQueuedConnection，处理完再读下一帧）
+//   装车 -> TruckWsClient::injectTextMessage
+// 帧的先后顺序与录制时完全一致
+class TrafficReplay : public QThread
+{
+    Q_OBJECT
+public:
+    // speed 为回放倍速，<= 0 表示不等待、以最快速度回放
+    TrafficReplay(const QString &path, double speed, QObject *parent = nullptr);
+    ~TrafficReplay();
+
+    // 当前进程的回放源；未处于回放模式时为 nullptr
+    static TrafficReplay *active();
+
+    // 停止回放
+    void stop();
+
+signals:
+    void commTextMessage(const QString &msg);
+    void commBinaryMessage(const QByteArray &data);
+    void rosBinaryMessage(const QByteArray &data);
+    void truckTextMessage(const QString &msg);
+
+protected:
+    void run() override;
+
+private:
+    // 日志管理器
+    LogManager *logger = &LogManager::instance();
+
+    QString m_path;
+    double m_speed;
+    std::atomic<bool> m_stop{false};
+
+    // 等待到回放时间线上的 dueNs；提前 1 ms 以内改为让出 CPU 自旋，保证间隔精度
+    void waitUntil(qint64 dueNs, const QElapsedTimer &clock);
+};
+
+#endif // TRAFFICREPLAY_H
@@ -9,6 +9,8 @@
 #include "WebsocketClient.h" // 引用之前的底层客户端
 #include "utils/ConfigManager.h"
 #include "AgvData.h"
+#include "NetworkReactor.h"
+#include "FrameEncoder.h"
 
 class TruckWsClient : public QObject
 {
@@ -26,6 +28,8 @@ public:
     // 发送状态请求 (封装具体的 JSON 协议)
     void sendRequest();
     void requestTruckSize();
+    // 回放录制的装车消息，与从 socket 收到的消息走同一解析路径
+    void injectTextMessage(const QString &msg);
 
 signals:
     // --- 向外（UI）暴露的信号 ---
@@ -45,8 +49,7 @@ private slots:
     void onInternalTextReceived(const QString &msg);
 
 private:
-    WebsocketClient *m_client;
-    QThread *m_thread;
+    WebsocketClient *m_client; // 托管在 NetworkReactor 的 I/O 线程中
 
     // 日志管理器
     LogManager *logger = &LogManager::instance();
@@ -56,6 +59,7 @@ private:
     uint64_t dataStamps;             // 数据戳
 
     // QJsonObject requestState; // 轮询 AGV_STATE
+    FrameEncoder truckSizeReq; // REQUEST_TRUCK_SIZE
 
     void initalReqJson(); // 初始化请求 json
 
@@ -6,6 +6,7 @@
 #include <QTimer>
 #include <QThread>
 #include "LogManager.h"
+#include "OutboundQueue.h"
 
 class WebsocketClient : public QObject
 {
@@ -14,6 +15,17 @@ public:
     explicit WebsocketClient(QObject *parent = nullptr);
     ~WebsocketClient();
 
+    // 发送优先级：控制帧（如 TOUCH_STATE）总是先于普通请求发出
+    enum class SendPriority
+    {
+        Control,
+        Normal
+    };
+
+    // 线程安全的发送入口，可在任意线程调用；实际发送在 socket 所在线程完成
+    void enqueueTextMessage(const QString &message, SendPriority priority = SendPriority::Normal);
+    void enqueueBinaryMessage(const QByteArray &data, SendPriority priority = SendPriority::Normal);
+
 public slots:
     // 连接到指定 URL
     void connectToServer(const QString &url);
@@ -48,6 +60,9 @@ private slots:
     // 定时重连槽函数
     void doReconnect();
 
+    // 在 socket 所在线程中清空发送队列，先控制帧后普通帧
+    void drainSendQueue();
+
 private:
     // 日志管理器
     LogManager *logger = &LogManager::instance();
@@ -56,6 +71,12 @@ private:
     QTimer *m_reconnectTimer;   // 重连定时器
     QString m_url;              // 保存连接地址
     bool m_needReconnect;       // 重连标志位
+
+    void enqueueFrame(const OutboundQueue::Frame &frame, SendPriority priority);
+    void sendFrame(const OutboundQueue::Frame &frame);
+
+    // 双通道发送队列；每批次投递一次 drainSendQueue（一次事件分配），入队本身不分配
+    OutboundQueue m_sendQueue;
 };
 
 #endif // WEBSOCKETCLIENT_H
\ No newline at end of file
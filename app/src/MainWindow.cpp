@@ -1,6 +1,7 @@
 #include "MainWindow.h"
 #include "utils/ConfigManager.h"
 #include "AgvData.h"
+#include "TrafficReplay.h"
 
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent)
@@ -16,9 +17,18 @@ MainWindow::MainWindow(QWidget *parent)
     setupConnections();
     applyWindowState();
 
-    // 启动通信服务
-    m_commClient->start();
-    m_truckLoadingClient->start();
+    // 启动通信服务；回放模式下不连接 socket，由录制文件代替
+    if (TrafficReplay *replay = TrafficReplay::active())
+    {
+        connect(replay, &TrafficReplay::commTextMessage, AgvData::instance(), &AgvData::parseMsg, Qt::DirectConnection);
+        connect(replay, &TrafficReplay::commBinaryMessage, AgvData::instance(), &AgvData::parseCborMsg, Qt::DirectConnection);
+        connect(replay, &TrafficReplay::truckTextMessage, m_truckLoadingClient, &TruckWsClient::injectTextMessage);
+    }
+    else
+    {
+        m_commClient->start();
+        m_truckLoadingClient->start();
+    }
 }
 
 MainWindow::~MainWindow()
@@ -60,13 +70,12 @@ void MainWindow::setupConnections()
     connect(ConfigManager::instance(), &ConfigManager::configChanged,
             this, &MainWindow::applyWindowState);
 
-    // 解析 websocket 消息
-    connect(m_commClient, &CommunicationWsClient::textReceived,
-            AgvData::instance(), &AgvData::parseMsg);
-
     // 处理 mainContent 中的信号
     connect(m_mainContent, &MainContentWidget::requestTruckSize, m_truckLoadingClient, &TruckWsClient::requestTruckSize);
     connect(m_truckLoadingClient, &TruckWsClient::getTruckSize, m_mainContent, &MainContentWidget::getTruckSize);
+
+    // 数据通讯往返时延显示在顶部状态栏
+    connect(m_commClient, &CommunicationWsClient::linkLatencyUpdated, m_topHeader, &TopHeaderWidget::setLinkLatency);
 }
 
 // 全屏或者取消全屏
@@ -3,6 +3,20 @@
 #include <QLabel>
 #include "utils/AgvData.h"
 
+// 底部信息栏关注的字段
+static constexpr quint64 WATCHED_FIELDS =
+    agvFieldBit(AgvField::taskStartId) | agvFieldBit(AgvField::taskStartX) | agvFieldBit(AgvField::taskStartY) |
+    agvFieldBit(AgvField::taskEndId) | agvFieldBit(AgvField::taskEndX) | agvFieldBit(AgvField::taskEndY) |
+    agvFieldBit(AgvField::pathStartId) | agvFieldBit(AgvField::pathStartX) | agvFieldBit(AgvField::pathStartY) |
+    agvFieldBit(AgvField::pathEndId) | agvFieldBit(AgvField::pathEndX) | agvFieldBit(AgvField::pathEndY) |
+    agvFieldBit(AgvField::pointId) | agvFieldBit(AgvField::mapId) | agvFieldBit(AgvField::goodsState) |
+    agvFieldBit(AgvField::runTime) | agvFieldBit(AgvField::runLength) |
+    agvFieldBit(AgvField::vX) | agvFieldBit(AgvField::vY) | agvFieldBit(AgvField::vAngle) |
+    agvFieldBit(AgvField::moveDir) | agvFieldBit(AgvField::taskAct) | agvFieldBit(AgvField::estopState) |
+    agvFieldBit(AgvField::taskId) | agvFieldBit(AgvField::slamX) | agvFieldBit(AgvField::slamY) |
+    agvFieldBit(AgvField::slamAngle) | agvFieldBit(AgvField::slamCov) |
+    agvFieldBit(AgvField::taskErr) | agvFieldBit(AgvField::taskDescription) | agvFieldBit(AgvField::agvErr);
+
 // 定义一个简单的结构体用于配置
 struct ItemConfig
 {
@@ -25,19 +39,14 @@ BottomInfoBar::BottomInfoBar(QWidget *parent) : QWidget(parent)
     )");
     initLayout();
 
-    // 初始化定时器
-    m_updateTimer = new QTimer(this);
-    m_updateTimer->setInterval(UPDATE_INTERVAL_MS);
-    connect(m_updateTimer, &QTimer::timeout, this, &BottomInfoBar::updateUi);
-    m_updateTimer->start();
+    // 订阅 AgvData 的字段变化通知，仅在关注的字段发生变化时刷新
+    connect(AgvData::instance(), &AgvData::fieldsChanged, this, &BottomInfoBar::onFieldsChanged);
+    // 首次刷新放到事件循环中执行，确保外部的信号连接已经建立
+    QTimer::singleShot(0, this, &BottomInfoBar::updateUi);
 }
 
 BottomInfoBar::~BottomInfoBar()
 {
-    if (m_updateTimer->isActive())
-    {
-        m_updateTimer->stop();
-    }
 }
 
 void BottomInfoBar::initLayout()
@@ -202,47 +211,47 @@ void BottomInfoBar::updateAllValues(const QMap<QString, QString> &data)
 
 void BottomInfoBar::updateUi()
 {
-    // 获取 AgvData 实例
-    AgvData *agvData = AgvData::instance();
+    // 获取当前 AGV 状态快照，本次刷新的所有字段均来自同一帧
+    const AgvSnapshotPtr snap = AgvData::instance()->snapshot();
     QMap<QString, QString> updateData;
-    updateData.insert("任务起点", QString::number(agvData->taskStartId().value));
-    updateData.insert("任务起X", QString::number(agvData->taskStartX().value));
-    updateData.insert("任务起Y", QString::number(agvData->taskStartY().value));
-    updateData.insert("任务终点", QString::number(agvData->taskEndId().value));
-    updateData.insert("任务终X", QString::number(agvData->taskEndX().value));
-    updateData.insert("任务终Y", QString::number(agvData->taskEndY().value));
-    updateData.insert("路径起点", QString::number(agvData->pathStartId().value));
-    updateData.insert("路径起X", QString::number(agvData->pathStartX().value));
-    updateData.insert("路径起Y", QString::number(agvData->pathStartY().value));
-    updateData.insert("路径终点", QString::number(agvData->pathEndId().value));
-    updateData.insert("路径终X", QString::number(agvData->pathEndX().value));
-    updateData.insert("路径终Y", QString::number(agvData->pathEndY().value));
-    updateData.insert("当前点位", QString::number(agvData->pointId().value));
-    updateData.insert("地图编号", QString::number(agvData->mapId().value));
-    updateData.insert("载货状态", handleGoodsState(agvData->goodsState().value));
-    updateData.insert("时长T", QString::number(agvData->runTime().value));
-    updateData.insert("里程O", QString::number(agvData->runLength().value));
-    updateData.insert("速度X", QString::number(agvData->vX().value));
-    updateData.insert("速度Y", QString::number(agvData->vY().value));
-    updateData.insert("速度W", QString::number(agvData->vAngle().value / 100.0, 'f', 2));
-    updateData.insert("方向D", handleMoveDir(agvData->moveDir().value));
-    updateData.insert("任务动作", QString::number(agvData->taskAct().value));
-    updateData.insert("急停状态", QString::number(agvData->eStopState().value));
-    updateData.insert("任务编号", agvData->taskId().value);
-    updateData.insert("坐标X", QString::number(agvData->slamX().value));
-    updateData.insert("坐标Y", QString::number(agvData->slamY().value));
-    updateData.insert("角度A", QString::number(agvData->slamAngle().value / 100.0, 'f', 2));
-    updateData.insert("协方差", QString::number(agvData->slamCov().value / 1000.0, 'f', 3));
-    updateData.insert("任务错误", agvData->taskErr().value);
-    updateData.insert("任务消息", agvData->taskDescription().value);
-    updateData.insert("车体错误", agvData->agvErr().value);
+    updateData.insert("任务起点", QString::number(snap->taskStartId.value));
+    updateData.insert("任务起X", QString::number(snap->taskStartX.value));
+    updateData.insert("任务起Y", QString::number(snap->taskStartY.value));
+    updateData.insert("任务终点", QString::number(snap->taskEndId.value));
+    updateData.insert("任务终X", QString::number(snap->taskEndX.value));
+    updateData.insert("任务终Y", QString::number(snap->taskEndY.value));
+    updateData.insert("路径起点", QString::number(snap->pathStartId.value));
+    updateData.insert("路径起X", QString::number(snap->pathStartX.value));
+    updateData.insert("路径起Y", QString::number(snap->pathStartY.value));
+    updateData.insert("路径终点", QString::number(snap->pathEndId.value));
+    updateData.insert("路径终X", QString::number(snap->pathEndX.value));
+    updateData.insert("路径终Y", QString::number(snap->pathEndY.value));
+    updateData.insert("当前点位", QString::number(snap->pointId.value));
+    updateData.insert("地图编号", QString::number(snap->mapId.value));
+    updateData.insert("载货状态", handleGoodsState(snap->goodsState.value));
+    updateData.insert("时长T", QString::number(snap->runTime.value));
+    updateData.insert("里程O", QString::number(snap->runLength.value));
+    updateData.insert("速度X", QString::number(snap->vX.value));
+    updateData.insert("速度Y", QString::number(snap->vY.value));
+    updateData.insert("速度W", QString::number(snap->vAngle.value / 100.0, 'f', 2));
+    updateData.insert("方向D", handleMoveDir(snap->moveDir.value));
+    updateData.insert("任务动作", QString::number(snap->taskAct.value));
+    updateData.insert("急停状态", QString::number(snap->estopState.value));
+    updateData.insert("任务编号", snap->taskId.value);
+    updateData.insert("坐标X", QString::number(snap->slamX.value));
+    updateData.insert("坐标Y", QString::number(snap->slamY.value));
+    updateData.insert("角度A", QString::number(snap->slamAngle.value / 100.0, 'f', 2));
+    updateData.insert("协方差", QString::number(snap->slamCov.value / 1000.0, 'f', 3));
+    updateData.insert("任务错误", snap->taskErr.value);
+    updateData.insert("任务消息", snap->taskDescription.value);
+    updateData.insert("车体错误", snap->agvErr.value);
 
     // 特殊处理的变量
     // mapId
-    if (agvData->mapId().value != m_mapId)
+    if (snap->mapId.value != m_mapId)
     {
-        logger->log(QStringLiteral("BottomInfoBar"), spdlog::level::warn, QStringLiteral("Map id changed! From %1 to %2").arg(m_mapId).arg(agvData->mapId().value));
-        m_mapId = agvData->mapId().value;
+        logger->log(QStringLiteral("BottomInfoBar"), spdlog::level::warn, QStringLiteral("Map id changed! From %1 to %2").arg(m_mapId).arg(snap->mapId.value));
+        m_mapId = snap->mapId.value;
         emit mapIdChanged(m_mapId);
     }
 
@@ -314,4 +323,12 @@ const QString BottomInfoBar::handleGoodsState(int goodsState)
         break;
     }
     return _result;
-}
\ No newline at end of file
+}
+
+void BottomInfoBar::onFieldsChanged(quint64 mask)
+{
+    if (mask & WATCHED_FIELDS)
+    {
+        updateUi();
+    }
+}
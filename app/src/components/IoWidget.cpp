@@ -3,23 +3,23 @@
 #include <QVBoxLayout>
 #include "utils/AgvData.h"
 
+// IO 页面关注的字段
+static constexpr quint64 WATCHED_FIELDS =
+    agvFieldBit(AgvField::xin1) | agvFieldBit(AgvField::xin2) | agvFieldBit(AgvField::xin3) |
+    agvFieldBit(AgvField::yout1) | agvFieldBit(AgvField::yout2) | agvFieldBit(AgvField::yout3);
+
 IoWidget::IoWidget(QWidget *parent) : BaseDisplayWidget(parent)
 {
     initUi();
 
-    // 初始化定时器
-    m_updateTimer = new QTimer(this);
-    m_updateTimer->setInterval(UPDATE_INTERVAL_MS);
-    connect(m_updateTimer, &QTimer::timeout, this, &IoWidget::updateIoStatus);
-    m_updateTimer->start();
+    // 订阅 AgvData 的字段变化通知，仅在关注的字段发生变化时刷新
+    connect(AgvData::instance(), &AgvData::fieldsChanged, this, &IoWidget::onFieldsChanged);
+    // 首次刷新放到事件循环中执行，确保外部的信号连接已经建立
+    QTimer::singleShot(0, this, &IoWidget::updateIoStatus);
 }
 
 IoWidget::~IoWidget()
 {
-    if (m_updateTimer->isActive())
-    {
-        m_updateTimer->stop();
-    }
 }
 
 void IoWidget::initUi()
@@ -140,14 +140,14 @@ void IoWidget::updateIoStatus()
         }
     };
 
-    // 获取 AgvData 实例
-    AgvData *agvData = AgvData::instance();
-    int agvXin1 = agvData->agvXin1().value;
-    int agvXin2 = agvData->agvXin2().value;
-    int agvXin3 = agvData->agvXin3().value;
-    int agvYout1 = agvData->agvYout1().value;
-    int agvYout2 = agvData->agvYout2().value;
-    int agvYout3 = agvData->agvYout3().value;
+    // 获取当前 AGV 状态快照，本次刷新的所有字段均来自同一帧
+    const AgvSnapshotPtr snap = AgvData::instance()->snapshot();
+    int agvXin1 = snap->xin1.value;
+    int agvXin2 = snap->xin2.value;
+    int agvXin3 = snap->xin3.value;
+    int agvYout1 = snap->yout1.value;
+    int agvYout2 = snap->yout2.value;
+    int agvYout3 = snap->yout3.value;
 
     // --- 更新 X 信号 (输入) ---
     // agvXin1 对应 X1-X8 (索引 0-7)
@@ -164,4 +164,12 @@ void IoWidget::updateIoStatus()
     processBits(agvYout2, 8, m_yLamps);
     // agvYout3 对应 Y17-Y24 (索引 16-23)
     processBits(agvYout3, 16, m_yLamps);
-}
\ No newline at end of file
+}
+
+void IoWidget::onFieldsChanged(quint64 mask)
+{
+    if (mask & WATCHED_FIELDS)
+    {
+        updateIoStatus();
+    }
+}
@@ -3,30 +3,30 @@
 #include <QGridLayout>
 #include <QGroupBox>
 
+// 手动控制页面只关注电量（手动充电的自动关闭）
+static constexpr quint64 WATCHED_FIELDS = agvFieldBit(AgvField::battery);
+
 ManualControlWidget::ManualControlWidget(QWidget *parent) : BaseDisplayWidget(parent)
 {
     this->setStyleSheet("background-color: #ffffff;");
     initUi();
 
-    // 初始化定时器
-    m_updateTimer = new QTimer(this);
-    m_updateTimer->setInterval(UPDATE_INTERVAL_MS);
-    connect(m_updateTimer, &QTimer::timeout, this, &ManualControlWidget::updateUi);
-    m_updateTimer->start();
+    // 订阅 AgvData 的字段变化通知，仅在关注的字段发生变化时刷新
+    connect(AgvData::instance(), &AgvData::fieldsChanged, this, &ManualControlWidget::onFieldsChanged);
+    // 充电阈值修改后重新检查手动充电选择框
+    connect(cfg, &ConfigManager::configChanged, this, &ManualControlWidget::updateUi);
+    // 首次刷新放到事件循环中执行，确保外部的信号连接已经建立
+    QTimer::singleShot(0, this, &ManualControlWidget::updateUi);
 }
 
 ManualControlWidget::~ManualControlWidget()
 {
-    if (m_updateTimer->isActive())
-    {
-        m_updateTimer->stop();
-    }
 }
 
 void ManualControlWidget::updateUi()
 {
     // 检测电量，如果 大于等于充电阈值 且手动充电打开，则关闭它
-    if ((agvData->battery().value >= cfg->chargingThreshold()) && chargeCheck->isChecked())
+    if ((agvData->snapshot()->battery.value >= cfg->chargingThreshold()) && chargeCheck->isChecked())
     {
         chargeCheck->setChecked(false);
     }
@@ -81,7 +81,10 @@ void ManualControlWidget::initUi()
     connect(chargeCheck, &QCheckBox::toggled, this, [this](bool checked)
             { 
                 agvData->setChargeCmd(checked); 
-                logger->log(QStringLiteral("ManualControlWidget"), spdlog::level::info, QStringLiteral("手动充电切换为 %1").arg(checked)); });
+                logger->log(QStringLiteral("ManualControlWidget"), spdlog::level::info, QStringLiteral("手动充电切换为 %1").arg(checked));
+                // 电量已达到充电阈值时不允许保持手动充电
+                if (checked)
+                    updateUi(); });
 
     row2->addWidget(pageCheck);
     row2->addStretch();
@@ -257,4 +260,12 @@ void ManualControlWidget::resizeEvent(QResizeEvent *event)
         // 这样容器内部的 layout 才能真正利用这部分空间
         m_contentContainer->setGeometry(0, 10, leftWidth, height() - 20);
     }
-}
\ No newline at end of file
+}
+
+void ManualControlWidget::onFieldsChanged(quint64 mask)
+{
+    if (mask & WATCHED_FIELDS)
+    {
+        updateUi();
+    }
+}
@@ -51,12 +51,16 @@ MonitorWidget::MonitorWidget(QWidget *parent) : BaseDisplayWidget(parent)
     // 链接业务信号
     connect(agvData, &AgvData::pointCloudDataReady, this, &MonitorWidget::updatePointCloud);
     connect(agvData, &AgvData::agvStateChanged, this, &MonitorWidget::updateAgvState);
+    connect(agvData, &AgvData::occupancyGridReady, this, &MonitorWidget::updateOccupancyGrid);
 
     // 初始化图层
     m_mapLayer = new MapLayer();
     m_pointPathLayer = new PointPathLayer();
     m_agvLayer = new AgvLayer();
     m_pointCloudLayer = new PointCloudLayer();
+    applyCloudTrailConfig();
+    connect(ConfigManager::instance(), &ConfigManager::configChanged, this, &MonitorWidget::applyCloudTrailConfig);
+    connect(ConfigManager::instance(), &ConfigManager::configChanged, this, &MonitorWidget::applyMapSourceConfig);
     m_reloLayer = new RelocationLayer();
     m_fixedReloLayer = new FixedRelocationLayer();
 
@@ -84,6 +88,10 @@ MonitorWidget::MonitorWidget(QWidget *parent) : BaseDisplayWidget(parent)
     m_cancelBtn->hide();
     m_reloBtn->show();
 
+    m_fitLabel = new QLabel(this);
+    m_fitLabel->move(10, 100);
+    m_fitLabel->hide();
+
     m_switchBtn = new QPushButton(this);
     m_switchBtn->setIcon(QIcon(":/icons/switch.svg"));
     m_switchBtn->setIconSize(QSize(24, 24));
@@ -120,6 +128,14 @@ void MonitorWidget::showEvent(QShowEvent *event)
 {
     QWidget::showEvent(event);
     centerOnAgv(); // 显示时自动对焦小车
+    agvData->setRosViewActive(true);
+}
+
+void MonitorWidget::hideEvent(QHideEvent *event)
+{
+    QWidget::hideEvent(event);
+    // 切到其他页面或窗口最小化后，点云与位姿按空闲策略退订或节流
+    agvData->setRosViewActive(false);
 }
 
 // --- 地图与坐标控制逻辑 ---
@@ -157,6 +173,11 @@ void MonitorWidget::handleMapIdChanged(int mapId)
 
 void MonitorWidget::handleMapName(int mapId)
 {
+    m_mapId = mapId;
+    // 已收到实时栅格地图时不再载入本地 PNG
+    if (m_liveMap)
+        return;
+
     QString mapUrl = ConfigManager::instance()->mapPngFolder();
 
     QString newMapName = QString::number(mapId) + ".png";
@@ -209,15 +230,69 @@ void MonitorWidget::loadLocalMap(const QString &imagePath, double originX, doubl
     {
         m_mapLayer->updateMap(m_mapPixmap, m_mapResolution, m_mapOriginX, m_mapOriginY);
     }
+    m_reloController->setMap(img, m_mapResolution, m_mapOriginX, m_mapOriginY);
     update();
 }
 
-void MonitorWidget::updatePointCloud(const QVector<QPointF> &points)
+void MonitorWidget::updateOccupancyGrid(const OccupancyGridPatch &grid)
+{
+    if (!ConfigManager::instance()->rosLiveMap() || grid.image.isNull())
+        return;
+
+    if (grid.full)
+    {
+        // 栅格 (0, 0) 为地图左下角，绘制坐标系 y 向下
+        m_liveMap = true;
+        m_mapLayer->updateMap(grid.image, grid.resolution, grid.originX, -grid.originY);
+        m_reloController->setMap(grid.image, grid.resolution, grid.originX, -grid.originY);
+        logger->log(QStringLiteral("MonitorWidget"), spdlog::level::info,
+                    QStringLiteral("收到实时栅格地图 %1 x %2，分辨率 %3 m").arg(grid.image.width()).arg(grid.image.height()).arg(grid.resolution));
+    }
+    else if (!m_mapLayer->isGrid() || !m_mapLayer->updateRegion(grid.image, grid.imageRect(m_mapLayer->size().height()).topLeft()))
+    {
+        // 还没有收到整幅地图，局部更新无处可写
+        return;
+    }
+    else
+    {
+        m_reloController->mapPatched();
+    }
+    update();
+}
+
+void MonitorWidget::applyMapSourceConfig()
+{
+    if (ConfigManager::instance()->rosLiveMap() || !m_liveMap)
+        return;
+
+    // 关闭实时地图后回到本地 PNG
+    m_liveMap = false;
+    m_mapName.clear();
+    if (m_mapId >= 0)
+        handleMapName(m_mapId);
+}
+
+void MonitorWidget::updatePointCloud(const PointCloudBufferPtr &cloud)
 {
-    m_pointCloudLayer->updatePoints(points);
+    m_pointCloudLayer->updatePoints(cloud);
+    // 两次绘制之间到达多帧时只有最后一帧真正上屏，只统计这一帧；
+    // 缩放档位变化后重新降采样的同一帧不重复统计
+    const qint64 stampUs = cloud ? cloud->stampUs : -1;
+    if (stampUs != m_lastCloudStampUs)
+    {
+        m_pendingCloudStampUs = stampUs;
+        m_lastCloudStampUs = stampUs;
+    }
     update();
 }
 
+void MonitorWidget::applyCloudTrailConfig()
+{
+    ConfigManager *cfg = ConfigManager::instance();
+    m_pointCloudLayer->setTrailLimits(qBound(0, cfg->cloudTrailScans(), 50),
+                                      static_cast<qint64>(qBound(1, cfg->cloudTrailMemoryMb(), 64)) * 1024 * 1024);
+}
+
 void MonitorWidget::updateAgvState(const QVector<int> &agvState)
 {
     if (m_isRelocating)
@@ -228,6 +303,7 @@ void MonitorWidget::updateAgvState(const QVector<int> &agvState)
     m_agvAngle = agvState[3];
 
     m_agvLayer->updatePose(m_agvX, m_agvY, m_agvAngle);
+    m_pointCloudLayer->updatePose(QPointF(m_agvX / 1000.0, m_agvY / 1000.0), m_agvAngle / 1000.0);
     update();
 }
 
@@ -245,6 +321,10 @@ void MonitorWidget::paintEvent(QPaintEvent *event)
     // 应用交互处理器计算出的视口变换
     painter.translate(m_offset);
     painter.scale(m_scale, m_scale);
+    // 点云的降采样网格随缩放档位变化
+    agvData->setPointCloudViewScale(m_scale);
+    // 自由重定位拖动中，每帧按当前位姿评估一次扫描与地图的匹配度
+    m_reloController->updateFit();
 
     for (BaseLayer *layer : m_layers)
     {
@@ -262,6 +342,41 @@ void MonitorWidget::paintEvent(QPaintEvent *event)
             layer->draw(&painter);
         }
     }
+
+    painter.end();
+    recordCloudLatency();
+}
+
+void MonitorWidget::recordCloudLatency()
+{
+    if (m_pendingCloudStampUs < 0)
+        return;
+    m_cloudLatency.record(m_pendingCloudStampUs);
+    m_pendingCloudStampUs = -1;
+
+    if (!m_cloudLatencyReport.isValid())
+        m_cloudLatencyReport.start();
+    if (m_cloudLatencyReport.elapsed() < CLOUD_LATENCY_REPORT_MS)
+        return;
+    m_cloudLatencyReport.restart();
+
+    const FrameLatencyStats stats = m_cloudLatency.stats();
+    if (stats.samples > 0)
+    {
+        logger->log(QStringLiteral("MonitorWidget"), spdlog::level::info,
+                    QStringLiteral("点云端到端时延 p50 %1 ms, p95 %2 ms, p99 %3 ms, max %4 ms (样本 %5)")
+                        .arg(stats.p50Ms, 0, 'f', 1)
+                        .arg(stats.p95Ms, 0, 'f', 1)
+                        .arg(stats.p99Ms, 0, 'f', 1)
+                        .arg(stats.maxMs, 0, 'f', 1)
+                        .arg(stats.samples));
+    }
+    else if (stats.discarded > 0)
+    {
+        logger->log(QStringLiteral("MonitorWidget"), spdlog::level::warn,
+                    QStringLiteral("点云时间戳与本机时钟不一致，丢弃 %1 个时延样本").arg(stats.discarded));
+    }
+    m_cloudLatency.reset();
 }
 
 bool MonitorWidget::isInDrawingArea(const QPointF &pos)
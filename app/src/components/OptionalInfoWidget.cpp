@@ -5,6 +5,9 @@
 #include <QJsonDocument>
 #include <QVariant>
 
+// 可选信息页面只关注 OptionalINFO 原始对象
+static constexpr quint64 WATCHED_FIELDS = agvFieldBit(AgvField::optionalInfo);
+
 OptionalInfoWidget::OptionalInfoWidget(QWidget *parent) : QScrollArea(parent)
 {
     this->setWidgetResizable(true);
@@ -22,18 +25,14 @@ OptionalInfoWidget::OptionalInfoWidget(QWidget *parent) : QScrollArea(parent)
     this->setWidget(m_contentWidget);
     m_contentLayout->addStretch();
 
-    m_updateTimer = new QTimer(this);
-    m_updateTimer->setInterval(UPDATE_INTERVAL_MS);
-    connect(m_updateTimer, &QTimer::timeout, this, &OptionalInfoWidget::updateUi);
-    m_updateTimer->start();
+    // 订阅 AgvData 的字段变化通知，仅在关注的字段发生变化时刷新
+    connect(AgvData::instance(), &AgvData::fieldsChanged, this, &OptionalInfoWidget::onFieldsChanged);
+    // 首次刷新放到事件循环中执行，确保外部的信号连接已经建立
+    QTimer::singleShot(0, this, &OptionalInfoWidget::updateUi);
 }
 
 OptionalInfoWidget::~OptionalInfoWidget()
 {
-    if (m_updateTimer->isActive())
-    {
-        m_updateTimer->stop();
-    }
 }
 
 // [修改] 支持颜色参数
@@ -102,8 +101,9 @@ void OptionalInfoWidget::setInfoRow(const QString &key, const QString &value, co
 
 void OptionalInfoWidget::updateUi()
 {
-    AgvData *agvData = AgvData::instance();
-    QJsonObject optionalInfo = agvData->optionalInfo();
+    // 获取当前 AGV 状态快照
+    const AgvSnapshotPtr snap = AgvData::instance()->snapshot();
+    const QJsonObject &optionalInfo = snap->optionalInfo;
 
     for (auto it = optionalInfo.constBegin(); it != optionalInfo.constEnd(); ++it)
     {
@@ -143,4 +143,12 @@ void OptionalInfoWidget::updateUi()
         // [修改] 传入解析出的颜色
         setInfoRow(key, displayStr, displayColor);
     }
-}
\ No newline at end of file
+}
+
+void OptionalInfoWidget::onFieldsChanged(quint64 mask)
+{
+    if (mask & WATCHED_FIELDS)
+    {
+        updateUi();
+    }
+}
@@ -200,6 +200,34 @@ void SystemSettingsWidget::initUI()
     netLayout->addRow("数据通讯IP:", m_commIpEdit);
     netLayout->addRow("数据通讯端口:", m_commPortBox);
 
+    m_commSubscribeCheck = new QCheckBox("启用订阅模式 (控制器主动推送，不支持时自动回退轮询)", this);
+    m_commSubscribeCheck->setStyleSheet("QCheckBox { font-size: 14px; color: #555; }");
+
+    m_commSubscribeRateBox = new QSpinBox(this);
+    m_commSubscribeRateBox->setRange(0, 1000);
+    m_commSubscribeRateBox->setSuffix(" ms");
+    m_commSubscribeRateBox->setSpecialValueText("变化即推送"); // 0 表示数据变化时推送
+    m_commSubscribeRateBox->setFixedWidth(120);
+
+    netLayout->addRow(m_commSubscribeCheck);
+    netLayout->addRow("订阅推送周期:", m_commSubscribeRateBox);
+
+    m_commTouchHeartbeatBox = new QSpinBox(this);
+    m_commTouchHeartbeatBox->setRange(20, 1000);
+    m_commTouchHeartbeatBox->setSuffix(" ms");
+    m_commTouchHeartbeatBox->setFixedWidth(120);
+    netLayout->addRow("TOUCH_STATE 心跳:", m_commTouchHeartbeatBox);
+
+    m_commCborCheck = new QCheckBox("启用 CBOR 二进制帧 (控制器不支持时自动使用 JSON)", this);
+    m_commCborCheck->setStyleSheet("QCheckBox { font-size: 14px; color: #555; }");
+    netLayout->addRow(m_commCborCheck);
+
+    m_networkThreadsBox = new QSpinBox(this);
+    m_networkThreadsBox->setRange(0, 4);
+    m_networkThreadsBox->setSpecialValueText("每连接独占"); // 0 表示每个连接独占一个线程
+    m_networkThreadsBox->setFixedWidth(120);
+    netLayout->addRow("网络线程数 (重启生效):", m_networkThreadsBox);
+
     m_truckLoadingIpEdit = new QLineEdit(this);
     m_truckLoadingIpEdit->setPlaceholderText("127.0.0.1");
     m_truckLoadingIpEdit->setFixedWidth(200);
@@ -222,6 +250,26 @@ void SystemSettingsWidget::initUI()
     netLayout->addRow("RosBridge IP:", m_rosBridgeIpEdit);
     netLayout->addRow("RosBridge 端口:", m_rosBridgePortBox);
 
+    // 监控页面隐藏时的订阅策略：-1 退订，0 保持全速，>0 为 rosbridge 节流间隔
+    m_rosIdleLaserBox = new QSpinBox(this);
+    m_rosIdleLaserBox->setRange(-1, 10000);
+    m_rosIdleLaserBox->setSuffix(" ms");
+    m_rosIdleLaserBox->setSpecialValueText("退订");
+    m_rosIdleLaserBox->setFixedWidth(120);
+
+    m_rosIdleAgvStateBox = new QSpinBox(this);
+    m_rosIdleAgvStateBox->setRange(-1, 10000);
+    m_rosIdleAgvStateBox->setSuffix(" ms");
+    m_rosIdleAgvStateBox->setSpecialValueText("退订");
+    m_rosIdleAgvStateBox->setFixedWidth(120);
+
+    netLayout->addRow("后台点云订阅:", m_rosIdleLaserBox);
+    netLayout->addRow("后台位姿订阅:", m_rosIdleAgvStateBox);
+
+    m_rosLiveMapCheck = new QCheckBox("启用实时栅格地图 (订阅 /map 与 /map_updates，代替本地 PNG 地图)", this);
+    m_rosLiveMapCheck->setStyleSheet("QCheckBox { font-size: 14px; color: #555; }");
+    netLayout->addRow(m_rosLiveMapCheck);
+
     m_serverIpEdit = new QLineEdit(this);
     m_serverIpEdit->setPlaceholderText("127.0.0.1");
     m_serverIpEdit->setFixedWidth(200);
@@ -288,11 +336,45 @@ void SystemSettingsWidget::initUI()
     m_debugModeCheck->setStyleSheet(checkStyle);
     m_fullScreenCheck->setStyleSheet(checkStyle);
 
+    m_trafficCaptureCombo = new QComboBox(this);
+    m_trafficCaptureCombo->setFixedWidth(120);
+    m_trafficCaptureCombo->addItem("关闭", 0);
+    m_trafficCaptureCombo->addItem("完整录制", 1);
+    m_trafficCaptureCombo->addItem("环形录制", 2);
+    m_trafficCaptureCombo->setView(new QListView(this));
+
+    m_trafficRingMinutesBox = new QSpinBox(this);
+    m_trafficRingMinutesBox->setRange(1, 120);
+    m_trafficRingMinutesBox->setSuffix(" min");
+    m_trafficRingMinutesBox->setFixedWidth(120);
+
+    m_cloudTrailScansBox = new QSpinBox(this);
+    m_cloudTrailScansBox->setRange(0, 50);
+    m_cloudTrailScansBox->setSuffix(" 帧");
+    m_cloudTrailScansBox->setSpecialValueText("关闭"); // 0 表示不保留历史帧
+    m_cloudTrailScansBox->setFixedWidth(120);
+
+    m_cloudTrailMemoryBox = new QSpinBox(this);
+    m_cloudTrailMemoryBox->setRange(1, 64);
+    m_cloudTrailMemoryBox->setSuffix(" MB");
+    m_cloudTrailMemoryBox->setFixedWidth(120);
+
+    m_relocationMinFitBox = new QSpinBox(this);
+    m_relocationMinFitBox->setRange(0, 100);
+    m_relocationMinFitBox->setSuffix(" %");
+    m_relocationMinFitBox->setSpecialValueText("不检查"); // 0 表示不拦截确认
+    m_relocationMinFitBox->setFixedWidth(120);
+
     // 添加到表单
     sysLayout->addRow("管理员时长:", m_adminDurationBox);
     sysLayout->addRow(m_defaultFixedRelocationCheck);
     sysLayout->addRow(m_debugModeCheck);
     sysLayout->addRow(m_fullScreenCheck);
+    sysLayout->addRow("流量录制 (重启生效):", m_trafficCaptureCombo);
+    sysLayout->addRow("环形录制保留:", m_trafficRingMinutesBox);
+    sysLayout->addRow("点云历史轨迹:", m_cloudTrailScansBox);
+    sysLayout->addRow("点云轨迹内存上限:", m_cloudTrailMemoryBox);
+    sysLayout->addRow("重定位最低匹配度:", m_relocationMinFitBox);
 
     contentLayout->addLayout(sysLayout);
 
@@ -418,10 +500,18 @@ void SystemSettingsWidget::loadSettings()
     // 网络通讯
     m_commIpEdit->setText(cfg->commIp());
     m_commPortBox->setValue(cfg->commPort());
+    m_commSubscribeCheck->setChecked(cfg->commSubscribe());
+    m_commSubscribeRateBox->setValue(cfg->commSubscribeRateMs());
+    m_commTouchHeartbeatBox->setValue(cfg->commTouchHeartbeatMs());
+    m_commCborCheck->setChecked(cfg->commCbor());
+    m_networkThreadsBox->setValue(cfg->networkThreads());
     m_truckLoadingIpEdit->setText(cfg->truckLoadingIp());
     m_truckLoadingPortBox->setValue(cfg->truckLoadingPort());
     m_rosBridgeIpEdit->setText(cfg->rosBridgeIp());
     m_rosBridgePortBox->setValue(cfg->rosBridgePort());
+    m_rosIdleLaserBox->setValue(cfg->rosIdleLaserPointsMs());
+    m_rosIdleAgvStateBox->setValue(cfg->rosIdleAgvStateMs());
+    m_rosLiveMapCheck->setChecked(cfg->rosLiveMap());
     m_serverIpEdit->setText(cfg->serverIp());
     m_serverPortBox->setValue(cfg->serverPort());
     // 其他通讯
@@ -438,6 +528,15 @@ void SystemSettingsWidget::loadSettings()
     m_defaultFixedRelocationCheck->setChecked(cfg->defaultFixedRelocation());
     m_debugModeCheck->setChecked(cfg->debugMode());
     m_fullScreenCheck->setChecked(cfg->fullScreen());
+    int trafficCaptureIndex = m_trafficCaptureCombo->findData(cfg->trafficCapture());
+    if (trafficCaptureIndex != -1)
+    {
+        m_trafficCaptureCombo->setCurrentIndex(trafficCaptureIndex);
+    }
+    m_trafficRingMinutesBox->setValue(cfg->trafficRingMinutes());
+    m_cloudTrailScansBox->setValue(cfg->cloudTrailScans());
+    m_cloudTrailMemoryBox->setValue(cfg->cloudTrailMemoryMb());
+    m_relocationMinFitBox->setValue(cfg->relocationMinFit());
 }
 
 // 保存配置
@@ -461,10 +560,18 @@ void SystemSettingsWidget::saveSettings()
     // 网络通讯
     cfg->setCommIp(m_commIpEdit->text());
     cfg->setCommPort(m_commPortBox->value());
+    cfg->setCommSubscribe(m_commSubscribeCheck->isChecked());
+    cfg->setCommSubscribeRateMs(m_commSubscribeRateBox->value());
+    cfg->setCommTouchHeartbeatMs(m_commTouchHeartbeatBox->value());
+    cfg->setCommCbor(m_commCborCheck->isChecked());
+    cfg->setNetworkThreads(m_networkThreadsBox->value());
     cfg->setTruckLoadingIp(m_truckLoadingIpEdit->text());
     cfg->setTruckLoadingPort(m_truckLoadingPortBox->value());
     cfg->setRosBridgeIp(m_rosBridgeIpEdit->text());
     cfg->setRosBridgePort(m_rosBridgePortBox->value());
+    cfg->setRosIdleLaserPointsMs(m_rosIdleLaserBox->value());
+    cfg->setRosIdleAgvStateMs(m_rosIdleAgvStateBox->value());
+    cfg->setRosLiveMap(m_rosLiveMapCheck->isChecked());
     cfg->setServerIp(m_serverIpEdit->text());
     cfg->setServerPort(m_serverPortBox->value());
     // 其他通讯
@@ -475,6 +582,11 @@ void SystemSettingsWidget::saveSettings()
     cfg->setDefaultFixedRelocation(m_defaultFixedRelocationCheck->isChecked());
     cfg->setDebugMode(m_debugModeCheck->isChecked());
     cfg->setFullScreen(m_fullScreenCheck->isChecked());
+    cfg->setTrafficCapture(m_trafficCaptureCombo->currentData().toInt());
+    cfg->setTrafficRingMinutes(m_trafficRingMinutesBox->value());
+    cfg->setCloudTrailScans(m_cloudTrailScansBox->value());
+    cfg->setCloudTrailMemoryMb(m_cloudTrailMemoryBox->value());
+    cfg->setRelocationMinFit(m_relocationMinFitBox->value());
 
     // 2. 调用单例的保存（写入磁盘 + 发送信号）
     cfg->save();
@@ -13,6 +13,11 @@
 #include "PermissionManager.h"
 #include "qdir.h"
 
+// 顶部状态栏关注的字段
+static constexpr quint64 WATCHED_FIELDS =
+    agvFieldBit(AgvField::agvId) | agvFieldBit(AgvField::light) | agvFieldBit(AgvField::battery) |
+    agvFieldBit(AgvField::agvMode) | agvFieldBit(AgvField::agvState);
+
 TopHeaderWidget::TopHeaderWidget(QWidget *parent) : QWidget(parent)
 {
     // 设置自身属性
@@ -40,6 +45,11 @@ TopHeaderWidget::TopHeaderWidget(QWidget *parent) : QWidget(parent)
     connect(cfg, &ConfigManager::configChanged,
             this, &TopHeaderWidget::updateInfoFromConfig);
 
+    // 用户角色图标：初始化时显示一次，之后由角色变更信号驱动
+    handleUserRoleUpdate(cfg->currentUserRole());
+    connect(cfg, &ConfigManager::userRoleChanged,
+            this, &TopHeaderWidget::handleUserRoleUpdate);
+
     // ==========================================
     // 【新增】初始化网络检测线程
     // ==========================================
@@ -60,11 +70,10 @@ TopHeaderWidget::TopHeaderWidget(QWidget *parent) : QWidget(parent)
     // 启动线程
     m_netThread->start();
 
-    // 初始化定时器
-    m_updateTimer = new QTimer(this);
-    m_updateTimer->setInterval(UPDATE_INTERVAL_MS);
-    connect(m_updateTimer, &QTimer::timeout, this, &TopHeaderWidget::updateUi);
-    m_updateTimer->start();
+    // 订阅 AgvData 的字段变化通知，仅在关注的字段发生变化时刷新
+    connect(AgvData::instance(), &AgvData::fieldsChanged, this, &TopHeaderWidget::onFieldsChanged);
+    // 首次刷新放到事件循环中执行，确保外部的信号连接已经建立
+    QTimer::singleShot(0, this, &TopHeaderWidget::updateUi);
 
     // 初始化长按计时器
     m_logoLongPressTimer = new QTimer(this);
@@ -90,10 +99,6 @@ TopHeaderWidget::~TopHeaderWidget()
         m_netThread->wait();
     }
 
-    if (m_updateTimer->isActive())
-    {
-        m_updateTimer->stop();
-    }
 }
 
 void TopHeaderWidget::initLayout()
@@ -230,8 +235,15 @@ void TopHeaderWidget::initLayout()
     m_networkCheckValueLabel->setFixedWidth(labelValueWidth);
     m_networkCheckValueLabel->setAlignment(Qt::AlignLeft | Qt::AlignVCenter); // 文字右对齐看起来比较整齐
 
+    // 往返时延紧跟在网络状态之后，区分网络问题与控制器响应慢
+    m_linkLatencyLabel = new QLabel("RTT --", this);
+    m_linkLatencyLabel->setFont(labelNameFont);
+    m_linkLatencyLabel->setFixedWidth(120);
+    m_linkLatencyLabel->setAlignment(Qt::AlignLeft | Qt::AlignVCenter);
+
     networkCheckLayout->addWidget(m_networkCheckNameLabel);
     networkCheckLayout->addWidget(m_networkCheckValueLabel);
+    networkCheckLayout->addWidget(m_linkLatencyLabel);
 
     // --- 运行模式行 (水平布局) ---
     QWidget *runModeWidget = new QWidget(this);
@@ -375,6 +387,35 @@ void TopHeaderWidget::onNetworkStatusChanged(QString text, bool isNormal)
     }
 }
 
+// 往返时延：显示 p50/p99，详细统计放在提示中；本周期出现丢包时标红
+void TopHeaderWidget::setLinkLatency(const LinkLatencyStats &stats)
+{
+    if (stats.samples == 0)
+    {
+        m_linkLatencyLabel->setText("RTT --");
+        m_linkLatencyLabel->setToolTip(QString());
+        m_linkLatencyLabel->setStyleSheet(QString());
+        m_lastLinkLost = stats.lost;
+        return;
+    }
+
+    m_linkLatencyLabel->setText(QStringLiteral("RTT %1/%2ms")
+                                    .arg(stats.p50Ms, 0, 'f', 0)
+                                    .arg(stats.p99Ms, 0, 'f', 0));
+    m_linkLatencyLabel->setToolTip(QStringLiteral("p50 %1 ms\np95 %2 ms\np99 %3 ms\nmax %4 ms\n丢包 %5 / %6\n乱序 %7")
+                                       .arg(stats.p50Ms, 0, 'f', 1)
+                                       .arg(stats.p95Ms, 0, 'f', 1)
+                                       .arg(stats.p99Ms, 0, 'f', 1)
+                                       .arg(stats.maxMs, 0, 'f', 1)
+                                       .arg(stats.lost)
+                                       .arg(stats.sent)
+                                       .arg(stats.outOfOrder));
+
+    bool newLoss = stats.lost > m_lastLinkLost;
+    m_lastLinkLost = stats.lost;
+    m_linkLatencyLabel->setStyleSheet(newLoss ? QStringLiteral("color: red;") : QStringLiteral("color: %1;").arg(valueColor));
+}
+
 // 实现公开接口
 void TopHeaderWidget::setAgvInfo(const QString &id, const QString &ip)
 {
@@ -474,25 +515,23 @@ QPixmap TopHeaderWidget::colorizePixmap(const QPixmap &src, const QColor &color)
 // 更新 UI
 void TopHeaderWidget::updateUi()
 {
-    // 获取 AgvData 实例
-    AgvData *agvData = AgvData::instance();
-    // 更新用户角色图标
-    handleUserRoleUpdate(cfg->currentUserRole());
+    // 获取当前 AGV 状态快照，本次刷新的所有字段均来自同一帧
+    const AgvSnapshotPtr snap = AgvData::instance()->snapshot();
     // 更新 agvId
-    int agvId = agvData->agvId().value;
+    int agvId = snap->agvId.value;
     QString _agvIdLabel = QStringLiteral("AGV编号：<span style='color: %1;'>%2</span>").arg(valueColor).arg(agvId);
     m_agvIdLabel->setText(_agvIdLabel);
     // 更新 light 颜色
-    int light = agvData->light().value;
+    int light = snap->light.value;
     handleLightUpdate(light);
     // 更新 battery
-    int battery = agvData->battery().value;
+    int battery = snap->battery.value;
     setBatteryLevel(battery);
     // 更新 agvMode
-    int agvMode = agvData->agvMode().value;
+    int agvMode = snap->agvMode.value;
     handleAgvModeUpdate(agvMode);
     // 更新 agvState
-    int agvState = agvData->agvState().value;
+    int agvState = snap->agvState.value;
     handleAgvStateUpdate(agvState);
 }
 
@@ -616,4 +655,12 @@ void TopHeaderWidget::handleAgvStateUpdate(int agvState)
         // 不做处理
         break;
     }
-}
\ No newline at end of file
+}
+
+void TopHeaderWidget::onFieldsChanged(quint64 mask)
+{
+    if (mask & WATCHED_FIELDS)
+    {
+        updateUi();
+    }
+}
@@ -4,6 +4,13 @@
 #include "utils/ConfigManager.h"
 #include "qdir.h"
 
+// 车辆信息页面关注的字段
+static constexpr quint64 WATCHED_FIELDS =
+    agvFieldBit(AgvField::goodsState) |
+    agvFieldBit(AgvField::bumpBack) | agvFieldBit(AgvField::bumpFront) | agvFieldBit(AgvField::bumpRight) | agvFieldBit(AgvField::bumpLeft) |
+    agvFieldBit(AgvField::backArea) | agvFieldBit(AgvField::backRight) | agvFieldBit(AgvField::backLeft) |
+    agvFieldBit(AgvField::frontArea) | agvFieldBit(AgvField::frontRight) | agvFieldBit(AgvField::frontLeft);
+
 VehicleInfoWidget::VehicleInfoWidget(QWidget *parent) : BaseDisplayWidget(parent)
 {
     this->setStyleSheet("background-color: #ffffff");
@@ -42,19 +49,14 @@ VehicleInfoWidget::VehicleInfoWidget(QWidget *parent) : BaseDisplayWidget(parent
     m_radarStates[SensorZone::TopRight] = SensorState::Normal;
     m_radarStates[SensorZone::BottomRight] = SensorState::Normal;
 
-    // 初始化定时器
-    m_updateTimer = new QTimer(this);
-    m_updateTimer->setInterval(UPDATE_INTERVAL_MS);
-    connect(m_updateTimer, &QTimer::timeout, this, &VehicleInfoWidget::updateUi);
-    m_updateTimer->start();
+    // 订阅 AgvData 的字段变化通知，仅在关注的字段发生变化时刷新
+    connect(AgvData::instance(), &AgvData::fieldsChanged, this, &VehicleInfoWidget::onFieldsChanged);
+    // 首次刷新放到事件循环中执行，确保外部的信号连接已经建立
+    QTimer::singleShot(0, this, &VehicleInfoWidget::updateUi);
 }
 
 VehicleInfoWidget::~VehicleInfoWidget()
 {
-    if (m_updateTimer->isActive())
-    {
-        m_updateTimer->stop();
-    }
 }
 
 // 直接保存 int 状态
@@ -242,24 +244,24 @@ void VehicleInfoWidget::drawRadarBox(QPainter &painter, const QRect &rect, Senso
 
 void VehicleInfoWidget::updateUi()
 {
-    // 获取 AgvData 实例
-    AgvData *agvData = AgvData::instance();
+    // 获取当前 AGV 状态快照，本次刷新的所有字段均来自同一帧
+    const AgvSnapshotPtr snap = AgvData::instance()->snapshot();
     // 处理货物
-    int goodsState = agvData->goodsState().value;
+    int goodsState = snap->goodsState.value;
     setCargoState(goodsState);
     // 处理防撞条
-    int bumpBack = agvData->bumpBack().value;
-    int bumpFront = agvData->bumpFront().value;
-    int bumpRight = agvData->bumpRight().value;
-    int bumpLeft = agvData->bumpLeft().value;
+    int bumpBack = snap->bumpBack.value;
+    int bumpFront = snap->bumpFront.value;
+    int bumpRight = snap->bumpRight.value;
+    int bumpLeft = snap->bumpLeft.value;
     setBumperState(static_cast<bool>(bumpBack), static_cast<bool>(bumpFront), static_cast<bool>(bumpRight), static_cast<bool>(bumpLeft));
     // 处理避障区域
-    int backArea = agvData->backArea().value;
-    int backRight = agvData->backRight().value;
-    int backLeft = agvData->backLeft().value;
-    int frontArea = agvData->frontArea().value;
-    int frontRight = agvData->frontRight().value;
-    int frontLeft = agvData->frontLeft().value;
+    int backArea = snap->backArea.value;
+    int backRight = snap->backRight.value;
+    int backLeft = snap->backLeft.value;
+    int frontArea = snap->frontArea.value;
+    int frontRight = snap->frontRight.value;
+    int frontLeft = snap->frontLeft.value;
     handleArea(backArea, backRight, backLeft, frontArea, frontLeft, frontRight);
     // 更新完毕后统一触发重绘
     update();
@@ -303,4 +305,12 @@ SensorState VehicleInfoWidget::parseRadarState(int state)
     }
 
     return result;
-}
\ No newline at end of file
+}
+
+void VehicleInfoWidget::onFieldsChanged(quint64 mask)
+{
+    if (mask & WATCHED_FIELDS)
+    {
+        updateUi();
+    }
+}
@@ -1,10 +1,14 @@
 #include <QApplication>
+#include <QCommandLineParser>
+#include <QDir>
 #include "MainWindow.h"
 #include <QIcon>
 #include "utils/ConfigManager.h"
 #include "Version.h"
 #include "utils/GlobalEventFilter.h"
 #include "utils/LogManager.h"
+#include "utils/TrafficRecorder.h"
+#include "utils/TrafficReplay.h"
 
 // 程序的任务栏/窗口左上角图标
 #define ICON_LOGO "icon.png"
@@ -20,6 +24,16 @@ int main(int argc, char *argv[])
     app.setApplicationName("RuinapControl");
     app.setApplicationVersion(APP_VERSION);
 
+    // 命令行参数：回放录制的流量代替 socket
+    QCommandLineParser parser;
+    parser.addHelpOption();
+    parser.addVersionOption();
+    QCommandLineOption replayOpt("replay", "回放录制文件或环形录制目录，不连接 socket", "path");
+    QCommandLineOption replaySpeedOpt("replay-speed", "回放倍速，max 表示最快速度", "speed", "1");
+    parser.addOption(replayOpt);
+    parser.addOption(replaySpeedOpt);
+    parser.process(app);
+
     // 在 UI 启动前，优先加载配置到内存
     ConfigManager::instance()->load();
     ConfigManager *cfg = ConfigManager::instance();
@@ -30,6 +44,28 @@ int main(int argc, char *argv[])
     logger->init(logPath, cfg->debugMode());
     logger->log("System", spdlog::level::info, QString("Ruinap Control System starting... Version: %1").arg(APP_VERSION));
 
+    // 回放源需要在 MainWindow / AgvData 创建之前建立，它们据此决定是否连接 socket
+    TrafficReplay *replay = nullptr;
+    if (parser.isSet(replayOpt))
+    {
+        const QString speedText = parser.value(replaySpeedOpt);
+        bool ok = true;
+        double speed = speedText.compare(QLatin1String("max"), Qt::CaseInsensitive) == 0 ? 0.0 : speedText.toDouble(&ok);
+        if (!ok || speed < 0)
+            speed = 1.0;
+        replay = new TrafficReplay(parser.value(replayOpt), speed);
+        // 先于 NetworkReactor 的清理停止回放，回放线程可能正在等待 I/O 线程处理帧
+        QObject::connect(&app, &QCoreApplication::aboutToQuit, [replay]()
+                         { replay->stop(); replay->wait(); });
+    }
+    else
+    {
+        // 回放时不录制；录制文件写入日志文件夹下的 capture 目录
+        TrafficRecorder::instance()->start(static_cast<TrafficRecorder::Mode>(qBound(0, cfg->trafficCapture(), 2)),
+                                           QDir(logPath).filePath(QStringLiteral("capture")),
+                                           cfg->trafficRingMinutes());
+    }
+
     // 设置程序的任务栏/窗口左上角图标,改为从内存单例读取
     // 先加载图片
     QString resourceFolder = cfg->resourceFolder();
@@ -60,6 +96,13 @@ int main(int argc, char *argv[])
     MainWindow w;
     w.show();
 
+    if (replay)
+        replay->start();
+
     // 进入事件循环（死循环，直到点击关闭）
-    return app.exec();
+    int ret = app.exec();
+
+    delete replay;
+    TrafficRecorder::instance()->stop();
+    return ret;
 }
\ No newline at end of file
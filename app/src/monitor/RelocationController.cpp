@@ -4,10 +4,38 @@
 #include "layers/RelocationLayer.h"
 #include "layers/PointCloudLayer.h"
 #include "layers/FixedRelocationLayer.h"
+#include "utils/ConfigManager.h"
 #include <QPushButton>
+#include <QLabel>
+#include <QElapsedTimer>
 
 RelocationController::RelocationController(MonitorWidget *parent)
-    : QObject(parent), w(parent) {}
+    : QObject(parent), w(parent)
+{
+    m_fieldRebuildTimer = new QTimer(this);
+    m_fieldRebuildTimer->setSingleShot(true);
+    m_fieldRebuildTimer->setInterval(FIELD_REBUILD_DELAY_MS);
+    connect(m_fieldRebuildTimer, &QTimer::timeout, this, [this]()
+            { buildField(w->m_mapLayer->image()); });
+
+    // 大地图的距离变换需要数十到数百毫秒，放到工作线程中，完成后回到主线程替换
+    m_fieldWorker = QThread::create([this]()
+                                    { fieldWorkerLoop(); });
+    m_fieldWorker->setObjectName(QStringLiteral("MapDistanceField"));
+    m_fieldWorker->start(QThread::LowPriority);
+}
+
+RelocationController::~RelocationController()
+{
+    // 正在进行的计算不可中断，等待其结束；未开始的请求直接丢弃
+    {
+        QMutexLocker locker(&m_fieldMutex);
+        m_fieldQuit = true;
+        m_fieldWake.wakeOne();
+    }
+    m_fieldWorker->wait();
+    delete m_fieldWorker;
+}
 
 void RelocationController::start()
 {
@@ -39,9 +67,147 @@ void RelocationController::start()
     // 3. 锁定点云到局部坐标系，以便随重定位图层旋转/平移
     w->m_pointCloudLayer->lockToLocal(agvPos, agvAngle);
 
+    // 4. 吻合度指示，在下一次绘制时计算
+    m_fitValid = false;
+    w->m_fitLabel->show();
+
     w->update();
 }
 
+void RelocationController::setMap(const QImage &map, double res, double ox, double oy)
+{
+    m_fieldRebuildTimer->stop();
+    m_field.reset();
+    m_fieldStale = false;
+    m_fitValid = false;
+    m_mapRes = res;
+    m_mapOx = ox;
+    m_mapOy = oy;
+    buildField(map);
+}
+
+void RelocationController::mapPatched()
+{
+    // 每次局部更新都重新计时，更新停止 FIELD_REBUILD_DELAY_MS 后才重建
+    m_fieldRebuildTimer->start();
+    m_fieldStale = true;
+    m_fitValid = false;
+}
+
+void RelocationController::buildField(const QImage &map)
+{
+    const int seq = ++m_fieldSeq;
+    if (map.isNull())
+        return;
+
+    QMutexLocker locker(&m_fieldMutex);
+    m_fieldJob.seq = seq;
+    m_fieldJob.map = map;
+    m_fieldJob.res = m_mapRes;
+    m_fieldJob.ox = m_mapOx;
+    m_fieldJob.oy = m_mapOy;
+    m_fieldJobPending = true;
+    m_fieldWake.wakeOne();
+}
+
+void RelocationController::fieldWorkerLoop()
+{
+    forever
+    {
+        FieldJob job;
+        {
+            QMutexLocker locker(&m_fieldMutex);
+            while (!m_fieldJobPending && !m_fieldQuit)
+                m_fieldWake.wait(&m_fieldMutex);
+            if (m_fieldQuit)
+                return;
+            job = m_fieldJob;
+            m_fieldJob.map = QImage(); // 不在等待期间继续持有地图
+            m_fieldJobPending = false;
+        }
+
+        QElapsedTimer timer;
+        timer.start();
+        const MapDistanceFieldPtr field = MapDistanceField::build(job.map, job.res, job.ox, job.oy);
+        const qint64 ms = timer.elapsed();
+
+        // 控制器析构时会等待本线程退出，投递给 this 的结果要么在主线程执行，要么随控制器一起被丢弃
+        const int seq = job.seq;
+        QMetaObject::invokeMethod(this, [this, seq, field, ms]()
+                                  { applyField(seq, field, ms); }, Qt::QueuedConnection);
+    }
+}
+
+void RelocationController::applyField(int seq, const MapDistanceFieldPtr &field, qint64 ms)
+{
+    if (seq != m_fieldSeq)
+        return; // 计算期间地图已再次变化，等待更新的结果
+    m_field = field;
+    m_fieldStale = m_fieldRebuildTimer->isActive(); // 计算期间又收到局部更新，仍待重建
+    m_fitValid = false;
+    logger->log(QStringLiteral("RelocationController"), spdlog::level::info,
+                QStringLiteral("地图距离场计算完成 %1 x %2，耗时 %3 ms").arg(field ? field->width() : 0).arg(field ? field->height() : 0).arg(ms));
+    if (w->m_isRelocating)
+        w->update();
+}
+
+void RelocationController::updateFit()
+{
+    if (!w->m_isRelocating)
+        return;
+
+    const std::vector<float> &xy = w->m_pointCloudLayer->localPoints();
+    if (!m_field || xy.empty())
+    {
+        showFit(m_field ? QStringLiteral("匹配度: 无点云") : QStringLiteral("匹配度: 计算中"), QStringLiteral("#888888"));
+        return;
+    }
+
+    // 重定位图层位于绘制坐标系（y 向下），换算回世界坐标
+    const QPointF pos(w->m_reloLayer->pos().x(), -w->m_reloLayer->pos().y());
+    const double rad = w->m_reloLayer->getAngle();
+    if (m_fitValid && pos == m_fitPos && rad == m_fitRad)
+        return;
+
+    m_fit = m_field->fit(xy.data(), static_cast<int>(xy.size() / 2), pos, rad);
+    m_fitPos = pos;
+    m_fitRad = rad;
+    m_fitValid = true;
+
+    // 低于下限为红色，下限以上 20 个百分点以内为橙色，其余为绿色
+    const int percent = qRound(m_fit.score * 100.0);
+    const int minFit = ConfigManager::instance()->relocationMinFit();
+    const QString color = fitTooLow() ? QStringLiteral("#dc3545") : percent < minFit + 20 ? QStringLiteral("#fd7e14") : QStringLiteral("#28a745");
+    QString text = QStringLiteral("匹配度: %1%  偏差 %2 cm").arg(percent).arg(m_fit.meanDist * 100.0, 0, 'f', 1);
+    if (m_fieldStale)
+        text += QStringLiteral("  (地图已更新，重新计算中)");
+    showFit(text, color);
+}
+
+void RelocationController::showFit(const QString &text, const QString &color)
+{
+    // 拖动时每帧都会调用，样式表只在颜色变化时重新设置
+    QLabel *label = w->m_fitLabel;
+    if (color != m_fitColor)
+    {
+        m_fitColor = color;
+        label->setStyleSheet(QStringLiteral("color: white; font-size: 16px; font-weight: bold; background-color: %1; padding: 6px; border-radius: 4px;").arg(color));
+    }
+    if (label->text() != text)
+    {
+        label->setText(text);
+        label->adjustSize();
+    }
+}
+
+bool RelocationController::fitTooLow() const
+{
+    const int minFit = ConfigManager::instance()->relocationMinFit();
+    if (minFit <= 0 || !m_field || m_fieldStale || !m_fitValid || m_fit.points == 0)
+        return false;
+    return m_fit.score * 100.0 < minFit;
+}
+
 void RelocationController::switchMode()
 {
     // 切换状态
@@ -80,6 +246,7 @@ void RelocationController::exitMode()
     w->m_isRelocating = false;
     w->m_reloLayer->setVisible(false);
     w->m_pointCloudLayer->unlock();
+    w->m_fitLabel->hide();
 
     w->m_confirmBtn->hide();
     w->m_cancelBtn->hide();
@@ -91,6 +258,17 @@ void RelocationController::exitMode()
 
 void RelocationController::finish()
 {
+    // 以当前位姿重新评估一次，拖动后尚未绘制时也按最终位姿判断
+    m_fitValid = false;
+    updateFit();
+    if (fitTooLow())
+    {
+        logger->log(QStringLiteral("RelocationController"), spdlog::level::warn,
+                    QStringLiteral("扫描与地图匹配度 %1% 低于下限 %2%，拒绝重定位").arg(qRound(m_fit.score * 100.0)).arg(ConfigManager::instance()->relocationMinFit()));
+        showFit(w->m_fitLabel->text() + QStringLiteral("  匹配度过低，无法确认"), m_fitColor);
+        return;
+    }
+
     // 获取重定位图层的当前位姿并发送信号 (反算回世界坐标系)
     emit w->baseIniPose(QPointF(w->m_reloLayer->pos().x(), -w->m_reloLayer->pos().y()),
                         w->m_reloLayer->getAngle());
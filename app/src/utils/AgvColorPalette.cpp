@@ -0,0 +1,54 @@
+#include "AgvColorPalette.h"
+
+AgvColorPalette *AgvColorPalette::instance()
+{
+    static AgvColorPalette instance;
+    return &instance;
+}
+
+AgvColorPalette::AgvColorPalette()
+{
+    m_names[DEFAULT_COLOR] = QStringLiteral("#000000"); // 默认黑
+    m_count.store(1, std::memory_order_release);
+}
+
+// 颜色种类很少，线性查找即可
+int AgvColorPalette::find(QStringView name, int count) const
+{
+    for (int i = 0; i < count; ++i)
+    {
+        if (QStringView(m_names[i]) == name)
+            return i;
+    }
+    return -1;
+}
+
+quint16 AgvColorPalette::intern(QStringView name)
+{
+    int index = find(name, m_count.load(std::memory_order_acquire));
+    if (index >= 0)
+        return static_cast<quint16>(index);
+
+    QMutexLocker locker(&m_writeMutex);
+
+    // 加锁期间可能已被其他线程登记
+    const int count = m_count.load(std::memory_order_relaxed);
+    index = find(name, count);
+    if (index >= 0)
+        return static_cast<quint16>(index);
+
+    // 表已满（服务端颜色异常），不再登记
+    if (count >= CAPACITY)
+        return DEFAULT_COLOR;
+
+    m_names[count] = name.toString();
+    m_count.store(count + 1, std::memory_order_release);
+    return static_cast<quint16>(count);
+}
+
+QString AgvColorPalette::name(quint16 index) const
+{
+    if (index >= m_count.load(std::memory_order_acquire))
+        return m_names[DEFAULT_COLOR];
+    return m_names[index];
+}
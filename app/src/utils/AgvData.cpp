@@ -1,26 +1,11 @@
 #include "AgvData.h"
-#include <QJsonDocument>
-#include <QJsonParseError>
 #include "ConfigManager.h"
+#include "NetworkReactor.h"
+#include "TrafficReplay.h"
 
 // 全局静态指针
 static AgvData *s_instance = nullptr;
 
-// 辅助函数：从 JSON 对象中提取 AgvAttribute
-// 假设 json 格式为: "battery": { "value": 80.5, "color": "#00FF00" }
-template <typename T>
-AgvAttribute<T> parseAttr(const QJsonObject &root, const QString &key)
-{
-    if (!root.contains(key))
-        return AgvAttribute<T>(); // 返回默认
-
-    QJsonObject obj = root[key].toObject();
-    T val = QVariant(obj["value"].toVariant()).value<T>(); // 自动转换类型
-    QString col = obj["color"].toString("#000000");        // 默认黑
-
-    return AgvAttribute<T>(val, col);
-}
-
 AgvData *AgvData::instance()
 {
     static AgvData instance;
@@ -30,48 +15,62 @@ AgvData *AgvData::instance()
 // 初始化 AgvData
 AgvData::AgvData(QObject *parent) : QObject(parent)
 {
-    initData();    // 初始化值
-    initParsers(); // 初始化绑定
-
-    // 创建线程
-    m_rosThread = new QThread(this);
+    initData();        // 初始化值
+    publishSnapshot(); // 发布初始快照，保证 snapshot() 永不为空
 
     // 创建 Client (注意：不能传 this 作为 parent，否则无法移动线程)
     m_rosClient = new RosBridgeClient();
 
-    // 移动到子线程
-    m_rosClient->moveToThread(m_rosThread);
+    // 托管到网络 I/O 线程，与其他 WebSocket 连接共享
+    NetworkReactor::instance()->attach(m_rosClient);
 
     // 连接信号槽
-    connect(m_rosClient, &RosBridgeClient::pointCloudReceived, this, &AgvData::pointCloudDataReady);
-    connect(m_rosClient, &RosBridgeClient::agvStateReceived, this, &AgvData::agvStateChanged);
+    // 点云与 /agv_state 先在 I/O 线程中写入只保留最新帧的邮箱，再通知主线程
+    connect(m_rosClient, &RosBridgeClient::pointCloudReceived, this, &AgvData::onPointCloudReceived, Qt::DirectConnection);
+    connect(m_rosClient, &RosBridgeClient::agvStateReceived, this, &AgvData::onRosAgvStateReceived, Qt::DirectConnection);
     connect(this, &AgvData::requestInitialPose, m_rosClient, &RosBridgeClient::setInitialPose);
+    connect(this, &AgvData::pointCloudZoomChanged, m_rosClient, &RosBridgeClient::redecimateCloud);
+    connect(m_rosClient, &RosBridgeClient::occupancyGridReceived, this, &AgvData::occupancyGridReady);
+    // 监控页面显示状态与空闲订阅策略变化时，在 I/O 线程中更新 rosbridge 订阅
+    connect(this, &AgvData::rosViewActiveChanged, m_rosClient, &RosBridgeClient::setViewActive);
+    connect(ConfigManager::instance(), &ConfigManager::configChanged, m_rosClient, &RosBridgeClient::refreshSubscriptions);
 
     // 启动连接逻辑
-    // 当线程启动时，调用 connectToRos。使用 QueueConnection 确保在子线程执行
-    ConfigManager *cfg = ConfigManager::instance();
-    QString ip = cfg->rosBridgeIp();
-    int port = cfg->rosBridgePort();
-    QString url = QStringLiteral("ws://%1:%2").arg(ip).arg(port);
+    if (TrafficReplay *replay = TrafficReplay::active())
+    {
+        // 回放模式：不连接 rosbridge，由回放线程送入录制的帧，逐帧等待 I/O 线程处理完成
+        connect(replay, &TrafficReplay::rosBinaryMessage, m_rosClient, &RosBridgeClient::injectBinaryMessage, Qt::BlockingQueuedConnection);
+    }
+    else
+    {
+        // 调用 connectToRos。使用 QueueConnection 确保在 I/O 线程执行
+        ConfigManager *cfg = ConfigManager::instance();
+        QString ip = cfg->rosBridgeIp();
+        int port = cfg->rosBridgePort();
+        QString url = QStringLiteral("ws://%1:%2").arg(ip).arg(port);
 
-    connect(m_rosThread, &QThread::started, m_rosClient, [this, url]()
-            { m_rosClient->connectToRos(url); });
+        RosBridgeClient *rosClient = m_rosClient;
+        QMetaObject::invokeMethod(rosClient, [rosClient, url]()
+                                  { rosClient->connectToRos(url); }, Qt::QueuedConnection);
+    }
 
-    // 资源清理：当 Widget 销毁时，退出线程
-    connect(m_rosThread, &QThread::finished, m_rosClient, &QObject::deleteLater);
+    // 邮箱合并计数的定期检查
+    m_mailboxReportTimer = new QTimer(this);
+    m_mailboxReportTimer->setInterval(MAILBOX_REPORT_MS);
+    connect(m_mailboxReportTimer, &QTimer::timeout, this, &AgvData::reportMailboxStats);
+    m_mailboxReportTimer->start();
 
-    // 启动线程
-    m_rosThread->start();
+    // 段落跳过命中率的定期输出
+    m_decodeReportTimer = new QTimer(this);
+    m_decodeReportTimer->setInterval(DECODE_REPORT_MS);
+    connect(m_decodeReportTimer, &QTimer::timeout, this, &AgvData::reportDecodeStats);
+    m_decodeReportTimer->start();
 }
 
 AgvData::~AgvData()
 {
-    // 关闭 ros 线程
-    if (m_rosThread->isRunning())
-    {
-        m_rosThread->quit();
-        m_rosThread->wait();
-    }
+    // 销毁 ros 客户端（程序退出时通常已由 NetworkReactor 统一清理）
+    NetworkReactor::instance()->detach(m_rosClient);
 
     // 程序退出时清理
     if (s_instance == this)
@@ -82,68 +81,8 @@ AgvData::~AgvData()
 
 void AgvData::initData()
 {
-    // AgvInfo
-    m_agvErr = AgvString("Initializing", "#000000");
-    m_xin1 = AgvInt(0xff, "#000000");
-    m_xin2 = AgvInt(0xff, "#000000");
-    m_xin3 = AgvInt(0xff, "#000000");
-    m_yout1 = AgvInt(0x00, "#000000");
-    m_yout2 = AgvInt(0x00, "#000000");
-    m_yout3 = AgvInt(0x00, "#000000");
-    m_agvId = AgvInt(-1, "#000000");
-    m_agvName = AgvString("Unconnected", "#000000");
-    m_battery = AgvInt(100, "#000000");
-    m_mapId = AgvInt(1, "#000000");
-    m_slamX = AgvInt(-1, "#000000");
-    m_slamY = AgvInt(-1, "#000000");
-    m_slamAngle = AgvInt(-1, "#000000");
-    m_slamCov = AgvInt(-1, "#000000");
-    m_vX = AgvInt(-1, "#000000");
-    m_vY = AgvInt(-1, "#000000");
-    m_vAngle = AgvInt(-1, "#000000");
-    m_agvMode = AgvInt(0, "#000000");
-    m_agvState = AgvInt(0, "#000000");
-    m_light = AgvInt(0, "#000000");
-    m_frontArea = AgvInt(2, "#000000");
-    m_frontLeft = AgvInt(2, "#000000");
-    m_frontRight = AgvInt(2, "#000000");
-    m_backArea = AgvInt(2, "#000000");
-    m_backLeft = AgvInt(2, "#000000");
-    m_backRight = AgvInt(2, "#000000");
-    m_bumpBack = AgvInt(1, "#000000");
-    m_bumpFront = AgvInt(1, "#000000");
-    m_bumpLeft = AgvInt(1, "#000000");
-    m_bumpRight = AgvInt(1, "#000000");
-    m_estopState = AgvInt(1, "#000000");
-    m_goodsState = AgvInt(0, "#000000");
-    m_moveDir = AgvInt(0, "#000000");
-    m_pointId = AgvInt(0, "#000000");
-    m_taskAct = AgvInt(0, "#000000");
-    m_taskParam = AgvInt(0, "#000000");
-    m_taskDescription = AgvString("", "#000000");
-    m_runLength = AgvInt(0, "#000000");
-    m_runTime = AgvInt(0, "#000000");
-
-    // OptionalINFO
-    m_optionalInfo = QJsonObject();
-    m_liftHeight = AgvInt(0, "#000000");
-
-    // AGV_TASK
-    m_taskState = AgvInt(0, "#000000");
-    m_taskId = AgvString("NULL", "#000000");
-    m_taskStartId = AgvInt(0, "#000000");
-    m_taskStartX = AgvInt(0, "#000000");
-    m_taskStartY = AgvInt(0, "#000000");
-    m_taskEndId = AgvInt(0, "#000000");
-    m_taskEndX = AgvInt(0, "#000000");
-    m_taskEndY = AgvInt(0, "#000000");
-    m_pathStartId = AgvInt(0, "#000000");
-    m_pathStartX = AgvInt(0, "#000000");
-    m_pathStartY = AgvInt(0, "#000000");
-    m_pathEndId = AgvInt(0, "#000000");
-    m_pathEndX = AgvInt(0, "#000000");
-    m_pathEndY = AgvInt(0, "#000000");
-    m_taskErr = AgvString("NULL", "#000000");
+    // AgvInfo / OptionalINFO / AGV_TASK
+    m_work = AgvSnapshot::initial();
 
     // TOUCH_STATE
     m_pageControl.store(false);
@@ -163,537 +102,35 @@ void AgvData::initData()
     m_music.store(0); // 喇叭操作，0无，1切歌，2音量+，3音量-
 }
 
-void AgvData::initParsers()
-{
-    // AgvInfo
-    m_agvInfoParsers["AGV_Err_Msg"] = [this](const QJsonObject &data)
-    {
-        m_agvErr = parseAttr<QString>(data, "AGV_Err_Msg");
-    };
-    m_agvInfoParsers["Xin1"] = [this](const QJsonObject &data)
-    {
-        m_xin1 = parseAttr<int>(data, "Xin1");
-    };
-    m_agvInfoParsers["Xin2"] = [this](const QJsonObject &data)
-    {
-        m_xin2 = parseAttr<int>(data, "Xin2");
-    };
-    m_agvInfoParsers["Xin3"] = [this](const QJsonObject &data)
-    {
-        m_xin3 = parseAttr<int>(data, "Xin3");
-    };
-    m_agvInfoParsers["Yout1"] = [this](const QJsonObject &data)
-    {
-        m_yout1 = parseAttr<int>(data, "Yout1");
-    };
-    m_agvInfoParsers["Yout2"] = [this](const QJsonObject &data)
-    {
-        m_yout2 = parseAttr<int>(data, "Yout2");
-    };
-    m_agvInfoParsers["Yout3"] = [this](const QJsonObject &data)
-    {
-        m_yout3 = parseAttr<int>(data, "Yout3");
-    };
-    m_agvInfoParsers["agv_id"] = [this](const QJsonObject &data)
-    {
-        m_agvId = parseAttr<int>(data, "agv_id");
-    };
-    m_agvInfoParsers["agv_name"] = [this](const QJsonObject &data)
-    {
-        m_agvName = parseAttr<QString>(data, "agv_name");
-    };
-    m_agvInfoParsers["battery"] = [this](const QJsonObject &data)
-    {
-        m_battery = parseAttr<int>(data, "battery");
-    };
-    m_agvInfoParsers["map_id"] = [this](const QJsonObject &data)
-    {
-        m_mapId = parseAttr<int>(data, "map_id");
-    };
-    m_agvInfoParsers["slam_x"] = [this](const QJsonObject &data)
-    {
-        m_slamX = parseAttr<int>(data, "slam_x");
-    };
-    m_agvInfoParsers["slam_y"] = [this](const QJsonObject &data)
-    {
-        m_slamY = parseAttr<int>(data, "slam_y");
-    };
-    m_agvInfoParsers["slam_angle"] = [this](const QJsonObject &data)
-    {
-        m_slamAngle = parseAttr<int>(data, "slam_angle");
-    };
-    m_agvInfoParsers["slam_cov"] = [this](const QJsonObject &data)
-    {
-        m_slamCov = parseAttr<int>(data, "slam_cov");
-    };
-    m_agvInfoParsers["v_x"] = [this](const QJsonObject &data)
-    {
-        m_vX = parseAttr<int>(data, "v_x");
-    };
-    m_agvInfoParsers["v_y"] = [this](const QJsonObject &data)
-    {
-        m_vY = parseAttr<int>(data, "v_y");
-    };
-    m_agvInfoParsers["v_angle"] = [this](const QJsonObject &data)
-    {
-        m_vAngle = parseAttr<int>(data, "v_angle");
-    };
-    m_agvInfoParsers["agv_mode"] = [this](const QJsonObject &data)
-    {
-        m_agvMode = parseAttr<int>(data, "agv_mode");
-    };
-    m_agvInfoParsers["agv_state"] = [this](const QJsonObject &data)
-    {
-        m_agvState = parseAttr<int>(data, "agv_state");
-    };
-    m_agvInfoParsers["light"] = [this](const QJsonObject &data)
-    {
-        m_light = parseAttr<int>(data, "light");
-    };
-    m_agvInfoParsers["front_area"] = [this](const QJsonObject &data)
-    {
-        m_frontArea = parseAttr<int>(data, "front_area");
-    };
-    m_agvInfoParsers["front_left"] = [this](const QJsonObject &data)
-    {
-        m_frontLeft = parseAttr<int>(data, "front_left");
-    };
-    m_agvInfoParsers["front_right"] = [this](const QJsonObject &data)
-    {
-        m_frontRight = parseAttr<int>(data, "front_right");
-    };
-    m_agvInfoParsers["back_area"] = [this](const QJsonObject &data)
-    {
-        m_backArea = parseAttr<int>(data, "back_area");
-    };
-    m_agvInfoParsers["back_left"] = [this](const QJsonObject &data)
-    {
-        m_backLeft = parseAttr<int>(data, "back_left");
-    };
-    m_agvInfoParsers["back_right"] = [this](const QJsonObject &data)
-    {
-        m_backRight = parseAttr<int>(data, "back_right");
-    };
-    m_agvInfoParsers["bump_back"] = [this](const QJsonObject &data)
-    {
-        m_bumpBack = parseAttr<int>(data, "bump_back");
-    };
-    m_agvInfoParsers["bump_front"] = [this](const QJsonObject &data)
-    {
-        m_bumpFront = parseAttr<int>(data, "bump_front");
-    };
-    m_agvInfoParsers["bump_left"] = [this](const QJsonObject &data)
-    {
-        m_bumpLeft = parseAttr<int>(data, "bump_left");
-    };
-    m_agvInfoParsers["bump_right"] = [this](const QJsonObject &data)
-    {
-        m_bumpRight = parseAttr<int>(data, "bump_right");
-    };
-    m_agvInfoParsers["estop_state"] = [this](const QJsonObject &data)
-    {
-        m_estopState = parseAttr<int>(data, "estop_state");
-    };
-    m_agvInfoParsers["goods_state"] = [this](const QJsonObject &data)
-    {
-        m_goodsState = parseAttr<int>(data, "goods_state");
-    };
-    m_agvInfoParsers["move_dir"] = [this](const QJsonObject &data)
-    {
-        m_moveDir = parseAttr<int>(data, "move_dir");
-    };
-    m_agvInfoParsers["point_id"] = [this](const QJsonObject &data)
-    {
-        m_pointId = parseAttr<int>(data, "point_id");
-    };
-    m_agvInfoParsers["task_act"] = [this](const QJsonObject &data)
-    {
-        m_taskAct = parseAttr<int>(data, "task_act");
-    };
-    m_agvInfoParsers["task_param"] = [this](const QJsonObject &data)
-    {
-        m_taskParam = parseAttr<int>(data, "task_param");
-    };
-    m_agvInfoParsers["task_description"] = [this](const QJsonObject &data)
-    {
-        m_taskDescription = parseAttr<QString>(data, "task_description");
-    };
-    m_agvInfoParsers["run_length"] = [this](const QJsonObject &data)
-    {
-        m_runLength = parseAttr<int>(data, "run_length");
-    };
-    m_agvInfoParsers["run_time"] = [this](const QJsonObject &data)
-    {
-        m_runTime = parseAttr<int>(data, "run_time");
-    };
-
-    // OptionalINFO
-    m_optionalInfoParsers["lift_height"] = [this](const QJsonObject &data)
-    {
-        m_liftHeight = parseAttr<int>(data, "lift_height");
-    };
-
-    // AGV_TASK
-    m_agvTaskParsers["task_state"] = [this](const QJsonObject &data)
-    {
-        m_taskState = parseAttr<int>(data, "task_state");
-    };
-    m_agvTaskParsers["task_id"] = [this](const QJsonObject &data)
-    {
-        m_taskId = parseAttr<QString>(data, "task_id");
-    };
-    m_agvTaskParsers["task_start_id"] = [this](const QJsonObject &data)
-    {
-        m_taskStartId = parseAttr<int>(data, "task_start_id");
-    };
-    m_agvTaskParsers["task_start_x"] = [this](const QJsonObject &data)
-    {
-        m_taskStartX = parseAttr<int>(data, "task_start_x");
-    };
-    m_agvTaskParsers["task_start_y"] = [this](const QJsonObject &data)
-    {
-        m_taskStartY = parseAttr<int>(data, "task_start_y");
-    };
-    m_agvTaskParsers["task_end_id"] = [this](const QJsonObject &data)
-    {
-        m_taskEndId = parseAttr<int>(data, "task_end_id");
-    };
-    m_agvTaskParsers["task_end_x"] = [this](const QJsonObject &data)
-    {
-        m_taskEndX = parseAttr<int>(data, "task_end_x");
-    };
-    m_agvTaskParsers["task_end_y"] = [this](const QJsonObject &data)
-    {
-        m_taskEndY = parseAttr<int>(data, "task_end_y");
-    };
-    m_agvTaskParsers["path_start_id"] = [this](const QJsonObject &data)
-    {
-        m_pathStartId = parseAttr<int>(data, "path_start_id");
-    };
-    m_agvTaskParsers["path_start_x"] = [this](const QJsonObject &data)
-    {
-        m_pathStartX = parseAttr<int>(data, "path_start_x");
-    };
-    m_agvTaskParsers["path_start_y"] = [this](const QJsonObject &data)
-    {
-        m_pathStartY = parseAttr<int>(data, "path_start_y");
-    };
-    m_agvTaskParsers["path_end_id"] = [this](const QJsonObject &data)
-    {
-        m_pathEndId = parseAttr<int>(data, "path_end_id");
-    };
-    m_agvTaskParsers["path_end_x"] = [this](const QJsonObject &data)
-    {
-        m_pathEndX = parseAttr<int>(data, "path_end_x");
-    };
-    m_agvTaskParsers["path_end_y"] = [this](const QJsonObject &data)
-    {
-        m_pathEndY = parseAttr<int>(data, "path_end_y");
-    };
-    m_agvTaskParsers["TASK_Err_Msg"] = [this](const QJsonObject &data)
-    {
-        m_taskErr = parseAttr<QString>(data, "TASK_Err_Msg");
-    };
-}
-
-// -- Getter --
-// AGVInfo
-AgvString AgvData::agvErr() const
-{
-    QReadLocker lockeer(&m_lock);
-    return m_agvErr;
-}
-
-AgvInt AgvData::agvXin1() const
-{
-    QReadLocker lockeer(&m_lock);
-    return m_xin1;
-}
-
-AgvInt AgvData::agvXin2() const
-{
-    QReadLocker lockeer(&m_lock);
-    return m_xin2;
-}
-
-AgvInt AgvData::agvXin3() const
-{
-    QReadLocker lockeer(&m_lock);
-    return m_xin3;
-}
-
-AgvInt AgvData::agvYout1() const
-{
-    QReadLocker lockeer(&m_lock);
-    return m_yout1;
-}
-
-AgvInt AgvData::agvYout2() const
+// -- Snapshot --
+AgvSnapshotPtr AgvData::snapshot() const
 {
-    QReadLocker lockeer(&m_lock);
-    return m_yout2;
+    return std::atomic_load_explicit(&m_snapshot, std::memory_order_acquire);
 }
 
-AgvInt AgvData::agvYout3() const
+// 复制工作副本并整体替换已发布的快照，旧快照在最后一个读者释放后自动析构
+void AgvData::publishSnapshot()
 {
-    QReadLocker lockeer(&m_lock);
-    return m_yout3;
+    AgvSnapshotPtr next = std::make_shared<const AgvSnapshot>(m_work);
+    std::atomic_store_explicit(&m_snapshot, std::move(next), std::memory_order_release);
 }
 
-AgvInt AgvData::agvId() const
-{
-    QReadLocker lockeer(&m_lock);
-    return m_agvId;
-}
-AgvString AgvData::agvName() const
-{
-    QReadLocker lockeer(&m_lock);
-    return m_agvName;
-}
-AgvInt AgvData::battery() const
-{
-    QReadLocker lockeer(&m_lock);
-    return m_battery;
-}
-AgvInt AgvData::mapId() const
-{
-    QReadLocker lockeer(&m_lock);
-    return m_mapId;
-}
-AgvInt AgvData::slamX() const
-{
-    QReadLocker lockeer(&m_lock);
-    return m_slamX;
-}
-AgvInt AgvData::slamY() const
-{
-    QReadLocker lockeer(&m_lock);
-    return m_slamY;
-}
-AgvInt AgvData::slamAngle() const
-{
-    QReadLocker lockeer(&m_lock);
-    return m_slamAngle;
-}
-AgvInt AgvData::slamCov() const
-{
-    QReadLocker lockeer(&m_lock);
-    return m_slamCov;
-}
-AgvInt AgvData::vX() const
-{
-    QReadLocker lockeer(&m_lock);
-    return m_vX;
-}
-AgvInt AgvData::vY() const
-{
-    QReadLocker lockeer(&m_lock);
-    return m_vY;
-}
-AgvInt AgvData::vAngle() const
-{
-    QReadLocker lockeer(&m_lock);
-    return m_vAngle;
-}
-AgvInt AgvData::agvMode() const
-{
-    QReadLocker lockeer(&m_lock);
-    return m_agvMode;
-}
-AgvInt AgvData::agvState() const
-{
-    QReadLocker lockeer(&m_lock);
-    return m_agvState;
-}
-AgvInt AgvData::light() const
-{
-    QReadLocker lockeer(&m_lock);
-    return m_light;
-}
-AgvInt AgvData::frontArea() const
-{
-    QReadLocker lockeer(&m_lock);
-    return m_frontArea;
-}
-AgvInt AgvData::frontLeft() const
-{
-    QReadLocker lockeer(&m_lock);
-    return m_frontLeft;
-}
-AgvInt AgvData::frontRight() const
-{
-    QReadLocker lockeer(&m_lock);
-    return m_frontRight;
-}
-AgvInt AgvData::backArea() const
-{
-    QReadLocker lockeer(&m_lock);
-    return m_backArea;
-}
-AgvInt AgvData::backLeft() const
-{
-    QReadLocker lockeer(&m_lock);
-    return m_backLeft;
-}
-AgvInt AgvData::backRight() const
-{
-    QReadLocker lockeer(&m_lock);
-    return m_backRight;
-}
-AgvInt AgvData::bumpBack() const
-{
-    QReadLocker lockeer(&m_lock);
-    return m_bumpBack;
-}
-AgvInt AgvData::bumpFront() const
-{
-    QReadLocker lockeer(&m_lock);
-    return m_bumpFront;
-}
-AgvInt AgvData::bumpLeft() const
-{
-    QReadLocker lockeer(&m_lock);
-    return m_bumpLeft;
-}
-AgvInt AgvData::bumpRight() const
-{
-    QReadLocker lockeer(&m_lock);
-    return m_bumpRight;
-}
-AgvInt AgvData::eStopState() const
-{
-    QReadLocker lockeer(&m_lock);
-    return m_estopState;
-}
-AgvInt AgvData::goodsState() const
-{
-    QReadLocker lockeer(&m_lock);
-    return m_goodsState;
-}
-AgvInt AgvData::moveDir() const
-{
-    QReadLocker lockeer(&m_lock);
-    return m_moveDir;
-}
-AgvInt AgvData::pointId() const
-{
-    QReadLocker lockeer(&m_lock);
-    return m_pointId;
-}
-AgvInt AgvData::taskAct() const
-{
-    QReadLocker lockeer(&m_lock);
-    return m_taskAct;
-}
-AgvInt AgvData::taskParam() const
-{
-    QReadLocker lockeer(&m_lock);
-    return m_taskParam;
-}
-AgvString AgvData::taskDescription() const
-{
-    QReadLocker lockeer(&m_lock);
-    return m_taskDescription;
-}
-AgvInt AgvData::runLength() const
-{
-    QReadLocker lockeer(&m_lock);
-    return m_runLength;
-}
-AgvInt AgvData::runTime() const
-{
-    QReadLocker lockeer(&m_lock);
-    return m_runTime;
-}
+// -- Getter --
+#define AGV_DEFINE_GETTER(type, member, getter, key, init) \
+    type AgvData::getter() const { return snapshot()->member; }
+// AGVInfo
+AGV_INFO_FIELDS(AGV_DEFINE_GETTER)
 
 // OptionalINFO
 QJsonObject AgvData::optionalInfo() const
 {
-    QReadLocker lockeer(&m_lock);
-    return m_optionalInfo;
-}
-AgvInt AgvData::liftHeight() const
-{
-    QReadLocker lockeer(&m_lock);
-    return m_liftHeight;
+    return snapshot()->optionalInfo;
 }
+AGV_OPTIONAL_INFO_FIELDS(AGV_DEFINE_GETTER)
 
 // AGV_TASK
-AgvInt AgvData::taskState() const
-{
-    QReadLocker lockeer(&m_lock);
-    return m_taskState;
-}
-AgvString AgvData::taskId() const
-{
-    QReadLocker lockeer(&m_lock);
-    return m_taskId;
-}
-AgvInt AgvData::taskStartId() const
-{
-    QReadLocker lockeer(&m_lock);
-    return m_taskStartId;
-}
-AgvInt AgvData::taskStartX() const
-{
-    QReadLocker lockeer(&m_lock);
-    return m_taskStartX;
-}
-AgvInt AgvData::taskStartY() const
-{
-    QReadLocker lockeer(&m_lock);
-    return m_taskStartY;
-}
-AgvInt AgvData::taskEndId() const
-{
-    QReadLocker lockeer(&m_lock);
-    return m_taskEndId;
-}
-AgvInt AgvData::taskEndX() const
-{
-    QReadLocker lockeer(&m_lock);
-    return m_taskEndX;
-}
-AgvInt AgvData::taskEndY() const
-{
-    QReadLocker lockeer(&m_lock);
-    return m_taskEndY;
-}
-AgvInt AgvData::pathStartId() const
-{
-    QReadLocker lockeer(&m_lock);
-    return m_pathStartId;
-}
-AgvInt AgvData::pathStartX() const
-{
-    QReadLocker lockeer(&m_lock);
-    return m_pathStartX;
-}
-AgvInt AgvData::pathStartY() const
-{
-    QReadLocker lockeer(&m_lock);
-    return m_pathStartY;
-}
-AgvInt AgvData::pathEndId() const
-{
-    QReadLocker lockeer(&m_lock);
-    return m_pathEndId;
-}
-AgvInt AgvData::pathEndX() const
-{
-    QReadLocker lockeer(&m_lock);
-    return m_pathEndX;
-}
-AgvInt AgvData::pathEndY() const
-{
-    QReadLocker lockeer(&m_lock);
-    return m_pathEndY;
-}
-AgvString AgvData::taskErr() const
-{
-    QReadLocker lockeer(&m_lock);
-    return m_taskErr;
-}
+AGV_TASK_FIELDS(AGV_DEFINE_GETTER)
+#undef AGV_DEFINE_GETTER
 
 // TOUCH_STATE
 bool AgvData::pageControl() const
@@ -759,45 +196,56 @@ int AgvData::music() const
 
 // ----Setter----
 // TOUCH_STATE
+// 只有值真正变化时才通知，CommunicationWsClient 据此立即下发 TOUCH_STATE
 void AgvData::setPageControl(bool value)
 {
-    m_pageControl.store(value);
+    if (m_pageControl.exchange(value) != value)
+        emit touchStateChanged();
 }
 void AgvData::setTaskCancel(bool value)
 {
-    m_taskCancel.store(value);
+    if (m_taskCancel.exchange(value) != value)
+        emit touchStateChanged();
 }
 void AgvData::setTaskStart(bool value)
 {
-    m_taskStart.store(value);
+    if (m_taskStart.exchange(value) != value)
+        emit touchStateChanged();
 }
 void AgvData::setTaskPause(bool value)
 {
-    m_taskPause.store(value);
+    if (m_taskPause.exchange(value) != value)
+        emit touchStateChanged();
 }
 void AgvData::setTaskResume(bool value)
 {
-    m_taskResume.store(value);
+    if (m_taskResume.exchange(value) != value)
+        emit touchStateChanged();
 }
 void AgvData::setChargeCmd(bool value)
 {
-    m_chargeCmd.store(value);
+    if (m_chargeCmd.exchange(value) != value)
+        emit touchStateChanged();
 }
 void AgvData::setManualDir(int value)
 {
-    m_manualDir.store(value);
+    if (m_manualDir.exchange(value) != value)
+        emit touchStateChanged();
 }
 void AgvData::setManualAct(int value)
 {
-    m_manualAct.store(value);
+    if (m_manualAct.exchange(value) != value)
+        emit touchStateChanged();
 }
 void AgvData::setManualVx(int value)
 {
-    m_manualVx.store(value);
+    if (m_manualVx.exchange(value) != value)
+        emit touchStateChanged();
 }
 void AgvData::setManualVy(int value)
 {
-    m_manualVy.store(value);
+    if (m_manualVy.exchange(value) != value)
+        emit touchStateChanged();
 }
 // void AgvData::setManualVth(int value)
 // {
@@ -805,171 +253,237 @@ void AgvData::setManualVy(int value)
 // }
 void AgvData::setIniX(int value)
 {
-    m_iniX.store(value);
+    if (m_iniX.exchange(value) != value)
+        emit touchStateChanged();
 }
 void AgvData::setIniY(int value)
 {
-    m_iniY.store(value);
+    if (m_iniY.exchange(value) != value)
+        emit touchStateChanged();
 }
 void AgvData::setIniW(int value)
 {
-    m_iniW.store(value);
+    if (m_iniW.exchange(value) != value)
+        emit touchStateChanged();
 }
 void AgvData::setMusic(int value)
 {
-    m_music.store(value);
+    if (m_music.exchange(value) != value)
+        emit touchStateChanged();
 }
 
-// 解析 JSON 结构
-bool AgvData::tryParseAgvJson(const QString &jsonStr, QJsonObject &resultObj)
+// parseMsg: 入口函数
+void AgvData::parseMsg(const QString &msg)
 {
-    QJsonParseError parseError;
-    QJsonDocument doc = QJsonDocument::fromJson(jsonStr.toUtf8(), &parseError);
-
-    if (parseError.error != QJsonParseError::NoError)
+    AgvFrame frame;
+    QString error;
+    bool ok;
     {
-        QString jsonParseErr = "AgvData JSON 解析错误:" + parseError.errorString();
-        logger->log(QStringLiteral("AgvData"), spdlog::level::warn, jsonParseErr);
-        return false;
+        // 写者互斥：m_work 只在这里被修改，读者只访问已发布的快照，不会被阻塞
+        QMutexLocker locker(&m_writeMutex);
+        ok = m_decoder.decodeJson(msg, m_work, frame, error);
+        // 流式解析在 Body 中途出错时可能已写入部分字段，同样发布，保证快照与 m_work 一致
+        if (frame.changed != 0)
+            publishSnapshot();
     }
+    handleFrame(ok, frame, error);
+}
 
-    if (!doc.isObject())
+// parseCborMsg: CBOR 二进制帧入口，帧结构与 JSON 相同（Event / Body / IsSucceed ...）
+void AgvData::parseCborMsg(const QByteArray &data)
+{
+    AgvFrame frame;
+    QString error;
+    bool ok;
     {
-        logger->log(QStringLiteral("AgvData"), spdlog::level::warn, QStringLiteral("AgvData 数据格式错误: 不是 JSON 对象"));
-        return false;
+        QMutexLocker locker(&m_writeMutex);
+        ok = m_decoder.decodeCbor(data, m_work, frame, error);
+        if (frame.changed != 0)
+            publishSnapshot();
     }
-
-    resultObj = doc.object();
-    return true;
+    handleFrame(ok, frame, error);
 }
 
-// parseMsg: 入口函数
-void AgvData::parseMsg(const QString &msg)
+// 解码后的处理，JSON 与 CBOR 两种载体共用
+void AgvData::handleFrame(bool ok, const AgvFrame &frame, const QString &error)
 {
-    QJsonObject root;
+    // 一帧处理完成后，仅在有字段变化时合并通知
+    if (frame.changed != 0)
+        notifyFieldsChanged(frame.changed);
 
-    if (!tryParseAgvJson(msg, root))
+    if (!ok)
     {
-        logger->log(QStringLiteral("AgvData"), spdlog::level::warn, QStringLiteral("parseMsg 发生错误，非法的 json 结构"));
-        return; // 校验失败
-    }
-
-    // 提取 Event 类型
-    if (!root.value("Event").isString())
-    {
-        logger->log(QStringLiteral("AgvData"), spdlog::level::warn, QStringLiteral("AgvData 缺少 Event 字段 或者 Event 字段不是 String 类型"));
+        logger->log(QStringLiteral("AgvData"), spdlog::level::warn, QStringLiteral("parseMsg 发生错误，%1").arg(error));
         return;
     }
-    QString event = root.value("Event").toString();
-
-    // 提取 Body 数据实体
-    // 注意：Body 可能是 Object，也可能是 Array，这里假设你的业务数据主要是 Object
-    if (!root.value("Body").isObject())
+    if (!frame.warning.isEmpty())
     {
-        logger->log(QStringLiteral("AgvData"), spdlog::level::warn, QStringLiteral("AgvData 缺少 Body 字段 或者 Body 字段不是 JSON 对象"));
-        return;
+        logger->log(QStringLiteral("AgvData"), spdlog::level::warn, frame.warning);
     }
-    QJsonObject body = root.value("Body").toObject();
 
     // 根据 Event 分发处理
-    if (event == "AGV_STATE")
+    if (frame.event == QLatin1String("AGV_STATE") || frame.event == QLatin1String("AGV_TASK"))
+    {
+        // 轮询应答回显请求的数据戳，用于统计往返时延
+        emit responseStampReceived(frame.event, frame.dataStamps);
+    }
+    else if (frame.event == QLatin1String("SUBSCRIBE_ACK"))
     {
-        parseAgvState(body);
+        // 订阅应答只是链路控制消息，不写入状态
+        emit subscribeAckReceived(frame.isSucceed, static_cast<int>(frame.body.value(QLatin1String("RateMs")).toDouble()));
     }
-    else if (event == "AGV_TASK")
+    else if (frame.event == QLatin1String("SET_ENCODING_ACK"))
     {
-        handleAgvTask(body);
+        // 编码协商应答，同样不写入状态
+        emit encodingAckReceived(frame.isSucceed, frame.body.value(QLatin1String("Encoding")).toString());
     }
     else
     {
-        logger->log(QStringLiteral("AgvData"), spdlog::level::warn, QStringLiteral("忽略未知的事件类型: %1").arg(event));
+        logger->log(QStringLiteral("AgvData"), spdlog::level::warn, QStringLiteral("忽略未知的事件类型: %1").arg(frame.event));
     }
 }
 
-// 解析 AgvState，包含 AGVInfo、OptionalINFO
-void AgvData::parseAgvState(const QJsonObject &data)
+// 合并字段变化通知：主线程尚未处理上一条通知时只累加位掩码，不再投递新通知
+// 界面读取的始终是最新快照，最多落后一帧
+void AgvData::notifyFieldsChanged(quint64 mask)
 {
-    // 解析 AGVInfo
-    // 校验字段是否存在
-    if (!data.value("AGVInfo").isObject())
+    m_stateFrames.fetch_add(1, std::memory_order_relaxed);
+    if (m_notifyMask.fetch_or(mask, std::memory_order_acq_rel) != 0)
     {
-        logger->log(QStringLiteral("AgvData"), spdlog::level::warn, QStringLiteral("AGV_STATE 错误: 缺少 AGVInfo 字段或者 AGVInfo 不是 JSON 对象"));
-        return;
-    }
-
-    // 安全转换为 QJsonObject
-    QJsonObject agvInfo = data.value("AGVInfo").toObject();
-    handleAgvInfo(agvInfo);
-
-    // 解析 OptionalINFO
-    // 校验字段是否存在
-    if (!data.value("OptionalINFO").isObject())
-    {
-        logger->log(QStringLiteral("AgvData"), spdlog::level::warn, QStringLiteral("AGV_STATE 错误: 缺少 OptionalINFO 字段或者 OptionalINFO 不是 JSON 对象"));
+        m_stateConflated.fetch_add(1, std::memory_order_relaxed);
         return;
     }
+    QMetaObject::invokeMethod(this, &AgvData::deliverFieldsChanged, Qt::QueuedConnection);
+}
 
-    // 安全转换为 QJsonObject
-    QJsonObject optionalInfo = data.value("OptionalINFO").toObject();
-    handleOptionalInfo(optionalInfo);
+void AgvData::deliverFieldsChanged()
+{
+    const quint64 mask = m_notifyMask.exchange(0, std::memory_order_acq_rel);
+    if (mask != 0)
+        emit fieldsChanged(mask);
 }
 
-// 处理 AGVInfo
-void AgvData::handleAgvInfo(const QJsonObject &data)
+// 点云与 /agv_state 在 I/O 线程中投递到邮箱，主线程只取最新一帧
+void AgvData::onPointCloudReceived(PointCloudBufferPtr cloud)
 {
-    // 加锁
-    QWriteLocker locker(&m_lock);
+    if (m_pointCloudBox.post(std::move(cloud)))
+        QMetaObject::invokeMethod(this, &AgvData::deliverPointCloud, Qt::QueuedConnection);
+}
 
-    m_optionalInfo = data;
+void AgvData::setPointCloudViewScale(double pixelsPerMeter)
+{
+    if (PointCloudDecimator::setViewScale(pixelsPerMeter))
+        emit pointCloudZoomChanged();
+}
 
-    // 遍历 JSON 中的所有 key
-    for (auto it = data.constBegin(); it != data.constEnd(); ++it)
+void AgvData::setRosViewActive(bool active)
+{
+    if (m_rosViewActive == active)
+        return;
+    m_rosViewActive = active;
+    // 页面隐藏后点云与 /agv_state 按配置退订或节流，尚未送达的帧已经过期，不再交给界面
+    if (!active)
     {
-        QString key = it.key();
-
-        // 如果这个 key 在我们的映射表中注册过，就执行对应的解析函数
-        if (m_agvInfoParsers.contains(key))
-        {
-            m_agvInfoParsers[key](data);
-        }
+        m_pointCloudBox.discard();
+        m_rosStateBox.discard();
     }
+    emit rosViewActiveChanged(active);
+}
 
+void AgvData::deliverPointCloud()
+{
+    PointCloudBufferPtr cloud;
+    if (m_pointCloudBox.take(cloud))
+        emit pointCloudDataReady(cloud);
 }
 
-// 处理 OptionalINFO
-void AgvData::handleOptionalInfo(const QJsonObject &data)
+void AgvData::onRosAgvStateReceived(QVector<int> state)
 {
-    // 加锁
-    QWriteLocker locker(&m_lock);
+    if (m_rosStateBox.post(std::move(state)))
+        QMetaObject::invokeMethod(this, &AgvData::deliverRosAgvState, Qt::QueuedConnection);
+}
 
-    m_optionalInfo = data;
+void AgvData::deliverRosAgvState()
+{
+    QVector<int> state;
+    if (m_rosStateBox.take(state))
+        emit agvStateChanged(state);
+}
 
-    // 遍历 JSON 中的所有 key
-    for (auto it = data.constBegin(); it != data.constEnd(); ++it)
-    {
-        QString key = it.key();
+AgvMailboxStats AgvData::mailboxStats() const
+{
+    AgvMailboxStats stats;
+    stats.stateFrames = m_stateFrames.load(std::memory_order_relaxed);
+    stats.stateConflated = m_stateConflated.load(std::memory_order_relaxed);
+    stats.pointCloudFrames = m_pointCloudBox.posted();
+    stats.pointCloudConflated = m_pointCloudBox.conflated();
+    stats.pointCloudDropped = m_pointCloudBox.dropped();
+    stats.rosStateFrames = m_rosStateBox.posted();
+    stats.rosStateConflated = m_rosStateBox.conflated();
+    stats.rosStateDropped = m_rosStateBox.dropped();
+    return stats;
+}
+
+// 定期检查合并与丢弃计数，有新增时记录日志，便于现场判断界面是否处理不及时
+void AgvData::reportMailboxStats()
+{
+    const AgvMailboxStats stats = mailboxStats();
+    const quint64 state = stats.stateConflated - m_lastReported.stateConflated;
+    const quint64 cloud = stats.pointCloudConflated - m_lastReported.pointCloudConflated;
+    const quint64 ros = stats.rosStateConflated - m_lastReported.rosStateConflated;
+    const quint64 cloudDropped = stats.pointCloudDropped - m_lastReported.pointCloudDropped;
+    const quint64 rosDropped = stats.rosStateDropped - m_lastReported.rosStateDropped;
+    m_lastReported = stats;
 
-        if (m_optionalInfoParsers.contains(key))
-        {
-            m_optionalInfoParsers[key](data);
-        }
+    if (cloudDropped + rosDropped > 0)
+    {
+        logger->log(QStringLiteral("AgvData"), spdlog::level::info,
+                    QStringLiteral("最近 %1 秒监控页面隐藏时丢弃了未送达的点云 %2 帧、/agv_state %3 帧")
+                        .arg(MAILBOX_REPORT_MS / 1000)
+                        .arg(cloudDropped)
+                        .arg(rosDropped));
     }
+
+    if (state + cloud + ros == 0)
+        return;
+
+    logger->log(QStringLiteral("AgvData"), spdlog::level::warn,
+                QStringLiteral("界面处理不及时，最近 %1 秒合并了 AGV_STATE %2 帧、点云 %3 帧、/agv_state %4 帧")
+                    .arg(MAILBOX_REPORT_MS / 1000)
+                    .arg(state)
+                    .arg(cloud)
+                    .arg(ros));
 }
 
-// 处理 AGV_TASK
-void AgvData::handleAgvTask(const QJsonObject &data)
+AgvDecodeStats AgvData::decodeStats() const
 {
-    // 加锁
-    QWriteLocker locker(&m_lock);
+    // 计数为原子变量，不需要持有 m_writeMutex
+    return m_decoder.stats();
+}
 
-    // 遍历 JSON 中的所有 key
-    for (auto it = data.constBegin(); it != data.constEnd(); ++it)
-    {
-        QString key = it.key();
+// 定期输出各段落因原文未变化而跳过解析的比例，车辆静止时应接近 100%
+void AgvData::reportDecodeStats()
+{
+    const AgvDecodeStats stats = decodeStats();
+    const AgvDecodeStats &last = m_lastDecodeReported;
+    const quint64 infoTotal = stats.agvInfoSections - last.agvInfoSections;
+    const quint64 optionalTotal = stats.optionalInfoSections - last.optionalInfoSections;
+    const quint64 taskTotal = stats.agvTaskSections - last.agvTaskSections;
 
-        if (m_agvTaskParsers.contains(key))
-        {
-            m_agvTaskParsers[key](data);
-        }
+    auto rate = [](quint64 skipped, quint64 total)
+    { return total == 0 ? QStringLiteral("-") : QStringLiteral("%1%").arg(100.0 * skipped / total, 0, 'f', 1); };
+
+    if (infoTotal + optionalTotal + taskTotal != 0)
+    {
+        logger->log(QStringLiteral("AgvData"), spdlog::level::info,
+                    QStringLiteral("最近 %1 秒未变化段落跳过率：AGVInfo %2（%3 段），OptionalINFO %4（%5 段），AGV_TASK %6（%7 段）")
+                        .arg(DECODE_REPORT_MS / 1000)
+                        .arg(rate(stats.agvInfoSkipped - last.agvInfoSkipped, infoTotal))
+                        .arg(infoTotal)
+                        .arg(rate(stats.optionalInfoSkipped - last.optionalInfoSkipped, optionalTotal))
+                        .arg(optionalTotal)
+                        .arg(rate(stats.agvTaskSkipped - last.agvTaskSkipped, taskTotal))
+                        .arg(taskTotal));
     }
-}
\ No newline at end of file
+    m_lastDecodeReported = stats;
+}
@@ -0,0 +1,857 @@
+#include "AgvFrameDecoder.h"
+#include "AgvJsonReader.h"
+#include <QJsonDocument>
+#include <QJsonParseError>
+#include <QCborValue>
+#include <QCborMap>
+#include <QLocale>
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+namespace
+{
+    // 字段类型
+    enum class AgvFieldKind : quint8
+    {
+        Int,
+        String
+    };
+
+    // 字段描述：协议键名 -> AgvSnapshot 中的成员
+    struct AgvFieldDesc
+    {
+        const char *key = nullptr;
+        int keyLen = 0;
+        AgvFieldKind kind = AgvFieldKind::Int;
+        quint64 bit = 0; // 在 fieldsChanged 位掩码中对应的位
+        AgvInt AgvSnapshot::*intMember = nullptr;
+        AgvString AgvSnapshot::*strMember = nullptr;
+    };
+
+    template <int N>
+    constexpr AgvFieldDesc makeFieldDesc(const char (&key)[N], AgvInt AgvSnapshot::*member, AgvField field)
+    {
+        AgvFieldDesc desc;
+        desc.key = key;
+        desc.keyLen = N - 1;
+        desc.kind = AgvFieldKind::Int;
+        desc.bit = agvFieldBit(field);
+        desc.intMember = member;
+        return desc;
+    }
+
+    template <int N>
+    constexpr AgvFieldDesc makeFieldDesc(const char (&key)[N], AgvString AgvSnapshot::*member, AgvField field)
+    {
+        AgvFieldDesc desc;
+        desc.key = key;
+        desc.keyLen = N - 1;
+        desc.kind = AgvFieldKind::String;
+        desc.bit = agvFieldBit(field);
+        desc.strMember = member;
+        return desc;
+    }
+
+    // 按字节比较键名，与 QString::compare(QLatin1String) 对 ASCII 键的排序结果一致
+    constexpr int compareKey(const char *a, const char *b)
+    {
+        while (*a && *a == *b)
+        {
+            ++a;
+            ++b;
+        }
+        return static_cast<unsigned char>(*a) - static_cast<unsigned char>(*b);
+    }
+
+    // 运行时键名（UTF-16）与字段表键名（ASCII）比较，排序规则与上面一致
+    int compareKey(QStringView a, const char *b, int bLen)
+    {
+        const int n = qMin(static_cast<int>(a.size()), bLen);
+        for (int i = 0; i < n; ++i)
+        {
+            const int diff = static_cast<int>(a[i].unicode()) - static_cast<unsigned char>(b[i]);
+            if (diff != 0)
+                return diff;
+        }
+        return static_cast<int>(a.size()) - bLen;
+    }
+
+    // 编译期按键名排序，运行时用二分查找分发
+    template <std::size_t N>
+    constexpr std::array<AgvFieldDesc, N> sortFieldTable(const AgvFieldDesc (&raw)[N])
+    {
+        std::array<AgvFieldDesc, N> table{};
+        for (std::size_t i = 0; i < N; ++i)
+        {
+            AgvFieldDesc cur = raw[i];
+            std::size_t j = i;
+            while (j > 0 && compareKey(table[j - 1].key, cur.key) > 0)
+            {
+                table[j] = table[j - 1];
+                --j;
+            }
+            table[j] = cur;
+        }
+        return table;
+    }
+
+    // 排序后相邻键名必须严格递增，否则说明字段表中存在重复键
+    template <std::size_t N>
+    constexpr bool isStrictlySorted(const std::array<AgvFieldDesc, N> &table)
+    {
+        for (std::size_t i = 1; i < N; ++i)
+        {
+            if (compareKey(table[i - 1].key, table[i].key) >= 0)
+                return false;
+        }
+        return true;
+    }
+
+#define AGV_FIELD_DESC(type, member, getter, key, init) makeFieldDesc(key, &AgvSnapshot::member, AgvField::member),
+    constexpr AgvFieldDesc kAgvInfoRaw[] = {AGV_INFO_FIELDS(AGV_FIELD_DESC)};
+    constexpr AgvFieldDesc kOptionalInfoRaw[] = {AGV_OPTIONAL_INFO_FIELDS(AGV_FIELD_DESC)};
+    constexpr AgvFieldDesc kAgvTaskRaw[] = {AGV_TASK_FIELDS(AGV_FIELD_DESC)};
+#undef AGV_FIELD_DESC
+
+    constexpr auto kAgvInfoTable = sortFieldTable(kAgvInfoRaw);
+    constexpr auto kOptionalInfoTable = sortFieldTable(kOptionalInfoRaw);
+    constexpr auto kAgvTaskTable = sortFieldTable(kAgvTaskRaw);
+
+    static_assert(isStrictlySorted(kAgvInfoTable), "AGV_INFO_FIELDS 中存在重复的协议键名");
+    static_assert(isStrictlySorted(kOptionalInfoTable), "AGV_OPTIONAL_INFO_FIELDS 中存在重复的协议键名");
+    static_assert(isStrictlySorted(kAgvTaskTable), "AGV_TASK_FIELDS 中存在重复的协议键名");
+
+    // 二分查找键名对应的字段描述，未注册的键返回 nullptr
+    template <std::size_t N>
+    const AgvFieldDesc *findField(const std::array<AgvFieldDesc, N> &table, QStringView key)
+    {
+        auto it = std::lower_bound(table.begin(), table.end(), key,
+                                   [](const AgvFieldDesc &desc, QStringView k)
+                                   { return compareKey(k, desc.key, desc.keyLen) > 0; });
+        if (it != table.end() && compareKey(key, it->key, it->keyLen) == 0)
+            return &*it;
+        return nullptr;
+    }
+
+    // 类型化取值，不经过 QVariant；转换规则与原先 QVariant::value<T>() 保持一致
+    // （浮点数四舍五入取整，与 Qt5 QVariant 内部的 qRound64 相同，例如 80.5 -> 81、-0.6 -> -1）
+    int extractInt(const QJsonValue &val)
+    {
+        switch (val.type())
+        {
+        case QJsonValue::Double:
+            return qRound(val.toDouble());
+        case QJsonValue::Bool:
+            return val.toBool() ? 1 : 0;
+        case QJsonValue::String:
+            return val.toString().toInt();
+        default:
+            return 0;
+        }
+    }
+
+    QString extractString(const QJsonValue &val)
+    {
+        switch (val.type())
+        {
+        case QJsonValue::String:
+            return val.toString();
+        case QJsonValue::Double:
+            return QString::number(val.toDouble(), 'g', QLocale::FloatingPointShortest);
+        case QJsonValue::Bool:
+            return val.toBool() ? QStringLiteral("true") : QStringLiteral("false");
+        default:
+            return QString();
+        }
+    }
+
+    // CBOR 二进制帧的取值，转换规则与 JSON 版本一致（CBOR 额外区分整数与浮点数）
+    int extractInt(const QCborValue &val)
+    {
+        if (val.isInteger())
+            return static_cast<int>(val.toInteger());
+        if (val.isDouble())
+            return qRound(val.toDouble());
+        if (val.isBool())
+            return val.toBool() ? 1 : 0;
+        if (val.isString())
+            return val.toString().toInt();
+        return 0;
+    }
+
+    QString extractString(const QCborValue &val)
+    {
+        if (val.isString())
+            return val.toString();
+        if (val.isInteger())
+            return QString::number(val.toInteger());
+        if (val.isDouble())
+            return QString::number(val.toDouble(), 'g', QLocale::FloatingPointShortest);
+        if (val.isBool())
+            return val.toBool() ? QStringLiteral("true") : QStringLiteral("false");
+        return QString();
+    }
+
+    // 流式版本的取值，转换规则同上；读到的字符串与当前值相同时沿用原有 QString，不产生分配
+    bool readValue(AgvJsonReader &reader, const int &, int &out)
+    {
+        switch (reader.peekType())
+        {
+        case AgvJsonReader::Type::Number:
+        {
+            double d = 0;
+            if (!reader.readNumber(d))
+                return false;
+            out = qRound(d);
+            return true;
+        }
+        case AgvJsonReader::Type::Bool:
+        {
+            bool b = false;
+            if (!reader.readBool(b))
+                return false;
+            out = b ? 1 : 0;
+            return true;
+        }
+        case AgvJsonReader::Type::String:
+        {
+            QStringView s;
+            if (!reader.readString(s))
+                return false;
+            out = s.toString().toInt();
+            return true;
+        }
+        default:
+            out = 0;
+            return reader.skipValue();
+        }
+    }
+
+    bool readValue(AgvJsonReader &reader, const QString &cur, QString &out)
+    {
+        switch (reader.peekType())
+        {
+        case AgvJsonReader::Type::String:
+        {
+            QStringView s;
+            if (!reader.readString(s))
+                return false;
+            out = (s == QStringView(cur)) ? cur : s.toString();
+            return true;
+        }
+        case AgvJsonReader::Type::Number:
+        {
+            double d = 0;
+            if (!reader.readNumber(d))
+                return false;
+            out = QString::number(d, 'g', QLocale::FloatingPointShortest);
+            return true;
+        }
+        case AgvJsonReader::Type::Bool:
+        {
+            bool b = false;
+            if (!reader.readBool(b))
+                return false;
+            out = b ? QStringLiteral("true") : QStringLiteral("false");
+            return true;
+        }
+        default:
+            out = QString();
+            return reader.skipValue();
+        }
+    }
+
+    // 颜色驻留为调色板编号，缺失或不是字符串时为默认黑
+    template <typename Value>
+    quint16 internColor(const Value &val)
+    {
+        return val.isString() ? AgvColorPalette::instance()->intern(val.toString()) : AgvColorPalette::DEFAULT_COLOR;
+    }
+
+    // 读取一个属性对象 { "value": ..., "color": "..." }
+    // 不是对象时与 DOM 版本一致，取空值和默认颜色
+    template <typename T>
+    bool readAttr(AgvJsonReader &reader, const AgvAttribute<T> &cur, AgvAttribute<T> &out)
+    {
+        out.value = T();
+        out.color = AgvColorPalette::DEFAULT_COLOR;
+
+        if (reader.peekType() != AgvJsonReader::Type::Object)
+            return reader.skipValue();
+
+        reader.beginObject();
+        QStringView key;
+        while (reader.nextKey(key))
+        {
+            if (key == QLatin1String("value"))
+            {
+                if (!readValue(reader, cur.value, out.value))
+                    return false;
+            }
+            else if (key == QLatin1String("color") && reader.peekType() == AgvJsonReader::Type::String)
+            {
+                QStringView color;
+                if (!reader.readString(color))
+                    return false;
+                out.color = AgvColorPalette::instance()->intern(color);
+            }
+            else if (!reader.skipValue())
+            {
+                return false;
+            }
+        }
+        return !reader.hasError();
+    }
+
+    // 统一 JSON 与 CBOR 两种载体的键名和属性对象访问方式，供 applyFields 共用
+    QString entryKey(const QJsonObject::const_iterator &it) { return it.key(); }
+    QString entryKey(const QCborMap::ConstIterator &it) { return it.key().toString(); }
+    QJsonObject entryObject(const QJsonObject::const_iterator &it) { return it.value().toObject(); }
+    QCborMap entryObject(const QCborMap::ConstIterator &it) { return it.value().toMap(); }
+
+    // 值发生变化时写入，并返回本次发生变化的字段位掩码
+    template <typename T>
+    quint64 assignIfChanged(AgvAttribute<T> &dst, AgvAttribute<T> &&src, quint64 bit)
+    {
+        if (!(dst != src))
+            return 0;
+        dst = std::move(src);
+        return bit;
+    }
+
+    // 遍历 JSON（或 CBOR）中的所有 key，命中字段表的写入快照对应成员
+    // 假设 json 格式为: "battery": { "value": 80.5, "color": "#00FF00" }
+    template <std::size_t N, typename Map>
+    quint64 applyFields(AgvSnapshot &dst, const std::array<AgvFieldDesc, N> &table, const Map &data)
+    {
+        quint64 changed = 0;
+        for (auto it = data.constBegin(); it != data.constEnd(); ++it)
+        {
+            const AgvFieldDesc *desc = findField(table, entryKey(it));
+            if (!desc)
+                continue;
+
+            const auto obj = entryObject(it);
+            const auto val = obj.value(QLatin1String("value"));
+            const quint16 col = internColor(obj.value(QLatin1String("color")));
+
+            if (desc->kind == AgvFieldKind::Int)
+                changed |= assignIfChanged(dst.*(desc->intMember), AgvInt(extractInt(val), col), desc->bit);
+            else
+                changed |= assignIfChanged(dst.*(desc->strMember), AgvString(extractString(val), col), desc->bit);
+        }
+        return changed;
+    }
+
+    // 流式版本：reader 位于对象起始 '{'，边读边写入，结束后位于对象之后
+    template <std::size_t N>
+    bool applyFields(AgvSnapshot &dst, const std::array<AgvFieldDesc, N> &table, AgvJsonReader &reader, quint64 &changed)
+    {
+        if (!reader.beginObject())
+            return false;
+
+        QStringView key;
+        while (reader.nextKey(key))
+        {
+            const AgvFieldDesc *desc = findField(table, key);
+            if (!desc)
+            {
+                if (!reader.skipValue())
+                    return false;
+                continue;
+            }
+
+            if (desc->kind == AgvFieldKind::Int)
+            {
+                AgvInt &field = dst.*(desc->intMember);
+                AgvInt next;
+                if (!readAttr(reader, field, next))
+                    return false;
+                changed |= assignIfChanged(field, std::move(next), desc->bit);
+            }
+            else
+            {
+                AgvString &field = dst.*(desc->strMember);
+                AgvString next;
+                if (!readAttr(reader, field, next))
+                    return false;
+                changed |= assignIfChanged(field, std::move(next), desc->bit);
+            }
+        }
+        return !reader.hasError();
+    }
+
+    // OptionalINFO 同时以原始对象保存在快照中，供 OptionalInfoWidget 遍历显示
+    quint64 applyOptionalInfo(AgvSnapshot &dst, const QJsonObject &data)
+    {
+        quint64 changed = 0;
+        if (dst.optionalInfo != data)
+        {
+            dst.optionalInfo = data;
+            changed |= agvFieldBit(AgvField::optionalInfo);
+        }
+        return changed | applyFields(dst, kOptionalInfoTable, data);
+    }
+
+    // XXH64（种子为 0），用于比较段落原文是否与上一帧相同
+    constexpr quint64 XXH_P1 = 11400714785074694791ULL;
+    constexpr quint64 XXH_P2 = 14029467366897019727ULL;
+    constexpr quint64 XXH_P3 = 1609587929392839161ULL;
+    constexpr quint64 XXH_P4 = 9650029242287828579ULL;
+    constexpr quint64 XXH_P5 = 2870177450012600261ULL;
+
+    inline quint64 rotl64(quint64 x, int r) { return (x << r) | (x >> (64 - r)); }
+
+    inline quint64 read64(const uchar *p)
+    {
+        quint64 v;
+        std::memcpy(&v, p, sizeof(v));
+        return v;
+    }
+
+    inline quint32 read32(const uchar *p)
+    {
+        quint32 v;
+        std::memcpy(&v, p, sizeof(v));
+        return v;
+    }
+
+    inline quint64 xxhRound(quint64 acc, quint64 input)
+    {
+        acc += input * XXH_P2;
+        acc = rotl64(acc, 31);
+        return acc * XXH_P1;
+    }
+
+    inline quint64 xxhMerge(quint64 acc, quint64 val)
+    {
+        acc ^= xxhRound(0, val);
+        return acc * XXH_P1 + XXH_P4;
+    }
+
+    quint64 xxh64(const uchar *p, size_t len)
+    {
+        const uchar *end = p + len;
+        quint64 h;
+        if (len >= 32)
+        {
+            quint64 v1 = XXH_P1 + XXH_P2;
+            quint64 v2 = XXH_P2;
+            quint64 v3 = 0;
+            quint64 v4 = 0 - XXH_P1;
+            const uchar *limit = end - 32;
+            do
+            {
+                v1 = xxhRound(v1, read64(p));
+                v2 = xxhRound(v2, read64(p + 8));
+                v3 = xxhRound(v3, read64(p + 16));
+                v4 = xxhRound(v4, read64(p + 24));
+                p += 32;
+            } while (p <= limit);
+            h = rotl64(v1, 1) + rotl64(v2, 7) + rotl64(v3, 12) + rotl64(v4, 18);
+            h = xxhMerge(h, v1);
+            h = xxhMerge(h, v2);
+            h = xxhMerge(h, v3);
+            h = xxhMerge(h, v4);
+        }
+        else
+        {
+            h = XXH_P5;
+        }
+
+        h += static_cast<quint64>(len);
+        while (p + 8 <= end)
+        {
+            h ^= xxhRound(0, read64(p));
+            h = rotl64(h, 27) * XXH_P1 + XXH_P4;
+            p += 8;
+        }
+        if (p + 4 <= end)
+        {
+            h ^= static_cast<quint64>(read32(p)) * XXH_P1;
+            h = rotl64(h, 23) * XXH_P2 + XXH_P3;
+            p += 4;
+        }
+        while (p < end)
+        {
+            h ^= (*p) * XXH_P5;
+            h = rotl64(h, 11) * XXH_P1;
+            ++p;
+        }
+
+        h ^= h >> 33;
+        h *= XXH_P2;
+        h ^= h >> 29;
+        h *= XXH_P3;
+        h ^= h >> 32;
+        return h;
+    }
+
+    const QString &eventAgvState()
+    {
+        static const QString name = QStringLiteral("AGV_STATE");
+        return name;
+    }
+
+    const QString &eventAgvTask()
+    {
+        static const QString name = QStringLiteral("AGV_TASK");
+        return name;
+    }
+
+    // 常见事件名引用静态字符串，避免每帧分配
+    QString eventName(QStringView name)
+    {
+        static const QString known[] = {eventAgvState(), eventAgvTask(), QStringLiteral("SUBSCRIBE_ACK"),
+                                        QStringLiteral("SET_ENCODING_ACK")};
+        for (const QString &event : known)
+        {
+            if (name == QStringView(event))
+                return event;
+        }
+        return name.toString();
+    }
+}
+
+// 单遍流式解析：顶层只记录 Body 的原文范围（协议对象键按字母序输出，Body 位于 Event 之前），
+// 确定 Event 后再按对应结构在同一段文本上解析 Body
+bool AgvFrameDecoder::decodeJson(QStringView msg, AgvSnapshot &dst, AgvFrame &frame, QString &error)
+{
+    frame = AgvFrame();
+
+    AgvJsonReader reader(msg);
+    if (!reader.beginObject())
+    {
+        error = QStringLiteral("数据格式错误: 不是 JSON 对象");
+        return false;
+    }
+
+    QStringView body;
+    bool hasEvent = false;
+    bool hasBody = false;
+    QStringView key;
+    while (reader.nextKey(key))
+    {
+        const AgvJsonReader::Type type = reader.peekType();
+        if (key == QLatin1String("Event") && type == AgvJsonReader::Type::String)
+        {
+            QStringView event;
+            reader.readString(event);
+            frame.event = eventName(event);
+            hasEvent = true;
+        }
+        else if (key == QLatin1String("Body") && type == AgvJsonReader::Type::Object)
+        {
+            hasBody = reader.readRaw(body);
+        }
+        else if (key == QLatin1String("IsSucceed") && type == AgvJsonReader::Type::Bool)
+        {
+            reader.readBool(frame.isSucceed);
+        }
+        else if (key == QLatin1String("DataStamps") && type == AgvJsonReader::Type::Number)
+        {
+            double stamps = -1;
+            reader.readNumber(stamps);
+            frame.dataStamps = static_cast<qint64>(stamps);
+        }
+        else
+        {
+            reader.skipValue();
+        }
+    }
+
+    if (reader.hasError() || !reader.atEnd())
+    {
+        error = QStringLiteral("JSON 解析错误: 非法的 json 结构");
+        return false;
+    }
+    if (!hasEvent)
+    {
+        error = QStringLiteral("缺少 Event 字段 或者 Event 字段不是 String 类型");
+        return false;
+    }
+    if (!hasBody)
+    {
+        error = QStringLiteral("缺少 Body 字段 或者 Body 字段不是 JSON 对象");
+        return false;
+    }
+
+    if (frame.event == eventAgvState())
+        return decodeAgvStateBody(body, dst, frame, error);
+
+    if (frame.event == eventAgvTask())
+    {
+        m_agvTaskSections.fetch_add(1, std::memory_order_relaxed);
+        if (sameSection(m_agvTaskHash, body))
+        {
+            m_agvTaskSkipped.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+
+        AgvJsonReader bodyReader(body);
+        if (!applyFields(dst, kAgvTaskTable, bodyReader, frame.changed))
+        {
+            m_agvTaskHash = SectionHash();
+            error = QStringLiteral("AGV_TASK 错误: Body 不是合法的 JSON 对象");
+            return false;
+        }
+        return true;
+    }
+
+    // 其余都是低频的链路控制消息，直接建 DOM 交给调用方
+    frame.body = QJsonDocument::fromJson(body.toString().toUtf8()).object();
+    return true;
+}
+
+// 解析 AgvState，包含 AGVInfo、OptionalINFO
+bool AgvFrameDecoder::decodeAgvStateBody(QStringView body, AgvSnapshot &dst, AgvFrame &frame, QString &error)
+{
+    AgvJsonReader reader(body);
+    reader.beginObject();
+
+    QStringView optionalRaw;
+    bool hasAgvInfo = false;
+    bool hasOptionalInfo = false;
+    QStringView key;
+    while (reader.nextKey(key))
+    {
+        const AgvJsonReader::Type type = reader.peekType();
+        if (key == QLatin1String("AGVInfo") && type == AgvJsonReader::Type::Object)
+        {
+            QStringView agvInfoRaw;
+            if (!reader.readRaw(agvInfoRaw))
+                break;
+            hasAgvInfo = true;
+
+            m_agvInfoSections.fetch_add(1, std::memory_order_relaxed);
+            if (sameSection(m_agvInfoHash, agvInfoRaw))
+            {
+                m_agvInfoSkipped.fetch_add(1, std::memory_order_relaxed);
+                continue;
+            }
+
+            AgvJsonReader section(agvInfoRaw);
+            if (!applyFields(dst, kAgvInfoTable, section, frame.changed))
+            {
+                m_agvInfoHash = SectionHash();
+                error = QStringLiteral("AGV_STATE 错误: AGVInfo 不是合法的 JSON 对象");
+                return false;
+            }
+        }
+        else if (key == QLatin1String("OptionalINFO") && type == AgvJsonReader::Type::Object)
+        {
+            hasOptionalInfo = reader.readRaw(optionalRaw);
+        }
+        else
+        {
+            reader.skipValue();
+        }
+    }
+
+    if (reader.hasError())
+    {
+        error = QStringLiteral("AGV_STATE 错误: Body 不是合法的 JSON 对象");
+        return false;
+    }
+    if (!hasAgvInfo)
+    {
+        frame.warning = QStringLiteral("AGV_STATE 错误: 缺少 AGVInfo 字段或者 AGVInfo 不是 JSON 对象");
+        return true;
+    }
+    if (!hasOptionalInfo)
+    {
+        frame.warning = QStringLiteral("AGV_STATE 错误: 缺少 OptionalINFO 字段或者 OptionalINFO 不是 JSON 对象");
+        return true;
+    }
+
+    // OptionalINFO 字段少且很少变化：原文与上一帧相同时整段跳过，变化时才在原文上直接构建对象保存
+    m_optionalInfoSections.fetch_add(1, std::memory_order_relaxed);
+    if (sameSection(m_optionalInfoHash, optionalRaw))
+    {
+        m_optionalInfoSkipped.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    QJsonObject optionalInfo;
+    AgvJsonReader section(optionalRaw);
+    if (!section.readObject(optionalInfo))
+    {
+        m_optionalInfoHash = SectionHash();
+        error = QStringLiteral("AGV_STATE 错误: OptionalINFO 不是合法的 JSON 对象");
+        return false;
+    }
+
+    frame.changed |= applyOptionalInfo(dst, optionalInfo);
+    return true;
+}
+
+bool AgvFrameDecoder::decodeJsonDom(const QString &msg, AgvSnapshot &dst, AgvFrame &frame, QString &error)
+{
+    frame = AgvFrame();
+    resetSectionHashes(); // 快照不再经过流式路径写入，段落摘要失效
+
+    QJsonParseError parseError;
+    const QJsonDocument doc = QJsonDocument::fromJson(msg.toUtf8(), &parseError);
+    if (parseError.error != QJsonParseError::NoError)
+    {
+        error = QStringLiteral("JSON 解析错误: %1").arg(parseError.errorString());
+        return false;
+    }
+    if (!doc.isObject())
+    {
+        error = QStringLiteral("数据格式错误: 不是 JSON 对象");
+        return false;
+    }
+    const QJsonObject root = doc.object();
+
+    if (!root.value(QLatin1String("Event")).isString())
+    {
+        error = QStringLiteral("缺少 Event 字段 或者 Event 字段不是 String 类型");
+        return false;
+    }
+    if (!root.value(QLatin1String("Body")).isObject())
+    {
+        error = QStringLiteral("缺少 Body 字段 或者 Body 字段不是 JSON 对象");
+        return false;
+    }
+
+    frame.event = root.value(QLatin1String("Event")).toString();
+    frame.isSucceed = root.value(QLatin1String("IsSucceed")).toBool();
+    frame.dataStamps = static_cast<qint64>(root.value(QLatin1String("DataStamps")).toDouble(-1));
+    const QJsonObject body = root.value(QLatin1String("Body")).toObject();
+
+    if (frame.event == eventAgvState())
+    {
+        if (!body.value(QLatin1String("AGVInfo")).isObject())
+        {
+            frame.warning = QStringLiteral("AGV_STATE 错误: 缺少 AGVInfo 字段或者 AGVInfo 不是 JSON 对象");
+            return true;
+        }
+        frame.changed |= applyFields(dst, kAgvInfoTable, body.value(QLatin1String("AGVInfo")).toObject());
+
+        if (!body.value(QLatin1String("OptionalINFO")).isObject())
+        {
+            frame.warning = QStringLiteral("AGV_STATE 错误: 缺少 OptionalINFO 字段或者 OptionalINFO 不是 JSON 对象");
+            return true;
+        }
+        frame.changed |= applyOptionalInfo(dst, body.value(QLatin1String("OptionalINFO")).toObject());
+    }
+    else if (frame.event == eventAgvTask())
+    {
+        frame.changed |= applyFields(dst, kAgvTaskTable, body);
+    }
+    else
+    {
+        frame.body = body;
+    }
+    return true;
+}
+
+// 直接在 CBOR 上取值，不经过 UTF-16 字符串和 JSON DOM
+bool AgvFrameDecoder::decodeCbor(const QByteArray &data, AgvSnapshot &dst, AgvFrame &frame, QString &error)
+{
+    frame = AgvFrame();
+    resetSectionHashes(); // 快照不再经过流式路径写入，段落摘要失效
+
+    QCborParserError parseError;
+    const QCborValue root = QCborValue::fromCbor(data, &parseError);
+    if (parseError.error != QCborError::NoError)
+    {
+        error = QStringLiteral("CBOR 解析错误: %1").arg(parseError.errorString());
+        return false;
+    }
+    if (!root.isMap())
+    {
+        error = QStringLiteral("数据格式错误: 不是 CBOR Map");
+        return false;
+    }
+    const QCborMap rootMap = root.toMap();
+
+    const QCborValue event = rootMap.value(QLatin1String("Event"));
+    if (!event.isString())
+    {
+        error = QStringLiteral("缺少 Event 字段 或者 Event 字段不是 String 类型");
+        return false;
+    }
+    const QCborValue bodyValue = rootMap.value(QLatin1String("Body"));
+    if (!bodyValue.isMap())
+    {
+        error = QStringLiteral("缺少 Body 字段 或者 Body 字段不是 CBOR Map");
+        return false;
+    }
+
+    frame.event = eventName(event.toString());
+    frame.isSucceed = rootMap.value(QLatin1String("IsSucceed")).toBool();
+    frame.dataStamps = rootMap.value(QLatin1String("DataStamps")).toInteger(-1);
+    const QCborMap body = bodyValue.toMap();
+
+    if (frame.event == eventAgvState())
+    {
+        const QCborValue agvInfo = body.value(QLatin1String("AGVInfo"));
+        if (!agvInfo.isMap())
+        {
+            frame.warning = QStringLiteral("AGV_STATE 错误: 缺少 AGVInfo 字段或者 AGVInfo 不是 CBOR Map");
+            return true;
+        }
+        frame.changed |= applyFields(dst, kAgvInfoTable, agvInfo.toMap());
+
+        const QCborValue optionalInfo = body.value(QLatin1String("OptionalINFO"));
+        if (!optionalInfo.isMap())
+        {
+            frame.warning = QStringLiteral("AGV_STATE 错误: 缺少 OptionalINFO 字段或者 OptionalINFO 不是 CBOR Map");
+            return true;
+        }
+
+        // OptionalINFO 字段很少，快照中仍以 QJsonObject 保存，供 OptionalInfoWidget 遍历显示
+        const QCborMap optionalMap = optionalInfo.toMap();
+        const QJsonObject json = optionalMap.toJsonObject();
+        if (dst.optionalInfo != json)
+        {
+            dst.optionalInfo = json;
+            frame.changed |= agvFieldBit(AgvField::optionalInfo);
+        }
+        frame.changed |= applyFields(dst, kOptionalInfoTable, optionalMap);
+    }
+    else if (frame.event == eventAgvTask())
+    {
+        frame.changed |= applyFields(dst, kAgvTaskTable, body);
+    }
+    else
+    {
+        frame.body = body.toJsonObject();
+    }
+    return true;
+}
+
+// 64 位摘要加长度比较，未变化的段落误判为相同的概率可以忽略
+bool AgvFrameDecoder::sameSection(SectionHash &last, QStringView raw)
+{
+    const int length = static_cast<int>(raw.size());
+    const quint64 hash = xxh64(reinterpret_cast<const uchar *>(raw.data()), static_cast<size_t>(length) * sizeof(QChar));
+    if (last.length == length && last.hash == hash)
+        return true;
+
+    last.hash = hash;
+    last.length = length;
+    return false;
+}
+
+void AgvFrameDecoder::resetSectionHashes()
+{
+    m_agvInfoHash = SectionHash();
+    m_optionalInfoHash = SectionHash();
+    m_agvTaskHash = SectionHash();
+}
+
+AgvDecodeStats AgvFrameDecoder::stats() const
+{
+    AgvDecodeStats stats;
+    stats.agvInfoSections = m_agvInfoSections.load(std::memory_order_relaxed);
+    stats.agvInfoSkipped = m_agvInfoSkipped.load(std::memory_order_relaxed);
+    stats.optionalInfoSections = m_optionalInfoSections.load(std::memory_order_relaxed);
+    stats.optionalInfoSkipped = m_optionalInfoSkipped.load(std::memory_order_relaxed);
+    stats.agvTaskSections = m_agvTaskSections.load(std::memory_order_relaxed);
+    stats.agvTaskSkipped = m_agvTaskSkipped.load(std::memory_order_relaxed);
+    return stats;
+}
@@ -0,0 +1,517 @@
+#include "AgvJsonReader.h"
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QJsonValue>
+#include <QLocale>
+
+// readObject 允许的最大嵌套层数，防止畸形输入导致递归过深
+static constexpr int MAX_DEPTH = 64;
+
+AgvJsonReader::AgvJsonReader(QStringView text)
+    : m_pos(text.data()), m_end(text.data() + text.size())
+{
+}
+
+bool AgvJsonReader::fail()
+{
+    m_error = true;
+    m_pos = m_end;
+    return false;
+}
+
+void AgvJsonReader::skipWhitespace()
+{
+    while (m_pos < m_end)
+    {
+        const ushort c = m_pos->unicode();
+        if (c != ' ' && c != '\n' && c != '\r' && c != '\t')
+            break;
+        ++m_pos;
+    }
+}
+
+bool AgvJsonReader::atEnd()
+{
+    skipWhitespace();
+    return m_pos >= m_end;
+}
+
+AgvJsonReader::Type AgvJsonReader::peekType()
+{
+    skipWhitespace();
+    if (m_error || m_pos >= m_end)
+        return Type::Invalid;
+
+    switch (m_pos->unicode())
+    {
+    case '{':
+        return Type::Object;
+    case '[':
+        return Type::Array;
+    case '"':
+        return Type::String;
+    case 't':
+    case 'f':
+        return Type::Bool;
+    case 'n':
+        return Type::Null;
+    default:
+    {
+        const ushort c = m_pos->unicode();
+        if (c == '-' || (c >= '0' && c <= '9'))
+            return Type::Number;
+        return Type::Invalid;
+    }
+    }
+}
+
+bool AgvJsonReader::beginObject()
+{
+    if (peekType() != Type::Object)
+        return fail();
+    ++m_pos;
+    m_firstMember = true;
+    return true;
+}
+
+bool AgvJsonReader::nextKey(QStringView &key)
+{
+    skipWhitespace();
+    if (m_error || m_pos >= m_end)
+        return fail();
+
+    if (m_pos->unicode() == '}')
+    {
+        // 结束的可能是嵌套对象，外层对象此时已读过成员，后续需要逗号
+        ++m_pos;
+        m_firstMember = false;
+        return false;
+    }
+
+    // 第一个成员前不允许逗号，其余成员前必须有且只有一个逗号
+    if (!m_firstMember)
+    {
+        if (m_pos->unicode() != ',')
+            return fail();
+        ++m_pos;
+        skipWhitespace();
+        if (m_pos >= m_end)
+            return fail();
+    }
+    m_firstMember = false;
+
+    bool escaped = false;
+    QStringView raw;
+    if (!scanString(raw, escaped))
+        return false;
+
+    if (escaped)
+    {
+        if (!decodeString(raw.data(), raw.data() + raw.size(), m_keyBuf))
+            return false;
+        key = QStringView(m_keyBuf);
+    }
+    else
+    {
+        key = raw;
+    }
+
+    skipWhitespace();
+    if (m_pos >= m_end || m_pos->unicode() != ':')
+        return fail();
+    ++m_pos;
+    return true;
+}
+
+// m_pos 指向起始引号；结束后 m_pos 位于结束引号之后，view 为引号内的原文
+bool AgvJsonReader::scanString(QStringView &view, bool &escaped)
+{
+    if (m_pos >= m_end || m_pos->unicode() != '"')
+        return fail();
+
+    const QChar *start = ++m_pos;
+    escaped = false;
+    while (m_pos < m_end)
+    {
+        const ushort c = m_pos->unicode();
+        if (c == '"')
+        {
+            view = QStringView(start, m_pos - start);
+            ++m_pos;
+            return true;
+        }
+        if (c == '\\')
+        {
+            escaped = true;
+            ++m_pos; // 跳过被转义的字符，\uXXXX 的其余部分按普通字符扫描
+        }
+        ++m_pos;
+    }
+    return fail();
+}
+
+bool AgvJsonReader::skipString()
+{
+    QStringView view;
+    bool escaped;
+    return scanString(view, escaped);
+}
+
+static int hexValue(ushort c)
+{
+    if (c >= '0' && c <= '9')
+        return c - '0';
+    if (c >= 'a' && c <= 'f')
+        return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F')
+        return c - 'A' + 10;
+    return -1;
+}
+
+bool AgvJsonReader::decodeString(const QChar *from, const QChar *to, QString &out)
+{
+    out.clear();
+    out.reserve(static_cast<int>(to - from));
+    while (from < to)
+    {
+        const ushort c = from->unicode();
+        if (c != '\\')
+        {
+            out.append(*from++);
+            continue;
+        }
+
+        if (++from >= to)
+            return fail();
+        switch (from->unicode())
+        {
+        case '"':
+            out.append(QLatin1Char('"'));
+            break;
+        case '\\':
+            out.append(QLatin1Char('\\'));
+            break;
+        case '/':
+            out.append(QLatin1Char('/'));
+            break;
+        case 'b':
+            out.append(QLatin1Char('\b'));
+            break;
+        case 'f':
+            out.append(QLatin1Char('\f'));
+            break;
+        case 'n':
+            out.append(QLatin1Char('\n'));
+            break;
+        case 'r':
+            out.append(QLatin1Char('\r'));
+            break;
+        case 't':
+            out.append(QLatin1Char('\t'));
+            break;
+        case 'u':
+        {
+            // UTF-16 代理对由两个 \uXXXX 依次写入，天然组合
+            if (to - from < 5)
+                return fail();
+            int code = 0;
+            for (int i = 1; i <= 4; ++i)
+            {
+                const int h = hexValue(from[i].unicode());
+                if (h < 0)
+                    return fail();
+                code = (code << 4) | h;
+            }
+            out.append(QChar(static_cast<ushort>(code)));
+            from += 4;
+            break;
+        }
+        default:
+            return fail();
+        }
+        ++from;
+    }
+    return true;
+}
+
+bool AgvJsonReader::readString(QString &out)
+{
+    if (peekType() != Type::String)
+        return fail();
+
+    QStringView raw;
+    bool escaped = false;
+    if (!scanString(raw, escaped))
+        return false;
+
+    if (escaped)
+        return decodeString(raw.data(), raw.data() + raw.size(), out);
+
+    out = raw.toString();
+    return true;
+}
+
+bool AgvJsonReader::readString(QStringView &out)
+{
+    if (peekType() != Type::String)
+        return fail();
+
+    QStringView raw;
+    bool escaped = false;
+    if (!scanString(raw, escaped))
+        return false;
+
+    if (escaped)
+    {
+        if (!decodeString(raw.data(), raw.data() + raw.size(), m_strBuf))
+            return false;
+        out = QStringView(m_strBuf);
+        return true;
+    }
+
+    out = raw;
+    return true;
+}
+
+bool AgvJsonReader::readNumber(double &out)
+{
+    if (peekType() != Type::Number)
+        return fail();
+
+    const QChar *start = m_pos;
+    bool negative = false;
+    bool integral = true;
+    qint64 mantissa = 0;
+    int digits = 0;
+
+    if (m_pos->unicode() == '-')
+    {
+        negative = true;
+        ++m_pos;
+    }
+    while (m_pos < m_end)
+    {
+        const ushort c = m_pos->unicode();
+        if (c >= '0' && c <= '9')
+        {
+            if (++digits <= 15)
+                mantissa = mantissa * 10 + (c - '0');
+        }
+        else if (c == '.' || c == 'e' || c == 'E' || c == '+' || c == '-')
+        {
+            integral = false;
+        }
+        else
+        {
+            break;
+        }
+        ++m_pos;
+    }
+
+    if (digits == 0)
+        return fail();
+
+    // 协议中绝大多数数值是整数，直接累加；15 位以内的整数可以精确表示为 double
+    if (integral && digits <= 15)
+    {
+        out = static_cast<double>(negative ? -mantissa : mantissa);
+        return true;
+    }
+
+    bool ok = false;
+    out = QLocale::c().toDouble(QStringView(start, m_pos - start), &ok);
+    return ok ? true : fail();
+}
+
+bool AgvJsonReader::readBool(bool &out)
+{
+    if (peekType() != Type::Bool)
+        return fail();
+
+    if (m_end - m_pos >= 4 && QStringView(m_pos, 4) == QLatin1String("true"))
+    {
+        m_pos += 4;
+        out = true;
+        return true;
+    }
+    if (m_end - m_pos >= 5 && QStringView(m_pos, 5) == QLatin1String("false"))
+    {
+        m_pos += 5;
+        out = false;
+        return true;
+    }
+    return fail();
+}
+
+bool AgvJsonReader::skipValue()
+{
+    switch (peekType())
+    {
+    case Type::String:
+        return skipString();
+    case Type::Number:
+    {
+        double ignored;
+        return readNumber(ignored);
+    }
+    case Type::Bool:
+    {
+        bool ignored;
+        return readBool(ignored);
+    }
+    case Type::Null:
+        if (m_end - m_pos >= 4 && QStringView(m_pos, 4) == QLatin1String("null"))
+        {
+            m_pos += 4;
+            return true;
+        }
+        return fail();
+    case Type::Object:
+    case Type::Array:
+    {
+        // 只做括号配对，字符串内的括号不计入
+        int depth = 0;
+        while (m_pos < m_end)
+        {
+            const ushort c = m_pos->unicode();
+            if (c == '"')
+            {
+                if (!skipString())
+                    return false;
+                continue;
+            }
+            if (c == '{' || c == '[')
+            {
+                ++depth;
+            }
+            else if (c == '}' || c == ']')
+            {
+                if (--depth == 0)
+                {
+                    ++m_pos;
+                    return true;
+                }
+            }
+            ++m_pos;
+        }
+        return fail();
+    }
+    default:
+        return fail();
+    }
+}
+
+bool AgvJsonReader::readRaw(QStringView &raw)
+{
+    skipWhitespace();
+    const QChar *start = m_pos;
+    if (!skipValue())
+        return false;
+    raw = QStringView(start, m_pos - start);
+    return true;
+}
+
+bool AgvJsonReader::readObject(QJsonObject &out)
+{
+    out = QJsonObject();
+    return readJsonObject(out, 0);
+}
+
+bool AgvJsonReader::readJsonObject(QJsonObject &out, int depth)
+{
+    if (depth >= MAX_DEPTH || !beginObject())
+        return fail();
+
+    QStringView key;
+    while (nextKey(key))
+    {
+        // 嵌套读取会覆盖 m_keyBuf，先复制键名
+        const QString name = key.toString();
+        QJsonValue value;
+        if (!readJsonValue(value, depth + 1))
+            return false;
+        out.insert(name, value);
+    }
+    return !m_error;
+}
+
+bool AgvJsonReader::readJsonValue(QJsonValue &out, int depth)
+{
+    switch (peekType())
+    {
+    case Type::Object:
+    {
+        QJsonObject object;
+        if (!readJsonObject(object, depth))
+            return false;
+        out = object;
+        return true;
+    }
+    case Type::Array:
+    {
+        if (depth >= MAX_DEPTH)
+            return fail();
+
+        QJsonArray array;
+        ++m_pos;
+        skipWhitespace();
+        if (m_pos < m_end && m_pos->unicode() == ']')
+        {
+            ++m_pos;
+            out = array;
+            return true;
+        }
+        forever
+        {
+            QJsonValue element;
+            if (!readJsonValue(element, depth + 1))
+                return false;
+            array.append(element);
+
+            skipWhitespace();
+            if (m_pos >= m_end)
+                return fail();
+            if (m_pos->unicode() == ']')
+            {
+                ++m_pos;
+                out = array;
+                return true;
+            }
+            if (m_pos->unicode() != ',')
+                return fail();
+            ++m_pos;
+        }
+    }
+    case Type::String:
+    {
+        QString text;
+        if (!readString(text))
+            return false;
+        out = text;
+        return true;
+    }
+    case Type::Number:
+    {
+        double number;
+        if (!readNumber(number))
+            return false;
+        out = number;
+        return true;
+    }
+    case Type::Bool:
+    {
+        bool flag;
+        if (!readBool(flag))
+            return false;
+        out = flag;
+        return true;
+    }
+    case Type::Null:
+        if (!skipValue())
+            return false;
+        out = QJsonValue(QJsonValue::Null);
+        return true;
+    default:
+        return fail();
+    }
+}
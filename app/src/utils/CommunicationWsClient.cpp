@@ -1,7 +1,9 @@
 #include "CommunicationWsClient.h"
+#include "TrafficRecorder.h"
+#include <limits>
 
 CommunicationWsClient::CommunicationWsClient(QObject *parent)
-    : QObject(parent), m_client(nullptr), m_thread(nullptr)
+    : QObject(parent), m_client(nullptr)
 {
     // 初始化数据戳
     dataStamps = 0;
@@ -13,6 +15,39 @@ CommunicationWsClient::CommunicationWsClient(QObject *parent)
     m_pollTimer = new QTimer(this);
     m_pollTimer->setInterval(POLL_INTERVAL_MS);
     connect(m_pollTimer, &QTimer::timeout, this, &CommunicationWsClient::sendAgvStateRequest);
+
+    // 订阅应答超时定时器
+    m_subscribeAckTimer = new QTimer(this);
+    m_subscribeAckTimer->setSingleShot(true);
+    m_subscribeAckTimer->setInterval(SUBSCRIBE_ACK_TIMEOUT_MS);
+    connect(m_subscribeAckTimer, &QTimer::timeout, this, &CommunicationWsClient::onSubscribeAckTimeout);
+    connect(agvData, &AgvData::subscribeAckReceived, this, &CommunicationWsClient::onSubscribeAck);
+
+    // 推送看门狗
+    m_pushClock.start();
+    m_pushWatchdogTimer = new QTimer(this);
+    connect(m_pushWatchdogTimer, &QTimer::timeout, this, &CommunicationWsClient::onPushWatchdog);
+
+    // 编码协商应答超时定时器
+    m_encodingAckTimer = new QTimer(this);
+    m_encodingAckTimer->setSingleShot(true);
+    m_encodingAckTimer->setInterval(ENCODING_ACK_TIMEOUT_MS);
+    connect(m_encodingAckTimer, &QTimer::timeout, this, &CommunicationWsClient::onEncodingAckTimeout);
+    connect(agvData, &AgvData::encodingAckReceived, this, &CommunicationWsClient::onEncodingAck);
+
+    // TOUCH_STATE：变化即发 + 心跳
+    m_touchHeartbeatTimer = new QTimer(this);
+    connect(m_touchHeartbeatTimer, &QTimer::timeout, this, &CommunicationWsClient::sendTouchState);
+    connect(agvData, &AgvData::touchStateChanged, this, &CommunicationWsClient::onTouchStateChanged);
+
+    // 往返时延与推送看门狗：应答在通讯子线程中直接登记，接收时间不受主线程繁忙程度影响
+    connect(agvData, &AgvData::responseStampReceived, this, [this](const QString &event, qint64 stamp)
+            {
+                m_lastResponseMs.store(m_pushClock.elapsed(), std::memory_order_relaxed);
+                m_latency.markReceived(stamp, event == QLatin1String("AGV_TASK") ? RESPONSE_TASK : RESPONSE_STATE); }, Qt::DirectConnection);
+    m_latencyReportTimer = new QTimer(this);
+    m_latencyReportTimer->setInterval(LATENCY_REPORT_MS);
+    connect(m_latencyReportTimer, &QTimer::timeout, this, &CommunicationWsClient::onLatencyReport);
 }
 
 CommunicationWsClient::~CommunicationWsClient()
@@ -26,41 +61,37 @@ void CommunicationWsClient::initalReqJson()
     QDateTime cur_time = QDateTime::currentDateTime();
     QString timeStr = cur_time.toString("yyyy-MM-dd hh:mm:ss.zzz");
 
-    requestState["IsSucceed"] = true;
-    requestState["DateTime"] = timeStr;
-    requestState["DataStamps"] = static_cast<int>(dataStamps);
-    requestState["Event"] = "REQUEST_AGV_STATE";
-    requestState["Body"] = "";
-    requestState["ErrorMessage"] = "";
-
-    requestTask["IsSucceed"] = true;
-    requestTask["DateTime"] = timeStr;
-    requestTask["DataStamps"] = static_cast<int>(dataStamps);
-    requestTask["Event"] = "REQUEST_AGV_TASK";
-    requestTask["Body"] = "";
-    requestTask["ErrorMessage"] = "";
-
-    touchState["IsSucceed"] = true;
-    touchState["DateTime"] = timeStr;
-    touchState["DataStamps"] = static_cast<int>(dataStamps);
-    touchState["Event"] = "TOUCH_STATE";
-    touchState["Body"] = "";
-    touchState["ErrorMessage"] = "";
+    requestState = ControllerFrames::request(QStringLiteral("REQUEST_AGV_STATE"));
+    requestTask = ControllerFrames::request(QStringLiteral("REQUEST_AGV_TASK"));
+    touchState = ControllerFrames::touchState();
+
+    subscribeReq["IsSucceed"] = true;
+    subscribeReq["DateTime"] = timeStr;
+    subscribeReq["DataStamps"] = dataStamps;
+    subscribeReq["Event"] = "SUBSCRIBE";
+    subscribeReq["Body"] = "";
+    subscribeReq["ErrorMessage"] = "";
+
+    encodingReq["IsSucceed"] = true;
+    encodingReq["DateTime"] = timeStr;
+    encodingReq["DataStamps"] = dataStamps;
+    encodingReq["Event"] = "SET_ENCODING";
+    encodingReq["Body"] = "";
+    encodingReq["ErrorMessage"] = "";
 }
 
 void CommunicationWsClient::start()
 {
-    if (m_thread && m_thread->isRunning())
+    if (m_client)
     {
         return; // 避免重复启动
     }
 
-    // 1. 创建对象和线程
-    m_thread = new QThread(this);
+    // 1. 创建对象
     m_client = new WebsocketClient(); // 注意：不能加 parent，因为要 moveToThread
 
-    // 2. 移动到子线程
-    m_client->moveToThread(m_thread);
+    // 2. 托管到独占的网络 I/O 线程：控制帧与状态解析不与 rosbridge 的大帧解码共用线程
+    NetworkReactor::instance()->attach(m_client, NetworkReactor::Placement::Dedicated);
 
     // 3. 读取配置
     QString ip = cfg->commIp();
@@ -68,23 +99,32 @@ void CommunicationWsClient::start()
     QString url = QStringLiteral("ws://%1:%2").arg(ip).arg(port);
 
     // 4. 绑定信号槽
-    // 4.1 线程启动 -> 执行连接
-    connect(m_thread, &QThread::started, m_client, [this, url]()
-            { m_client->connectToServer(url); });
-
-    // 4.2 线程结束 -> 销毁对象
-    connect(m_thread, &QThread::finished, m_client, &QObject::deleteLater);
-
     // 4.3 底层状态 -> 本类内部槽 -> 转发给外部
     connect(m_client, &WebsocketClient::connected, this, &CommunicationWsClient::onInternalConnected);
     connect(m_client, &WebsocketClient::disconnected, this, &CommunicationWsClient::onInternalDisconnected);
-    connect(m_client, &WebsocketClient::textMessageReceived, this, &CommunicationWsClient::onInternalTextReceived);
 
-    // 4.4 发送数据：本类信号(主线程) -> 底层槽(子线程)
-    connect(this, &CommunicationWsClient::sigInternalSendText, m_client, &WebsocketClient::sendTextMessage);
+    // 4.4 开启录制时，在解析之前把入站帧写入录制文件
+    TrafficRecorder *recorder = TrafficRecorder::instance();
+    if (recorder->isRecording())
+    {
+        connect(m_client, &WebsocketClient::textMessageReceived, this, [recorder](const QString &msg)
+                { recorder->record(TrafficCapture::Channel::Comm, msg); }, Qt::DirectConnection);
+        connect(m_client, &WebsocketClient::binaryMessageReceived, this, [recorder](const QByteArray &data)
+                { recorder->record(TrafficCapture::Channel::Comm, data); }, Qt::DirectConnection);
+    }
+
+    // 4.5 接收数据：直接在子线程中完成 JSON 解析并写入 AgvData
+    // 使用 DirectConnection，解析不再经过主线程事件队列，主线程只读取解析好的结果
+    connect(m_client, &WebsocketClient::textMessageReceived, agvData, &AgvData::parseMsg, Qt::DirectConnection);
+    // 协商为 CBOR 后控制器改发二进制帧，两种帧始终都可接收
+    connect(m_client, &WebsocketClient::binaryMessageReceived, agvData, &AgvData::parseCborMsg, Qt::DirectConnection);
+
+    // 4.6 发送数据：WebsocketClient::enqueueTextMessage 线程安全，实际发送在子线程中按优先级完成
 
-    // 5. 启动线程
-    m_thread->start();
+    // 5. 在 I/O 线程中发起连接
+    WebsocketClient *client = m_client;
+    QMetaObject::invokeMethod(client, [client, url]()
+                              { client->connectToServer(url); }, Qt::QueuedConnection);
 }
 
 void CommunicationWsClient::stop()
@@ -92,112 +132,198 @@ void CommunicationWsClient::stop()
     // 停止时必须关闭定时器，防止向已销毁的线程发送信号
     if (m_pollTimer->isActive())
         m_pollTimer->stop();
-
-    if (m_thread && m_thread->isRunning())
+    m_touchHeartbeatTimer->stop();
+    m_latencyReportTimer->stop();
+    m_subscribeAckTimer->stop();
+    m_pushWatchdogTimer->stop();
+    m_encodingAckTimer->stop();
+    m_subscribed = false;
+    m_binaryFraming = false;
+    m_connected = false;
+
+    if (m_client)
     {
-        // 请求子线程退出
-        m_thread->quit();
-        m_thread->wait();
+        // 在 I/O 线程中销毁底层客户端并等待完成
+        NetworkReactor::instance()->detach(m_client);
+        m_client = nullptr;
     }
-    // m_client 会自动析构，因为绑定了 finished->deleteLater
-    // m_thread 是 this 的子对象，也会自动析构，或者可以手动 delete
 }
 
 // --- 业务逻辑封装区域 ---
 
 void CommunicationWsClient::sendAgvStateRequest()
 {
-    // 当前时间戳
-    QDateTime cur_time = QDateTime::currentDateTime();
-    QString timeStr = cur_time.toString("yyyy-MM-dd hh:mm:ss.zzz");
+    // 订阅模式下 AGV_STATE / AGV_TASK 由控制器主动推送，不再轮询
+    if (m_subscribed)
+        return;
+
+    // 本周期的 REQUEST_AGV_STATE 与 REQUEST_AGV_TASK 使用同一个数据戳，两路应答都到齐才算完成
+    const qint64 stamps = nextDataStamps();
+    requestState.setStamps(stamps);
+    requestTask.setStamps(stamps);
+    m_latency.markSent(stamps, RESPONSE_STATE | RESPONSE_TASK);
+
+    sendFrame(requestState, WebsocketClient::SendPriority::Normal);
+    sendFrame(requestTask, WebsocketClient::SendPriority::Normal);
+}
 
-    // REQUEST_AGV_STATE
-    requestState["DateTime"] = timeStr;
-    requestState["DataStamps"] = static_cast<int>(dataStamps);
+qint64 CommunicationWsClient::nextDataStamps()
+{
+    const qint64 stamps = dataStamps;
+    dataStamps = stamps >= std::numeric_limits<int>::max() ? 0 : stamps + 1;
+    return stamps;
+}
 
-    QJsonDocument docReqState(requestState);
-    QString jsonReqStateStr = docReqState.toJson(QJsonDocument::Compact);
+void CommunicationWsClient::sendTouchState()
+{
+    m_touchSendPending = false;
+    if (!m_connected)
+        return;
 
-    emit sigInternalSendText(jsonReqStateStr);
+    // TOUCH_STATE
+    touchState.setStamps(dataStamps);
+    bool print = fillTouchStateBody();
 
-    // REQUEST_AGV_TASK
-    requestTask["DateTime"] = timeStr;
-    requestTask["DataStamps"] = static_cast<int>(dataStamps);
+    sendFrame(touchState, WebsocketClient::SendPriority::Control);
 
-    QJsonDocument docReqTask(requestTask);
-    QString jsonReqTaskStr = docReqTask.toJson(QJsonDocument::Compact);
+    if (print)
+    {
+        // 记录实际发出的帧，不重新编码
+        const QString sent = m_binaryFraming ? QCborValue::fromCbor(touchState.lastCbor()).toDiagnosticNotation() : touchState.lastJson();
+        logger->log(QStringLiteral("CommunicationWsClient"), spdlog::level::info, QStringLiteral("TOUCH_STATE: %1").arg(sent));
+    }
 
-    emit sigInternalSendText(jsonReqTaskStr);
+    // 刚发送过，心跳重新计时；每次按当前配置取周期，修改设置后立即生效
+    m_touchHeartbeatTimer->start(qMax(MIN_TOUCH_HEARTBEAT_MS, cfg->commTouchHeartbeatMs()));
+}
 
-    // TOUCH_STATE
-    touchState["DateTime"] = timeStr;
-    touchState["DataStamps"] = static_cast<int>(dataStamps);
-    touchState["Body"] = getTouchStateBody();
+void CommunicationWsClient::onTouchStateChanged()
+{
+    // 同一轮事件中的连续修改（如重定位时依次设置 ini_x / ini_y / ini_w）合并成一帧，
+    // 在当前事件处理结束后立即发送，避免发出只更新了一半的 TOUCH_STATE
+    if (m_touchSendPending)
+        return;
+    m_touchSendPending = true;
+    QMetaObject::invokeMethod(this, &CommunicationWsClient::sendTouchState, Qt::QueuedConnection);
+}
+
+void CommunicationWsClient::sendFrame(const QJsonObject &frame, WebsocketClient::SendPriority priority)
+{
+    if (!m_client)
+        return;
+
+    if (m_binaryFraming)
+        m_client->enqueueBinaryMessage(QCborValue::fromJsonValue(frame).toCbor(), priority);
+    else
+        m_client->enqueueTextMessage(QString::fromUtf8(QJsonDocument(frame).toJson(QJsonDocument::Compact)), priority);
+}
+
+void CommunicationWsClient::sendFrame(FrameEncoder &frame, WebsocketClient::SendPriority priority)
+{
+    if (!m_client)
+        return;
+
+    // 编码结果以隐式共享的方式交给发送队列，不复制
+    if (m_binaryFraming)
+        m_client->enqueueBinaryMessage(frame.encodeCbor(), priority);
+    else
+        m_client->enqueueTextMessage(frame.encodeJson(), priority);
+}
+
+// 发送 SUBSCRIBE，请求控制器主动推送 AGV_STATE / AGV_TASK
+// Body: { "Events": [...], "Mode": "ON_CHANGE" | "RATE", "RateMs": n }
+void CommunicationWsClient::sendSubscribeRequest()
+{
+    int rateMs = cfg->commSubscribeRateMs();
+
+    QJsonObject body;
+    body.insert("Events", QJsonArray{"AGV_STATE", "AGV_TASK"});
+    body.insert("Mode", rateMs > 0 ? "RATE" : "ON_CHANGE");
+    body.insert("RateMs", rateMs);
+
+    subscribeReq["DateTime"] = QDateTime::currentDateTime().toString("yyyy-MM-dd hh:mm:ss.zzz");
+    subscribeReq["DataStamps"] = dataStamps;
+    subscribeReq["Body"] = body;
 
-    QJsonDocument docTouchState(touchState);
-    QString jsonTouchStateStr = docTouchState.toJson(QJsonDocument::Compact);
+    sendFrame(subscribeReq, WebsocketClient::SendPriority::Control);
 
-    emit sigInternalSendText(jsonTouchStateStr);
+    logger->log(QStringLiteral("CommunicationWsClient"), spdlog::level::info, QStringLiteral("发送 SUBSCRIBE，推送周期 %1 ms").arg(rateMs));
 
-    dataStamps++;
+    // 等待应答期间保持轮询，避免数据中断
+    m_subscribeAckTimer->start();
 }
 
-QJsonObject CommunicationWsClient::getTouchStateBody()
+// 发送 SET_ENCODING，请求控制器改用 CBOR 二进制帧
+// Body: { "Encoding": "CBOR" }；协商请求本身总是以 JSON 文本帧发出
+void CommunicationWsClient::sendEncodingRequest()
 {
     QJsonObject body;
+    body.insert("Encoding", "CBOR");
+
+    encodingReq["DateTime"] = QDateTime::currentDateTime().toString("yyyy-MM-dd hh:mm:ss.zzz");
+    encodingReq["DataStamps"] = dataStamps;
+    encodingReq["Body"] = body;
+
+    sendFrame(encodingReq, WebsocketClient::SendPriority::Control);
+
+    logger->log(QStringLiteral("CommunicationWsClient"), spdlog::level::info, QStringLiteral("发送 SET_ENCODING，请求使用 CBOR 二进制帧"));
+
+    m_encodingAckTimer->start();
+}
+
+bool CommunicationWsClient::fillTouchStateBody()
+{
+    using namespace ControllerFrames;
 
     // 用于判断是否需要打印，只有移动从 0 变为其他方向才打印一次
     static int lastDir = 0;
 
-    body.insert("page_control", agvData->pageControl());
-    body.insert("task_cancel", agvData->taskCancel());
-    body.insert("task_start", agvData->taskStart());
-    body.insert("task_pause", agvData->taskPause());
-    body.insert("task_resume", agvData->taskResume());
-    body.insert("charge_cmd", agvData->chargeCmd());
-    body.insert("manual_dir", agvData->manualDir());
-    body.insert("manual_act", agvData->manualAct());
-    body.insert("manual_vy", agvData->manualVy());
-    body.insert("ini_x", agvData->iniX());
-    body.insert("ini_y", agvData->iniY());
-    body.insert("ini_w", agvData->iniW());
-    body.insert("music", agvData->music());
+    const int manualDir = agvData->manualDir();
+
+    touchState.setBool(TouchPageControl, agvData->pageControl());
+    touchState.setBool(TouchTaskCancel, agvData->taskCancel());
+    touchState.setBool(TouchTaskStart, agvData->taskStart());
+    touchState.setBool(TouchTaskPause, agvData->taskPause());
+    touchState.setBool(TouchTaskResume, agvData->taskResume());
+    touchState.setBool(TouchChargeCmd, agvData->chargeCmd());
+    touchState.setInt(TouchManualDir, manualDir);
+    touchState.setInt(TouchManualAct, agvData->manualAct());
+    touchState.setInt(TouchManualVy, agvData->manualVy());
+    touchState.setInt(TouchIniX, agvData->iniX());
+    touchState.setInt(TouchIniY, agvData->iniY());
+    touchState.setInt(TouchIniW, agvData->iniW());
+    touchState.setInt(TouchMusic, agvData->music());
     // 根据 manualDir 额外处理 manual_vx 和 manual_vth
-    if (agvData->manualDir() == 1 || agvData->manualDir() == 2)
+    if (manualDir == 1 || manualDir == 2)
     {
         // 前进、后退
-        body.insert("manual_vx", agvData->manualVx());
-        body.insert("manual_vth", 0);
+        touchState.setInt(TouchManualVx, agvData->manualVx());
+        touchState.setInt(TouchManualVth, 0);
     }
-    else if (agvData->manualDir() == 5 || agvData->manualDir() == 6 || agvData->manualDir() == 7 || agvData->manualDir() == 8)
+    else if (manualDir == 5 || manualDir == 6 || manualDir == 7 || manualDir == 8)
     {
         // 左前、右前、左后、右后
-        body.insert("manual_vx", agvData->manualVx());
-        body.insert("manual_vth", cfg->arcVw());
+        touchState.setInt(TouchManualVx, agvData->manualVx());
+        touchState.setInt(TouchManualVth, cfg->arcVw());
     }
-    else if (agvData->manualDir() == 3 || agvData->manualDir() == 4)
+    else if (manualDir == 3 || manualDir == 4)
     {
         // 逆自、顺自
-        body.insert("manual_vx", agvData->manualVx());
-        body.insert("manual_vth", cfg->spinVw());
+        touchState.setInt(TouchManualVx, agvData->manualVx());
+        touchState.setInt(TouchManualVth, cfg->spinVw());
     }
     else
     {
         // 静止
-        body.insert("manual_vx", 0);
-        body.insert("manual_vth", 0);
+        touchState.setInt(TouchManualVx, 0);
+        touchState.setInt(TouchManualVth, 0);
     }
 
     // 仅在 page_control 开启且按下移动按键时才打印
-    if (agvData->pageControl() && agvData->manualDir() != 0 && agvData->manualDir() != lastDir)
-    {
-        QJsonDocument docBody(body);
-        QString bodyStr = docBody.toJson(QJsonDocument::Compact);
-        logger->log(QStringLiteral("CommunicationWsClient"), spdlog::level::info, QStringLiteral("TOUCH_STATE Body: %1").arg(bodyStr));
-    }
+    bool print = agvData->pageControl() && manualDir != 0 && manualDir != lastDir;
 
-    lastDir = agvData->manualDir();
-    return body;
+    lastDir = manualDir;
+    return print;
 }
 
 // --- 内部槽函数实现 ---
@@ -205,27 +331,134 @@ QJsonObject CommunicationWsClient::getTouchStateBody()
 void CommunicationWsClient::onInternalConnected()
 {
     logger->log(QStringLiteral("CommunicationWsClient"), spdlog::level::info, QStringLiteral("连接建立"));
+    m_connected = true;
     emit connectionStatusChanged(true);
 
+    // 连接后立即同步一次 TOUCH_STATE，并启动心跳
+    sendTouchState();
+
+    // 时延统计按连接重新开始
+    m_latency.reset();
+    m_latencyReportTimer->start();
+
     // 连接成功后，自动启动定时器
     if (!m_pollTimer->isActive())
     {
         m_pollTimer->start();
     }
+
+    // 启用 CBOR 时先协商编码，确认之前仍使用 JSON 文本帧
+    m_binaryFraming = false;
+    if (cfg->commCbor())
+    {
+        sendEncodingRequest();
+    }
+
+    // 启用订阅模式时尝试订阅，控制器确认之前仍按轮询方式工作
+    m_subscribed = false;
+    if (cfg->commSubscribe())
+    {
+        sendSubscribeRequest();
+    }
 }
 
 void CommunicationWsClient::onInternalDisconnected()
 {
     logger->log(QStringLiteral("CommunicationWsClient"), spdlog::level::err, QStringLiteral("连接断开"));
+    m_connected = false;
     emit connectionStatusChanged(false);
 
     // 连接断开后，自动停止定时器
     // 这样避免了在断网情况下程序还在空转做 JSON 序列化
     m_pollTimer->stop();
+    m_touchHeartbeatTimer->stop();
+    m_latencyReportTimer->stop();
+    emit linkLatencyUpdated(LinkLatencyStats());
+
+    // 订阅和帧编码随连接失效，重连后重新协商
+    m_subscribeAckTimer->stop();
+    m_pushWatchdogTimer->stop();
+    m_subscribed = false;
+    m_encodingAckTimer->stop();
+    m_binaryFraming = false;
+}
+
+void CommunicationWsClient::onSubscribeAck(bool accepted, int rateMs)
+{
+    // 未在等待应答（例如超时之后才到达），忽略
+    if (!m_subscribeAckTimer->isActive())
+        return;
+    m_subscribeAckTimer->stop();
+
+    if (accepted)
+    {
+        m_subscribed = true;
+        m_pollTimer->stop(); // TOUCH_STATE 由心跳维持，轮询定时器不再需要
+        m_latency.reset();   // 推送帧不回显请求的数据戳，不再统计往返时延
+
+        // 从确认时刻开始计算推送间隔，检查周期取超时的一半
+        m_pushTimeoutMs = rateMs > 0 ? qMax(PUSH_WATCHDOG_MIN_MS, PUSH_WATCHDOG_RATE_MULTIPLE * rateMs) : PUSH_WATCHDOG_ON_CHANGE_MS;
+        m_lastResponseMs.store(m_pushClock.elapsed(), std::memory_order_relaxed);
+        m_pushWatchdogTimer->start(m_pushTimeoutMs / 2);
+        logger->log(QStringLiteral("CommunicationWsClient"), spdlog::level::info, QStringLiteral("订阅成功，控制器推送周期 %1 ms，停止轮询 AGV_STATE / AGV_TASK").arg(rateMs));
+    }
+    else
+    {
+        logger->log(QStringLiteral("CommunicationWsClient"), spdlog::level::warn, QStringLiteral("控制器拒绝订阅，继续使用轮询"));
+    }
+}
+
+void CommunicationWsClient::onSubscribeAckTimeout()
+{
+    logger->log(QStringLiteral("CommunicationWsClient"), spdlog::level::warn, QStringLiteral("SUBSCRIBE 应答超时，控制器可能不支持订阅模式，继续使用轮询"));
+}
+
+void CommunicationWsClient::onPushWatchdog()
+{
+    if (!m_subscribed)
+    {
+        m_pushWatchdogTimer->stop();
+        return;
+    }
+
+    const qint64 silentMs = m_pushClock.elapsed() - m_lastResponseMs.load(std::memory_order_relaxed);
+    if (silentMs < m_pushTimeoutMs)
+        return;
+
+    // 推送中断：立即恢复轮询，再重新订阅；控制器重新确认后推送恢复，否则保持轮询
+    m_pushWatchdogTimer->stop();
+    m_subscribed = false;
+    m_pollTimer->start();
+    logger->log(QStringLiteral("CommunicationWsClient"), spdlog::level::warn, QStringLiteral("订阅推送 %1 ms 未收到 AGV_STATE / AGV_TASK，回退到轮询并重新订阅").arg(silentMs));
+    sendSubscribeRequest();
+}
+
+
+void CommunicationWsClient::onEncodingAck(bool accepted, const QString &encoding)
+{
+    // 未在等待应答（例如超时之后才到达），忽略
+    if (!m_encodingAckTimer->isActive())
+        return;
+    m_encodingAckTimer->stop();
+
+    if (accepted && encoding.compare(QLatin1String("CBOR"), Qt::CaseInsensitive) == 0)
+    {
+        m_binaryFraming = true;
+        logger->log(QStringLiteral("CommunicationWsClient"), spdlog::level::info, QStringLiteral("控制器确认 CBOR 编码，改用二进制帧通讯"));
+    }
+    else
+    {
+        logger->log(QStringLiteral("CommunicationWsClient"), spdlog::level::warn, QStringLiteral("控制器拒绝 CBOR 编码，继续使用 JSON"));
+    }
+}
+
+void CommunicationWsClient::onEncodingAckTimeout()
+{
+    logger->log(QStringLiteral("CommunicationWsClient"), spdlog::level::warn, QStringLiteral("SET_ENCODING 应答超时，控制器可能不支持 CBOR，继续使用 JSON"));
 }
 
-void CommunicationWsClient::onInternalTextReceived(const QString &msg)
+void CommunicationWsClient::onLatencyReport()
 {
-    // 处理接收到的消息
-    emit textReceived(msg);
+    LinkLatencyStats stats = m_latency.stats();
+    emit linkLatencyUpdated(stats);
 }
\ No newline at end of file
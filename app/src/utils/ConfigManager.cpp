@@ -37,10 +37,18 @@ void ConfigManager::load()
     // 网络通讯
     m_commIp = settings.value("Network/CommIp", "host.docker.internal").toString();
     m_commPort = settings.value("Network/CommPort", 9001).toInt();
+    m_commSubscribe = settings.value("Network/CommSubscribe", false).toBool();
+    m_commSubscribeRateMs = settings.value("Network/CommSubscribeRateMs", 0).toInt();
+    m_commTouchHeartbeatMs = settings.value("Network/CommTouchHeartbeatMs", 200).toInt();
+    m_commCbor = settings.value("Network/CommCbor", false).toBool();
+    m_networkThreads = settings.value("Network/NetworkThreads", 1).toInt();
     m_truckLoadingIp = settings.value("Network/TruckLoadingIp", "host.docker.internal").toString();
     m_truckLoadingPort = settings.value("Network/TruckLoadingPort", 9002).toInt();
     m_rosbridgeIp = settings.value("Network/RosBridgeIp", "host.docker.internal").toString();
     m_rosbridgePort = settings.value("Network/RosBridgePort", 9090).toInt();
+    m_rosIdleLaserPointsMs = settings.value("Network/RosIdleLaserPointsMs", -1).toInt();
+    m_rosIdleAgvStateMs = settings.value("Network/RosIdleAgvStateMs", 1000).toInt();
+    m_rosLiveMap = settings.value("Network/RosLiveMap", false).toBool();
     m_serverIp = settings.value("Network/ServerIP", "192.168.1.1").toString();
     m_serverPort = settings.value("Network/ServerPort", 8080).toInt();
     // 其他通讯
@@ -51,6 +59,11 @@ void ConfigManager::load()
     m_defaultFixedRelocation = settings.value("System/DefaultFixedRelocation", false).toBool();
     m_debugMode = settings.value("System/DebugMode", false).toBool();
     m_fullScreen = settings.value("System/FullScreen", false).toBool();
+    m_trafficCapture = settings.value("System/TrafficCapture", 0).toInt();
+    m_trafficRingMinutes = settings.value("System/TrafficRingMinutes", 10).toInt();
+    m_cloudTrailScans = settings.value("System/CloudTrailScans", 0).toInt();
+    m_cloudTrailMemoryMb = settings.value("System/CloudTrailMemoryMb", 8).toInt();
+    m_relocationMinFit = settings.value("System/RelocationMinFit", 40).toInt();
 }
 
 void ConfigManager::save()
@@ -77,10 +90,18 @@ void ConfigManager::save()
     // 网络通讯
     settings.setValue("Network/CommIp", m_commIp);
     settings.setValue("Network/CommPort", m_commPort.load());
+    settings.setValue("Network/CommSubscribe", m_commSubscribe.load());
+    settings.setValue("Network/CommSubscribeRateMs", m_commSubscribeRateMs.load());
+    settings.setValue("Network/CommTouchHeartbeatMs", m_commTouchHeartbeatMs.load());
+    settings.setValue("Network/CommCbor", m_commCbor.load());
+    settings.setValue("Network/NetworkThreads", m_networkThreads.load());
     settings.setValue("Network/TruckLoadingIp", m_truckLoadingIp);
     settings.setValue("Network/TruckLoadingPort", m_truckLoadingPort.load());
     settings.setValue("Network/RosBridgeIp", m_rosbridgeIp);
     settings.setValue("Network/RosBridgePort", m_rosbridgePort.load());
+    settings.setValue("Network/RosIdleLaserPointsMs", m_rosIdleLaserPointsMs.load());
+    settings.setValue("Network/RosIdleAgvStateMs", m_rosIdleAgvStateMs.load());
+    settings.setValue("Network/RosLiveMap", m_rosLiveMap.load());
     settings.setValue("Network/ServerIP", m_serverIp);
     settings.setValue("Network/ServerPort", m_serverPort.load());
     // 其他通讯
@@ -91,6 +112,11 @@ void ConfigManager::save()
     settings.setValue("System/DefaultFixedRelocation", m_defaultFixedRelocation.load());
     settings.setValue("System/DebugMode", m_debugMode.load());
     settings.setValue("System/FullScreen", m_fullScreen.load());
+    settings.setValue("System/TrafficCapture", m_trafficCapture.load());
+    settings.setValue("System/TrafficRingMinutes", m_trafficRingMinutes.load());
+    settings.setValue("System/CloudTrailScans", m_cloudTrailScans.load());
+    settings.setValue("System/CloudTrailMemoryMb", m_cloudTrailMemoryMb.load());
+    settings.setValue("System/RelocationMinFit", m_relocationMinFit.load());
 
     settings.sync(); // 强制写入磁盘
 
@@ -177,6 +203,26 @@ int ConfigManager::commPort() const
 {
     return m_commPort.load();
 }
+bool ConfigManager::commSubscribe() const
+{
+    return m_commSubscribe.load();
+}
+int ConfigManager::commSubscribeRateMs() const
+{
+    return m_commSubscribeRateMs.load();
+}
+int ConfigManager::commTouchHeartbeatMs() const
+{
+    return m_commTouchHeartbeatMs.load();
+}
+bool ConfigManager::commCbor() const
+{
+    return m_commCbor.load();
+}
+int ConfigManager::networkThreads() const
+{
+    return m_networkThreads.load();
+}
 QString ConfigManager::truckLoadingIp() const
 {
     QReadLocker locker(&m_lock);
@@ -195,6 +241,18 @@ int ConfigManager::rosBridgePort() const
 {
     return m_rosbridgePort.load();
 }
+int ConfigManager::rosIdleLaserPointsMs() const
+{
+    return m_rosIdleLaserPointsMs.load();
+}
+int ConfigManager::rosIdleAgvStateMs() const
+{
+    return m_rosIdleAgvStateMs.load();
+}
+bool ConfigManager::rosLiveMap() const
+{
+    return m_rosLiveMap.load();
+}
 QString ConfigManager::serverIp() const
 {
     QReadLocker locker(&m_lock);
@@ -235,6 +293,26 @@ bool ConfigManager::fullScreen() const
 {
     return m_fullScreen.load();
 }
+int ConfigManager::trafficCapture() const
+{
+    return m_trafficCapture.load();
+}
+int ConfigManager::trafficRingMinutes() const
+{
+    return m_trafficRingMinutes.load();
+}
+int ConfigManager::cloudTrailScans() const
+{
+    return m_cloudTrailScans.load();
+}
+int ConfigManager::cloudTrailMemoryMb() const
+{
+    return m_cloudTrailMemoryMb.load();
+}
+int ConfigManager::relocationMinFit() const
+{
+    return m_relocationMinFit.load();
+}
 
 // --- Setters 实现 ---
 // 车体参数
@@ -304,6 +382,26 @@ void ConfigManager::setCommPort(int port)
 {
     m_commPort.store(port);
 }
+void ConfigManager::setCommSubscribe(bool enable)
+{
+    m_commSubscribe.store(enable);
+}
+void ConfigManager::setCommSubscribeRateMs(int rateMs)
+{
+    m_commSubscribeRateMs.store(rateMs);
+}
+void ConfigManager::setCommTouchHeartbeatMs(int intervalMs)
+{
+    m_commTouchHeartbeatMs.store(intervalMs);
+}
+void ConfigManager::setCommCbor(bool enable)
+{
+    m_commCbor.store(enable);
+}
+void ConfigManager::setNetworkThreads(int count)
+{
+    m_networkThreads.store(count);
+}
 void ConfigManager::setTruckLoadingIp(const QString &ip)
 {
     QWriteLocker locker(&m_lock);
@@ -322,6 +420,18 @@ void ConfigManager::setRosBridgePort(int port)
 {
     m_rosbridgePort.store(port);
 }
+void ConfigManager::setRosIdleLaserPointsMs(int ms)
+{
+    m_rosIdleLaserPointsMs.store(ms);
+}
+void ConfigManager::setRosIdleAgvStateMs(int ms)
+{
+    m_rosIdleAgvStateMs.store(ms);
+}
+void ConfigManager::setRosLiveMap(bool enable)
+{
+    m_rosLiveMap.store(enable);
+}
 void ConfigManager::setServerIp(const QString &ip)
 {
     QWriteLocker locker(&m_lock);
@@ -362,4 +472,24 @@ void ConfigManager::setDebugMode(bool enable)
 void ConfigManager::setFullScreen(bool enable)
 {
     m_fullScreen.store(enable);
+}
+void ConfigManager::setTrafficCapture(int mode)
+{
+    m_trafficCapture.store(mode);
+}
+void ConfigManager::setTrafficRingMinutes(int minutes)
+{
+    m_trafficRingMinutes.store(minutes);
+}
+void ConfigManager::setCloudTrailScans(int scans)
+{
+    m_cloudTrailScans.store(scans);
+}
+void ConfigManager::setCloudTrailMemoryMb(int mb)
+{
+    m_cloudTrailMemoryMb.store(mb);
+}
+void ConfigManager::setRelocationMinFit(int percent)
+{
+    m_relocationMinFit.store(percent);
 }
\ No newline at end of file
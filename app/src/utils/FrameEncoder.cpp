@@ -0,0 +1,492 @@
+#include "FrameEncoder.h"
+#include <QDateTime>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+
+namespace
+{
+    // CBOR 头部：主类型 + 参数，按最短形式编码
+    void appendCborHead(QByteArray &out, quint8 major, quint64 value)
+    {
+        const char type = static_cast<char>(major << 5);
+        if (value < 24)
+        {
+            out.append(static_cast<char>(type | value));
+            return;
+        }
+
+        int bytes;
+        if (value <= 0xff)
+        {
+            out.append(static_cast<char>(type | 24));
+            bytes = 1;
+        }
+        else if (value <= 0xffff)
+        {
+            out.append(static_cast<char>(type | 25));
+            bytes = 2;
+        }
+        else if (value <= 0xffffffffULL)
+        {
+            out.append(static_cast<char>(type | 26));
+            bytes = 4;
+        }
+        else
+        {
+            out.append(static_cast<char>(type | 27));
+            bytes = 8;
+        }
+        for (int i = bytes - 1; i >= 0; --i)
+            out.append(static_cast<char>((value >> (i * 8)) & 0xff));
+    }
+
+    void appendCborInt(QByteArray &out, qint64 value)
+    {
+        if (value >= 0)
+            appendCborHead(out, 0, static_cast<quint64>(value));
+        else
+            appendCborHead(out, 1, static_cast<quint64>(-1 - value));
+    }
+
+    void appendCborDouble(QByteArray &out, double value)
+    {
+        quint64 bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        out.append(static_cast<char>(0xfb));
+        for (int i = 7; i >= 0; --i)
+            out.append(static_cast<char>((bits >> (i * 8)) & 0xff));
+    }
+
+    QByteArray cborText(const QString &text)
+    {
+        const QByteArray utf8 = text.toUtf8();
+        QByteArray out;
+        appendCborHead(out, 3, static_cast<quint64>(utf8.size()));
+        out.append(utf8);
+        return out;
+    }
+
+    QString jsonString(const QString &text)
+    {
+        QString out = QStringLiteral("\"");
+        for (const QChar c : text)
+        {
+            switch (c.unicode())
+            {
+            case '"':
+                out += QLatin1String("\\\"");
+                break;
+            case '\\':
+                out += QLatin1String("\\\\");
+                break;
+            case '\n':
+                out += QLatin1String("\\n");
+                break;
+            case '\r':
+                out += QLatin1String("\\r");
+                break;
+            case '\t':
+                out += QLatin1String("\\t");
+                break;
+            default:
+                if (c.unicode() < 0x20)
+                    out += QStringLiteral("\\u%1").arg(c.unicode(), 4, 16, QLatin1Char('0'));
+                else
+                    out += c;
+            }
+        }
+        out += QLatin1Char('"');
+        return out;
+    }
+
+    // 以下格式化只写入栈上的缓冲区，不产生堆分配
+    int formatInt(char *buf, qint64 value)
+    {
+        const std::to_chars_result res = std::to_chars(buf, buf + 24, value);
+        return static_cast<int>(res.ptr - buf);
+    }
+
+    // 与 QJsonDocument 一致：最短往返表示，非有限值写为 null
+    int formatDouble(char *buf, double value)
+    {
+        if (!std::isfinite(value))
+        {
+            std::memcpy(buf, "null", 4);
+            return 4;
+        }
+        const std::to_chars_result res = std::to_chars(buf, buf + 32, value);
+        return static_cast<int>(res.ptr - buf);
+    }
+
+    void put2(char *p, int v)
+    {
+        p[0] = static_cast<char>('0' + v / 10);
+        p[1] = static_cast<char>('0' + v % 10);
+    }
+
+    // "yyyy-MM-dd hh:mm:ss.zzz"，固定 23 个字符
+    constexpr int DATE_TIME_LEN = 23;
+    void formatDateTime(char *buf)
+    {
+        const QDateTime now = QDateTime::currentDateTime();
+        const QDate date = now.date();
+        const QTime time = now.time();
+
+        const int year = date.year();
+        buf[0] = static_cast<char>('0' + year / 1000 % 10);
+        buf[1] = static_cast<char>('0' + year / 100 % 10);
+        put2(buf + 2, year % 100);
+        buf[4] = '-';
+        put2(buf + 5, date.month());
+        buf[7] = '-';
+        put2(buf + 8, date.day());
+        buf[10] = ' ';
+        put2(buf + 11, time.hour());
+        buf[13] = ':';
+        put2(buf + 14, time.minute());
+        buf[16] = ':';
+        put2(buf + 17, time.second());
+        buf[19] = '.';
+        const int ms = time.msec();
+        buf[20] = static_cast<char>('0' + ms / 100);
+        put2(buf + 21, ms % 100);
+    }
+}
+
+// ---- 构建模板 ----
+
+void FrameEncoder::appendLiteral(const QString &json, const QByteArray &cbor)
+{
+    if (!m_ops.isEmpty() && m_ops.last().kind == OpKind::Literal)
+    {
+        Op &last = m_ops.last();
+        last.json += json;
+        last.cbor += cbor;
+        return;
+    }
+
+    Op op;
+    op.kind = OpKind::Literal;
+    op.json = json;
+    op.cbor = cbor;
+    m_ops.append(op);
+}
+
+void FrameEncoder::appendOp(OpKind kind, int slot)
+{
+    Op op;
+    op.kind = kind;
+    op.slot = slot;
+    m_ops.append(op);
+}
+
+int FrameEncoder::addSlot(OpKind kind)
+{
+    Slot slot;
+    slot.kind = kind;
+    m_slots.append(slot);
+    return m_slots.size() - 1;
+}
+
+// 值之前的逗号：键之后的值不需要，数组中除第一个外都需要
+void FrameEncoder::beforeValue()
+{
+    if (m_afterKey)
+    {
+        m_afterKey = false;
+        return;
+    }
+    if (!m_first.isEmpty())
+    {
+        if (!m_first.last())
+            appendLiteral(QStringLiteral(","), QByteArray());
+        m_first.last() = false;
+    }
+}
+
+void FrameEncoder::beginObject(int size)
+{
+    beforeValue();
+    QByteArray head;
+    appendCborHead(head, 5, static_cast<quint64>(size));
+    appendLiteral(QStringLiteral("{"), head);
+    m_first.append(true);
+}
+
+void FrameEncoder::endObject()
+{
+    m_first.removeLast();
+    appendLiteral(QStringLiteral("}"), QByteArray());
+}
+
+void FrameEncoder::beginArray(int size)
+{
+    beforeValue();
+    QByteArray head;
+    appendCborHead(head, 4, static_cast<quint64>(size));
+    appendLiteral(QStringLiteral("["), head);
+    m_first.append(true);
+}
+
+void FrameEncoder::endArray()
+{
+    m_first.removeLast();
+    appendLiteral(QStringLiteral("]"), QByteArray());
+}
+
+void FrameEncoder::key(const QString &name)
+{
+    if (!m_first.last())
+        appendLiteral(QStringLiteral(","), QByteArray());
+    m_first.last() = false;
+    appendLiteral(jsonString(name) + QLatin1Char(':'), cborText(name));
+    m_afterKey = true;
+}
+
+void FrameEncoder::literal(const QString &value)
+{
+    beforeValue();
+    appendLiteral(jsonString(value), cborText(value));
+}
+
+void FrameEncoder::literal(bool value)
+{
+    beforeValue();
+    appendLiteral(value ? QStringLiteral("true") : QStringLiteral("false"),
+                  QByteArray(1, static_cast<char>(value ? 0xf5 : 0xf4)));
+}
+
+void FrameEncoder::literal(int value)
+{
+    beforeValue();
+    QByteArray cbor;
+    appendCborInt(cbor, value);
+    appendLiteral(QString::number(value), cbor);
+}
+
+void FrameEncoder::literal(double value)
+{
+    beforeValue();
+    char buf[32];
+    const int len = formatDouble(buf, value);
+    QByteArray cbor;
+    appendCborDouble(cbor, value);
+    appendLiteral(QString::fromLatin1(buf, len), cbor);
+}
+
+int FrameEncoder::intSlot()
+{
+    beforeValue();
+    const int slot = addSlot(OpKind::Int);
+    appendOp(OpKind::Int, slot);
+    return slot;
+}
+
+int FrameEncoder::boolSlot()
+{
+    beforeValue();
+    const int slot = addSlot(OpKind::Bool);
+    appendOp(OpKind::Bool, slot);
+    return slot;
+}
+
+int FrameEncoder::doubleSlot()
+{
+    beforeValue();
+    const int slot = addSlot(OpKind::Double);
+    appendOp(OpKind::Double, slot);
+    return slot;
+}
+
+void FrameEncoder::dateTimeSlot()
+{
+    beforeValue();
+    appendOp(OpKind::DateTime, -1);
+}
+
+void FrameEncoder::stampsSlot()
+{
+    beforeValue();
+    appendOp(OpKind::Stamps, -1);
+}
+
+// ---- 每次发送 ----
+
+void FrameEncoder::setInt(int slot, int value)
+{
+    m_slots[slot].intValue = value;
+}
+
+void FrameEncoder::setBool(int slot, bool value)
+{
+    m_slots[slot].boolValue = value;
+}
+
+void FrameEncoder::setDouble(int slot, double value)
+{
+    m_slots[slot].doubleValue = value;
+}
+
+void FrameEncoder::setStamps(qint64 stamps)
+{
+    m_stamps = stamps;
+}
+
+const QString &FrameEncoder::encodeJson()
+{
+    // 先按历史最大长度预留再清空：缓冲区仍被发送队列共享时只在这里分离一次
+    m_json.reserve(m_jsonHint);
+    m_json.resize(0);
+
+    char buf[32];
+    for (const Op &op : qAsConst(m_ops))
+    {
+        switch (op.kind)
+        {
+        case OpKind::Literal:
+            m_json.append(op.json);
+            break;
+        case OpKind::Int:
+            m_json.append(QLatin1String(buf, formatInt(buf, m_slots.at(op.slot).intValue)));
+            break;
+        case OpKind::Bool:
+            m_json.append(m_slots.at(op.slot).boolValue ? QLatin1String("true") : QLatin1String("false"));
+            break;
+        case OpKind::Double:
+            m_json.append(QLatin1String(buf, formatDouble(buf, m_slots.at(op.slot).doubleValue)));
+            break;
+        case OpKind::DateTime:
+            formatDateTime(buf);
+            m_json.append(QLatin1Char('"'));
+            m_json.append(QLatin1String(buf, DATE_TIME_LEN));
+            m_json.append(QLatin1Char('"'));
+            break;
+        case OpKind::Stamps:
+            m_json.append(QLatin1String(buf, formatInt(buf, m_stamps)));
+            break;
+        }
+    }
+
+    m_jsonHint = qMax(m_jsonHint, m_json.size());
+    return m_json;
+}
+
+const QByteArray &FrameEncoder::encodeCbor()
+{
+    m_cbor.reserve(m_cborHint);
+    m_cbor.resize(0);
+
+    char buf[DATE_TIME_LEN];
+    for (const Op &op : qAsConst(m_ops))
+    {
+        switch (op.kind)
+        {
+        case OpKind::Literal:
+            m_cbor.append(op.cbor);
+            break;
+        case OpKind::Int:
+            appendCborInt(m_cbor, m_slots.at(op.slot).intValue);
+            break;
+        case OpKind::Bool:
+            m_cbor.append(static_cast<char>(m_slots.at(op.slot).boolValue ? 0xf5 : 0xf4));
+            break;
+        case OpKind::Double:
+            appendCborDouble(m_cbor, m_slots.at(op.slot).doubleValue);
+            break;
+        case OpKind::DateTime:
+            formatDateTime(buf);
+            appendCborHead(m_cbor, 3, DATE_TIME_LEN);
+            m_cbor.append(buf, DATE_TIME_LEN);
+            break;
+        case OpKind::Stamps:
+            appendCborInt(m_cbor, m_stamps);
+            break;
+        }
+    }
+
+    m_cborHint = qMax(m_cborHint, m_cbor.size());
+    return m_cbor;
+}
+
+const QString &FrameEncoder::lastJson() const
+{
+    return m_json;
+}
+
+const QByteArray &FrameEncoder::lastCbor() const
+{
+    return m_cbor;
+}
+
+// ---- 控制器协议帧 ----
+
+namespace
+{
+    // 外壳中 Body 之后的部分
+    void controllerTail(FrameEncoder &enc, const QString &event)
+    {
+        enc.key(QStringLiteral("DataStamps"));
+        enc.stampsSlot();
+        enc.key(QStringLiteral("DateTime"));
+        enc.dateTimeSlot();
+        enc.key(QStringLiteral("ErrorMessage"));
+        enc.literal(QString());
+        enc.key(QStringLiteral("Event"));
+        enc.literal(event);
+        enc.key(QStringLiteral("IsSucceed"));
+        enc.literal(true);
+        enc.endObject();
+    }
+}
+
+FrameEncoder ControllerFrames::request(const QString &event)
+{
+    FrameEncoder enc;
+    enc.beginObject(6);
+    enc.key(QStringLiteral("Body"));
+    enc.literal(QString());
+    controllerTail(enc, event);
+    return enc;
+}
+
+FrameEncoder ControllerFrames::touchState()
+{
+    struct Field
+    {
+        const char *key;
+        bool isBool;
+    };
+    static const Field fields[TouchSlotCount] = {
+        {"charge_cmd", true},
+        {"ini_w", false},
+        {"ini_x", false},
+        {"ini_y", false},
+        {"manual_act", false},
+        {"manual_dir", false},
+        {"manual_vth", false},
+        {"manual_vx", false},
+        {"manual_vy", false},
+        {"music", false},
+        {"page_control", true},
+        {"task_cancel", true},
+        {"task_pause", true},
+        {"task_resume", true},
+        {"task_start", true},
+    };
+
+    FrameEncoder enc;
+    enc.beginObject(6);
+    enc.key(QStringLiteral("Body"));
+    enc.beginObject(TouchSlotCount);
+    for (const Field &field : fields)
+    {
+        enc.key(QLatin1String(field.key));
+        const int slot = field.isBool ? enc.boolSlot() : enc.intSlot();
+        Q_UNUSED(slot);
+        Q_ASSERT(slot == static_cast<int>(&field - fields));
+    }
+    enc.endObject();
+    controllerTail(enc, QStringLiteral("TOUCH_STATE"));
+    return enc;
+}
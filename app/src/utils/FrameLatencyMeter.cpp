@@ -0,0 +1,43 @@
+#include "FrameLatencyMeter.h"
+#include <algorithm>
+#include <chrono>
+
+qint64 FrameLatencyMeter::nowUs()
+{
+    using namespace std::chrono;
+    return duration_cast<microseconds>(system_clock::now().time_since_epoch()).count();
+}
+
+void FrameLatencyMeter::record(qint64 stampUs)
+{
+    if (stampUs < 0)
+        return;
+
+    const qint64 latency = nowUs() - stampUs;
+    if (latency < 0 || latency > MAX_VALID_US)
+    {
+        m_discarded++;
+        return;
+    }
+
+    m_latencyUs[m_next] = latency;
+    m_next = (m_next + 1) % WINDOW_SIZE;
+    m_count = std::min(m_count + 1, WINDOW_SIZE);
+    m_total++;
+}
+
+FrameLatencyStats FrameLatencyMeter::stats() const
+{
+    FrameLatencyStats result;
+    static_cast<LatencyPercentiles &>(result) = computeLatencyPercentiles(m_latencyUs.mid(0, m_count), 1.0e3);
+    result.recorded = m_total;
+    result.discarded = m_discarded;
+    return result;
+}
+
+void FrameLatencyMeter::reset()
+{
+    m_next = 0;
+    m_count = 0;
+    m_discarded = 0;
+}
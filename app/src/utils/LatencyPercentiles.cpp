@@ -0,0 +1,28 @@
+#include "LatencyPercentiles.h"
+#include <algorithm>
+
+namespace
+{
+    // 从已排序的样本中取分位数（最近秩法）
+    qint64 percentile(const QVector<qint64> &sorted, double p)
+    {
+        int rank = static_cast<int>(p * sorted.size() + 0.999999) - 1;
+        rank = std::max(0, std::min(rank, static_cast<int>(sorted.size()) - 1));
+        return sorted[rank];
+    }
+}
+
+LatencyPercentiles computeLatencyPercentiles(QVector<qint64> samples, double unitsPerMs)
+{
+    LatencyPercentiles result;
+    result.samples = samples.size();
+    if (samples.isEmpty())
+        return result;
+
+    std::sort(samples.begin(), samples.end());
+    result.p50Ms = percentile(samples, 0.50) / unitsPerMs;
+    result.p95Ms = percentile(samples, 0.95) / unitsPerMs;
+    result.p99Ms = percentile(samples, 0.99) / unitsPerMs;
+    result.maxMs = samples.last() / unitsPerMs;
+    return result;
+}
@@ -0,0 +1,109 @@
+#include "LinkLatencyTracker.h"
+#include "LatencyPercentiles.h"
+#include <algorithm>
+
+LinkLatencyTracker::LinkLatencyTracker()
+    : m_ring(RING_SIZE), m_rttNs(WINDOW_SIZE, 0)
+{
+    m_clock.start();
+}
+
+void LinkLatencyTracker::reset()
+{
+    QMutexLocker locker(&m_mutex);
+    m_ring.fill(Slot());
+    m_rttNext = 0;
+    m_rttCount = 0;
+    m_maxReceivedStamp = -1;
+    m_sent = 0;
+    m_received = 0;
+    m_lost = 0;
+    m_outOfOrder = 0;
+}
+
+void LinkLatencyTracker::markSent(qint64 stamp, quint32 expected)
+{
+    if (stamp < 0 || expected == 0)
+        return;
+
+    QMutexLocker locker(&m_mutex);
+    Slot &slot = m_ring[static_cast<int>(stamp % RING_SIZE)];
+
+    // 环形表回绕时仍未应答，说明该请求已经丢失
+    if (slot.state == SlotState::Pending)
+        m_lost++;
+
+    slot.stamp = stamp;
+    slot.sentNs = m_clock.nsecsElapsed();
+    slot.pending = expected;
+    slot.state = SlotState::Pending;
+    m_sent++;
+}
+
+void LinkLatencyTracker::markReceived(qint64 stamp, quint32 response)
+{
+    if (stamp < 0)
+        return;
+
+    const qint64 nowNs = m_clock.nsecsElapsed();
+
+    QMutexLocker locker(&m_mutex);
+    Slot &slot = m_ring[static_cast<int>(stamp % RING_SIZE)];
+    if (slot.state != SlotState::Pending || slot.stamp != stamp || (slot.pending & response) == 0)
+        return;
+
+    slot.pending &= ~response;
+    if (slot.pending == 0)
+    {
+        slot.state = SlotState::Done;
+        m_received++;
+    }
+
+    m_rttNs[m_rttNext] = nowNs - slot.sentNs;
+    m_rttNext = (m_rttNext + 1) % WINDOW_SIZE;
+    m_rttCount = std::min(m_rttCount + 1, static_cast<int>(WINDOW_SIZE));
+
+    // 数据戳回绕后会从 0 重新开始，只有落在环形表范围内的更小数据戳才算乱序
+    if (stamp < m_maxReceivedStamp && m_maxReceivedStamp - stamp < RING_SIZE)
+        m_outOfOrder++;
+    else
+        m_maxReceivedStamp = stamp;
+}
+
+void LinkLatencyTracker::expireLocked(qint64 nowNs)
+{
+    const qint64 timeoutNs = LOSS_TIMEOUT_MS * 1000000;
+    for (Slot &slot : m_ring)
+    {
+        if (slot.state == SlotState::Pending && nowNs - slot.sentNs > timeoutNs)
+        {
+            slot.state = SlotState::Done;
+            m_lost++;
+        }
+    }
+}
+
+LinkLatencyStats LinkLatencyTracker::stats()
+{
+    QVector<qint64> rttNs;
+    LinkLatencyStats result;
+    {
+        QMutexLocker locker(&m_mutex);
+        expireLocked(m_clock.nsecsElapsed());
+
+        result.sent = m_sent;
+        result.received = m_received;
+        result.lost = m_lost;
+        result.outOfOrder = m_outOfOrder;
+        rttNs = m_rttNs.mid(0, m_rttCount);
+    }
+
+    // 排序放在锁外，避免阻塞通讯线程
+    const LatencyPercentiles percentiles = computeLatencyPercentiles(rttNs, 1.0e6);
+    result.samples = percentiles.samples;
+    result.p50Ms = percentiles.p50Ms;
+    result.p95Ms = percentiles.p95Ms;
+    result.p99Ms = percentiles.p99Ms;
+    result.maxMs = percentiles.maxMs;
+    return result;
+}
@@ -0,0 +1,134 @@
+#include "MapDistanceField.h"
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    const float DIST_INF = 1e20f;
+
+    // 一维平方距离变换（Felzenszwalb & Huttenlocher）：d[q] = min_p (q - p)^2 + f[p]
+    // v、z 为调用方提供的临时数组，长度分别至少为 n、n + 1
+    void squaredDistance1d(const float *f, int n, float *d, int *v, float *z)
+    {
+        int k = 0;
+        v[0] = 0;
+        z[0] = -DIST_INF;
+        z[1] = DIST_INF;
+        for (int q = 1; q < n; ++q)
+        {
+            float s = ((f[q] + static_cast<float>(q) * q) - (f[v[k]] + static_cast<float>(v[k]) * v[k])) / (2.0f * (q - v[k]));
+            while (s <= z[k])
+            {
+                --k;
+                s = ((f[q] + static_cast<float>(q) * q) - (f[v[k]] + static_cast<float>(v[k]) * v[k])) / (2.0f * (q - v[k]));
+            }
+            ++k;
+            v[k] = q;
+            z[k] = s;
+            z[k + 1] = DIST_INF;
+        }
+
+        k = 0;
+        for (int q = 0; q < n; ++q)
+        {
+            while (z[k + 1] < q)
+                ++k;
+            const float dq = static_cast<float>(q - v[k]);
+            d[q] = dq * dq + f[v[k]];
+        }
+    }
+}
+
+std::shared_ptr<const MapDistanceField> MapDistanceField::build(const QImage &map, double res, double ox, double oy)
+{
+    if (map.isNull() || res <= 0.0)
+        return nullptr;
+
+    const QImage gray = map.format() == QImage::Format_Grayscale8 ? map : map.convertToFormat(QImage::Format_Grayscale8);
+    const int w = gray.width();
+    const int h = gray.height();
+
+    auto field = std::make_shared<MapDistanceField>();
+    field->m_width = w;
+    field->m_height = h;
+    field->m_res = res;
+    field->m_ox = ox;
+    field->m_oy = oy;
+
+    // 障碍物处为 0，其余为无穷大
+    std::vector<float> sq(static_cast<size_t>(w) * h);
+    for (int y = 0; y < h; ++y)
+    {
+        const uchar *line = gray.constScanLine(y);
+        float *out = sq.data() + static_cast<size_t>(y) * w;
+        for (int x = 0; x < w; ++x)
+            out[x] = line[x] <= OCCUPIED_GRAY ? 0.0f : DIST_INF;
+    }
+
+    // 先按列、再按行做一维变换，得到二维平方欧氏距离
+    const int len = std::max(w, h);
+    std::vector<float> f(static_cast<size_t>(len)), d(static_cast<size_t>(len)), z(static_cast<size_t>(len) + 1);
+    std::vector<int> v(static_cast<size_t>(len));
+    for (int x = 0; x < w; ++x)
+    {
+        for (int y = 0; y < h; ++y)
+            f[y] = sq[static_cast<size_t>(y) * w + x];
+        squaredDistance1d(f.data(), h, d.data(), v.data(), z.data());
+        for (int y = 0; y < h; ++y)
+            sq[static_cast<size_t>(y) * w + x] = d[y];
+    }
+    for (int y = 0; y < h; ++y)
+    {
+        float *row = sq.data() + static_cast<size_t>(y) * w;
+        std::copy(row, row + w, f.begin());
+        squaredDistance1d(f.data(), w, row, v.data(), z.data());
+    }
+
+    field->m_dist.resize(sq.size());
+    for (size_t i = 0; i < sq.size(); ++i)
+    {
+        const float units = std::sqrt(sq[i]) * UNITS_PER_CELL + 0.5f;
+        field->m_dist[i] = units >= 255.0f ? 255 : static_cast<quint8>(units);
+    }
+    return field;
+}
+
+double MapDistanceField::distanceAt(double wx, double wy) const
+{
+    // 与 MapLayer 一致：图像左下角在绘制坐标 (ox, oy)，绘制坐标 y 向下
+    const double col = (wx - m_ox) / m_res;
+    const double row = m_height - (wy + m_oy) / m_res;
+    if (!(col >= 0.0 && col < m_width && row >= 0.0 && row < m_height))
+        return -1.0;
+    const quint8 units = m_dist[static_cast<size_t>(row) * m_width + static_cast<size_t>(col)];
+    return units * m_res / UNITS_PER_CELL;
+}
+
+MapDistanceField::Fit MapDistanceField::fit(const float *localXy, int n, const QPointF &pos, double rad) const
+{
+    Fit result;
+    result.points = n;
+    if (n <= 0)
+        return result;
+
+    const double c = std::cos(rad);
+    const double s = std::sin(rad);
+    double scoreSum = 0.0;
+    double distSum = 0.0;
+    int inliers = 0;
+    for (int i = 0; i < n; ++i)
+    {
+        const double lx = localXy[2 * i];
+        const double ly = localXy[2 * i + 1];
+        const double d = distanceAt(pos.x() + lx * c - ly * s, pos.y() + lx * s + ly * c);
+        if (d < 0.0 || d >= FIT_TOLERANCE_M)
+            continue;
+        scoreSum += 1.0 - d / FIT_TOLERANCE_M;
+        distSum += d;
+        ++inliers;
+    }
+
+    result.score = scoreSum / n;
+    result.meanDist = inliers > 0 ? distSum / inliers : 0.0;
+    return result;
+}
@@ -0,0 +1,130 @@
+#include "NetworkReactor.h"
+#include "ConfigManager.h"
+#include <QCoreApplication>
+
+NetworkReactor *NetworkReactor::instance()
+{
+    static NetworkReactor instance;
+    return &instance;
+}
+
+NetworkReactor::NetworkReactor(QObject *parent) : QObject(parent)
+{
+    // 线程数在启动时确定，修改配置后重启生效
+    m_sharedCount = qBound(0, ConfigManager::instance()->networkThreads(), 4);
+
+    for (int i = 0; i < m_sharedCount; ++i)
+    {
+        m_threads.append(createThread(QStringLiteral("NetIO-%1").arg(i)));
+    }
+
+    // 在 QApplication 析构前完成清理，保证对象都在自己的线程中销毁
+    if (QCoreApplication::instance())
+    {
+        connect(QCoreApplication::instance(), &QCoreApplication::aboutToQuit, this, &NetworkReactor::shutdown);
+    }
+
+    logger->log(QStringLiteral("NetworkReactor"), spdlog::level::info,
+                m_sharedCount > 0 ? QStringLiteral("网络 I/O 使用 %1 个共享线程").arg(m_sharedCount)
+                                  : QStringLiteral("网络 I/O 使用每连接独占线程"));
+}
+
+NetworkReactor::~NetworkReactor()
+{
+    shutdown();
+}
+
+QThread *NetworkReactor::createThread(const QString &name)
+{
+    QThread *thread = new QThread(this);
+    thread->setObjectName(name); // 便于在 top -H / pidstat -t 中区分
+    thread->start();
+    return thread;
+}
+
+QThread *NetworkReactor::pickThread(Placement placement)
+{
+    if (m_sharedCount == 0 || placement == Placement::Dedicated)
+    {
+        return createThread(QStringLiteral("NetIO-D%1").arg(m_dedicatedSeq++));
+    }
+
+    QThread *thread = m_threads[m_nextThread];
+    m_nextThread = (m_nextThread + 1) % m_threads.size();
+    return thread;
+}
+
+void NetworkReactor::attach(QObject *worker, Placement placement)
+{
+    if (!worker || m_shutdown)
+        return;
+
+    QThread *thread = pickThread(placement);
+    worker->moveToThread(thread);
+    m_workers.insert(worker, thread);
+}
+
+void NetworkReactor::detach(QObject *worker)
+{
+    // 不在表中：已经由 shutdown 销毁
+    auto it = m_workers.find(worker);
+    if (it == m_workers.end())
+        return;
+
+    QThread *thread = it.value();
+    m_workers.erase(it);
+    destroyWorker(worker, thread);
+
+    // 独占线程随对象一起结束
+    if (!m_threads.contains(thread))
+    {
+        thread->quit();
+        thread->wait();
+        delete thread;
+    }
+}
+
+void NetworkReactor::destroyWorker(QObject *worker, QThread *thread)
+{
+    if (thread->isRunning() && thread != QThread::currentThread())
+    {
+        // socket 及其定时器必须在所属线程中析构
+        QMetaObject::invokeMethod(worker, [worker]()
+                                  { delete worker; }, Qt::BlockingQueuedConnection);
+    }
+    else
+    {
+        delete worker;
+    }
+}
+
+int NetworkReactor::threadCount() const
+{
+    int dedicated = 0;
+    for (QThread *thread : m_workers)
+    {
+        if (!m_threads.contains(thread))
+            dedicated++;
+    }
+    return m_threads.size() + dedicated;
+}
+
+void NetworkReactor::shutdown()
+{
+    if (m_shutdown)
+        return;
+    m_shutdown = true;
+
+    // 先销毁仍在托管中的对象，再停止线程
+    const QList<QObject *> workers = m_workers.keys();
+    for (QObject *worker : workers)
+    {
+        detach(worker);
+    }
+
+    for (QThread *thread : qAsConst(m_threads))
+    {
+        thread->quit();
+        thread->wait();
+    }
+}
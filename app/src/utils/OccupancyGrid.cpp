@@ -0,0 +1,48 @@
+#include "OccupancyGrid.h"
+
+namespace
+{
+    struct GrayLut
+    {
+        uchar table[256];
+
+        GrayLut()
+        {
+            for (int i = 0; i < 256; ++i)
+            {
+                const int v = static_cast<qint8>(static_cast<quint8>(i));
+                table[i] = (v >= 0 && v <= 100) ? static_cast<uchar>(254 - (v * 254 + 50) / 100)
+                                                : OccupancyGrid::GRAY_UNKNOWN;
+            }
+        }
+    };
+}
+
+const uchar *OccupancyGrid::grayLut()
+{
+    static const GrayLut lut;
+    return lut.table;
+}
+
+bool OccupancyGrid::toGray(const qint8 *cells, qsizetype count, int width, int height, QImage &out)
+{
+    if (width <= 0 || height <= 0 || count < static_cast<qsizetype>(width) * height)
+        return false;
+
+    // 上一帧的图像仍被 MapLayer 持有时不能原地覆盖，重新分配
+    if (!out.isDetached() || out.size() != QSize(width, height) || out.format() != QImage::Format_Grayscale8)
+        out = QImage(width, height, QImage::Format_Grayscale8);
+    if (out.isNull())
+        return false;
+
+    // 栅格行 0 在下，图像行 0 在上：逐行倒序写入
+    const uchar *lut = grayLut();
+    const quint8 *src = reinterpret_cast<const quint8 *>(cells);
+    for (int row = 0; row < height; ++row, src += width)
+    {
+        uchar *dst = out.scanLine(height - 1 - row);
+        for (int col = 0; col < width; ++col)
+            dst[col] = lut[src[col]];
+    }
+    return true;
+}
@@ -0,0 +1,90 @@
+#include "PointCloudBuffer.h"
+#include <atomic>
+
+void PointCloudBuffer::resize(int points)
+{
+    const size_t floats = static_cast<size_t>(qMax(0, points)) * 2;
+    if (floats > m_xy.size())
+        m_xy.resize(floats);
+    m_size = qMax(0, points);
+}
+
+float *PointCloudBuffer::rawStorage(int floats)
+{
+    if (static_cast<size_t>(floats) > m_xy.size())
+        m_xy.resize(static_cast<size_t>(floats));
+    return m_xy.data();
+}
+
+void PointCloudBuffer::packFromStride(int points, int stride)
+{
+    // 目标下标 2i 不超过源下标 stride * i，从前往后搬移不会覆盖未读数据
+    float *xy = m_xy.data();
+    if (stride != 2)
+    {
+        for (int i = 0; i < points; ++i)
+        {
+            xy[2 * i] = xy[stride * i];
+            xy[2 * i + 1] = xy[stride * i + 1];
+        }
+    }
+    m_size = points;
+}
+
+PointCloudPool *PointCloudPool::instance()
+{
+    static PointCloudPool instance;
+    return &instance;
+}
+
+std::shared_ptr<PointCloudBuffer> PointCloudPool::acquire(int points)
+{
+    std::shared_ptr<PointCloudBuffer> buffer;
+    {
+        QMutexLocker locker(&m_mutex);
+        // 引用计数为 1 说明只有池本身持有，其他线程无法再取得它，可以安全复用
+        for (const std::shared_ptr<PointCloudBuffer> &candidate : qAsConst(m_buffers))
+        {
+            if (candidate.use_count() == 1)
+            {
+                // 上一个持有者在其他线程释放引用时的读写须对本线程可见，再交给新的写入者
+                std::atomic_thread_fence(std::memory_order_acquire);
+                buffer = candidate;
+                m_reused++;
+                break;
+            }
+        }
+
+        if (!buffer)
+        {
+            buffer = std::make_shared<PointCloudBuffer>();
+            if (m_buffers.size() < MAX_POOLED)
+                m_buffers.append(buffer);
+            else
+                m_overflow++;
+        }
+    }
+
+    buffer->resize(points);
+    buffer->stampUs = -1;
+    buffer->seq = 0;
+    return buffer;
+}
+
+int PointCloudPool::pooled() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_buffers.size();
+}
+
+quint64 PointCloudPool::reused() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_reused;
+}
+
+quint64 PointCloudPool::overflow() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_overflow;
+}
@@ -0,0 +1,106 @@
+#include "PointCloudDecimator.h"
+#include <algorithm>
+#include <cmath>
+
+std::atomic<int> PointCloudDecimator::s_viewBucket{PointCloudDecimator::NO_DECIMATION};
+
+int PointCloudDecimator::bucketForScale(double pixelsPerMeter)
+{
+    if (!(pixelsPerMeter > 0.0))
+        return NO_DECIMATION;
+    return static_cast<int>(std::floor(std::log2(pixelsPerMeter)));
+}
+
+double PointCloudDecimator::cellSize(int bucket)
+{
+    // 档位 b 覆盖 [2^b, 2^(b+1)) 像素/米，按上限取边长，屏幕上的格子在 CELL_PX / 2 到 CELL_PX 之间
+    return CELL_PX / std::ldexp(1.0, bucket + 1);
+}
+
+bool PointCloudDecimator::setViewScale(double pixelsPerMeter)
+{
+    const int bucket = bucketForScale(pixelsPerMeter);
+    return s_viewBucket.exchange(bucket, std::memory_order_relaxed) != bucket;
+}
+
+int PointCloudDecimator::viewBucket()
+{
+    return s_viewBucket.load(std::memory_order_relaxed);
+}
+
+PointCloudBufferPtr PointCloudDecimator::decimate(const PointCloudBufferPtr &src, int bucket)
+{
+    if (!src || bucket == NO_DECIMATION || src->isEmpty())
+        return src;
+
+    const int n = src->size();
+
+    // 表长取不小于 2n 的 2 的幂，负载不超过一半
+    size_t tableSize = 64;
+    int shift = 58;
+    while (tableSize < static_cast<size_t>(n) * 2)
+    {
+        tableSize <<= 1;
+        --shift;
+    }
+    if (m_keys.size() < tableSize)
+    {
+        m_keys.assign(tableSize, 0);
+        m_stamps.assign(tableSize, 0);
+        m_generation = 0;
+    }
+    if (++m_generation == 0)
+    {
+        // 计数回绕，清空一次
+        std::fill(m_stamps.begin(), m_stamps.end(), 0);
+        m_generation = 1;
+    }
+    const size_t mask = tableSize - 1;
+
+    std::shared_ptr<PointCloudBuffer> out = PointCloudPool::instance()->acquire(n);
+    const float inv = static_cast<float>(1.0 / cellSize(bucket));
+    const float limit = 1.0e9f; // 超出 int32 的坐标视为无效点
+    const float *in = src->xy();
+    float *dst = out->xy();
+    int kept = 0;
+
+    for (int i = 0; i < n; ++i, in += 2)
+    {
+        const float fx = std::floor(in[0] * inv);
+        const float fy = std::floor(in[1] * inv);
+        // NaN 与越界坐标直接丢弃
+        if (!(std::fabs(fx) < limit && std::fabs(fy) < limit))
+            continue;
+
+        const quint64 key = (static_cast<quint64>(static_cast<quint32>(static_cast<qint32>(fx))) << 32) |
+                            static_cast<quint32>(static_cast<qint32>(fy));
+        size_t slot = static_cast<size_t>((key * 0x9E3779B97F4A7C15ull) >> shift) & mask;
+        bool seen = false;
+        while (m_stamps[slot] == m_generation)
+        {
+            if (m_keys[slot] == key)
+            {
+                seen = true;
+                break;
+            }
+            slot = (slot + 1) & mask;
+        }
+        if (seen)
+            continue;
+
+        m_stamps[slot] = m_generation;
+        m_keys[slot] = key;
+        dst[0] = in[0];
+        dst[1] = in[1];
+        dst += 2;
+        ++kept;
+    }
+
+    if (kept == n)
+        return src; // out 未被引用，随即回到池中
+
+    out->resize(kept);
+    out->stampUs = src->stampUs;
+    out->seq = src->seq;
+    return out;
+}
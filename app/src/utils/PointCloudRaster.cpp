@@ -0,0 +1,255 @@
+#include "PointCloudRaster.h"
+#include <QPainter>
+#include <climits>
+#include <cmath>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define POINTCLOUD_RASTER_SSE2
+#endif
+
+namespace
+{
+    // 超出该范围的像素坐标按无效处理，保证转换为 int32 时不溢出
+    const float PIXEL_LIMIT = 1.0e8f;
+
+    inline qint32 toPixel(float v)
+    {
+        if (!(v > -PIXEL_LIMIT && v < PIXEL_LIMIT))
+            return INT_MIN;
+        return static_cast<qint32>(std::floor(v + 0.5f));
+    }
+
+    // 圆点各行相对中心的半宽：半径 2 时为 1 2 2 2 1（21 个像素）
+    const int DOT_HALF_WIDTH[2 * PointCloudRaster::DOT_RADIUS + 1] = {1, 2, 2, 2, 1};
+
+    // 预乘像素按 a / 255 缩放
+    inline quint32 byteMul(quint32 x, quint32 a)
+    {
+        quint32 t = (x & 0xff00ff) * a;
+        t = (t + ((t >> 8) & 0xff00ff) + 0x800080) >> 8;
+        t &= 0xff00ff;
+        x = ((x >> 8) & 0xff00ff) * a;
+        x = (x + ((x >> 8) & 0xff00ff) + 0x800080);
+        x &= 0xff00ff00;
+        return x | t;
+    }
+
+    // 写入一段像素：不透明时直接覆盖，否则 source-over 混合
+    template <bool Opaque>
+    inline void fillSpan(quint32 *p, int count, quint32 pixel, quint32 inverseAlpha)
+    {
+        for (int i = 0; i < count; ++i)
+            p[i] = Opaque ? pixel : pixel + byteMul(p[i], inverseAlpha);
+    }
+
+    template <bool Opaque>
+    int splatDots(QImage &image, const qint32 *pxy, int n, quint32 pixel, QRect *dirty)
+    {
+        const int w = image.width();
+        const int h = image.height();
+        const int r = PointCloudRaster::DOT_RADIUS;
+        const qsizetype stride = image.bytesPerLine() / 4;
+        quint32 *bits = reinterpret_cast<quint32 *>(image.bits());
+        const quint32 inverseAlpha = 255 - qAlpha(pixel);
+
+        int minX = INT_MAX, minY = INT_MAX, maxX = INT_MIN, maxY = INT_MIN;
+        int drawn = 0;
+        for (int i = 0; i < n; ++i, pxy += 2)
+        {
+            const qint32 cx = pxy[0];
+            const qint32 cy = pxy[1];
+            // 圆点完全在图像外
+            if (cx < -r || cy < -r || cx >= w + r || cy >= h + r)
+                continue;
+            ++drawn;
+
+            if (cx >= r && cy >= r && cx < w - r && cy < h - r)
+            {
+                // 完全在图像内：按行写入，不做逐像素判断
+                quint32 *row = bits + (cy - r) * stride + cx;
+                for (int k = 0; k <= 2 * r; ++k, row += stride)
+                {
+                    const int hw = DOT_HALF_WIDTH[k];
+                    fillSpan<Opaque>(row - hw, 2 * hw + 1, pixel, inverseAlpha);
+                }
+            }
+            else
+            {
+                // 与图像边缘相交：逐行裁剪
+                for (int k = 0; k <= 2 * r; ++k)
+                {
+                    const int y = cy - r + k;
+                    if (y < 0 || y >= h)
+                        continue;
+                    const int hw = DOT_HALF_WIDTH[k];
+                    const int x0 = qMax(0, cx - hw);
+                    const int x1 = qMin(w - 1, cx + hw);
+                    fillSpan<Opaque>(bits + y * stride + x0, x1 - x0 + 1, pixel, inverseAlpha);
+                }
+            }
+
+            minX = qMin(minX, cx);
+            maxX = qMax(maxX, cx);
+            minY = qMin(minY, cy);
+            maxY = qMax(maxY, cy);
+        }
+
+        if (drawn > 0 && dirty)
+        {
+            const QRect touched = QRect(QPoint(minX - r, minY - r), QPoint(maxX + r, maxY + r)) & QRect(0, 0, w, h);
+            *dirty = dirty->isNull() ? touched : (*dirty | touched);
+        }
+        return drawn;
+    }
+
+    inline bool isSplatFormat(const QImage &image)
+    {
+        const QImage::Format f = image.format();
+        return f == QImage::Format_ARGB32_Premultiplied || f == QImage::Format_ARGB32 || f == QImage::Format_RGB32;
+    }
+}
+
+void PointCloudRaster::transformPoints(const float *xy, int n, const QTransform &t, qint32 *out)
+{
+    if (t.type() == QTransform::TxProject)
+    {
+        // 透视变换不会出现在监控视图中，逐点处理
+        for (int i = 0; i < n; ++i, xy += 2, out += 2)
+        {
+            const QPointF p = t.map(QPointF(xy[0], -xy[1]));
+            out[0] = toPixel(static_cast<float>(p.x()));
+            out[1] = toPixel(static_cast<float>(p.y()));
+        }
+        return;
+    }
+
+    // 设备像素 = (x, -y) 经仿射变换，y 的取反并入系数
+    const float a = static_cast<float>(t.m11());
+    const float b = static_cast<float>(-t.m21());
+    const float c = static_cast<float>(t.m12());
+    const float d = static_cast<float>(-t.m22());
+    const float dx = static_cast<float>(t.dx());
+    const float dy = static_cast<float>(t.dy());
+
+    int i = 0;
+#ifdef POINTCLOUD_RASTER_SSE2
+    const __m128 va = _mm_set1_ps(a);
+    const __m128 vb = _mm_set1_ps(b);
+    const __m128 vc = _mm_set1_ps(c);
+    const __m128 vd = _mm_set1_ps(d);
+    const __m128 vdx = _mm_set1_ps(dx);
+    const __m128 vdy = _mm_set1_ps(dy);
+    for (; i + 4 <= n; i += 4, xy += 8, out += 8)
+    {
+        const __m128 p01 = _mm_loadu_ps(xy);     // x0 y0 x1 y1
+        const __m128 p23 = _mm_loadu_ps(xy + 4); // x2 y2 x3 y3
+        const __m128 x = _mm_shuffle_ps(p01, p23, _MM_SHUFFLE(2, 0, 2, 0));
+        const __m128 y = _mm_shuffle_ps(p01, p23, _MM_SHUFFLE(3, 1, 3, 1));
+        const __m128 px = _mm_add_ps(_mm_add_ps(_mm_mul_ps(va, x), _mm_mul_ps(vb, y)), vdx);
+        const __m128 py = _mm_add_ps(_mm_add_ps(_mm_mul_ps(vc, x), _mm_mul_ps(vd, y)), vdy);
+        // 就近取整；NaN 与溢出得到 0x80000000（INT_MIN）
+        const __m128i ix = _mm_cvtps_epi32(px);
+        const __m128i iy = _mm_cvtps_epi32(py);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out), _mm_unpacklo_epi32(ix, iy));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out + 4), _mm_unpackhi_epi32(ix, iy));
+    }
+#endif
+    for (; i < n; ++i, xy += 2, out += 2)
+    {
+        out[0] = toPixel(a * xy[0] + b * xy[1] + dx);
+        out[1] = toPixel(c * xy[0] + d * xy[1] + dy);
+    }
+}
+
+int PointCloudRaster::splat(QImage &image, const qint32 *pxy, int n, QRgb color, QRect *dirty)
+{
+    // 同一圆点内的像素互不重叠，混合只发生在不同点、不同批次之间
+    const quint32 pixel = qPremultiply(color);
+    if (qAlpha(color) == 255)
+        return splatDots<true>(image, pxy, n, pixel, dirty);
+    if (qAlpha(color) == 0)
+        return 0;
+    return splatDots<false>(image, pxy, n, pixel, dirty);
+}
+
+void PointCloudRaster::begin(QPainter *painter)
+{
+    m_painter = painter;
+    m_target = nullptr;
+    m_dirty = QRect();
+    if (!painter || !painter->device())
+        return;
+
+    m_transform = painter->transform();
+
+    // 直接写入：目标是无裁剪、无缩放的 32 位图像（离屏绘制、基准测试）
+    QPaintDevice *device = painter->device();
+    if (device->devType() == QInternal::Image && !painter->hasClipping() &&
+        painter->deviceTransform() == m_transform)
+    {
+        QImage *image = static_cast<QImage *>(device);
+        if (isSplatFormat(*image) && image->devicePixelRatio() == 1.0)
+        {
+            m_target = image;
+            return;
+        }
+    }
+
+    // 叠加层：按逻辑像素写入，end 时一次 drawImage 合成，裁剪与设备缩放交给 painter
+    const QSize size(device->width(), device->height());
+    if (m_overlay.size() != size)
+    {
+        m_overlay = QImage(size, QImage::Format_ARGB32_Premultiplied);
+        m_overlay.fill(Qt::transparent);
+    }
+    m_target = &m_overlay;
+}
+
+void PointCloudRaster::drawPoints(const float *xy, int n, QRgb color)
+{
+    if (!m_target || n <= 0)
+        return;
+
+    if (m_pixels.size() < static_cast<size_t>(2 * n))
+        m_pixels.resize(static_cast<size_t>(2 * n));
+    transformPoints(xy, n, m_transform, m_pixels.data());
+    splat(*m_target, m_pixels.data(), n, color, &m_dirty);
+}
+
+void PointCloudRaster::drawPixels(const qint32 *pxy, int n, QRgb color)
+{
+    if (!m_target || n <= 0)
+        return;
+    splat(*m_target, pxy, n, color, &m_dirty);
+}
+
+void PointCloudRaster::end()
+{
+    QImage *target = m_target;
+    QPainter *painter = m_painter;
+    m_target = nullptr;
+    m_painter = nullptr;
+    if (target != &m_overlay || m_dirty.isEmpty())
+        return;
+
+    painter->save();
+    painter->resetTransform();
+    painter->drawImage(m_dirty.topLeft(), m_overlay, m_dirty);
+    painter->restore();
+
+    // 只清除写过的区域，下次绘制前叠加层保持全透明
+    const qsizetype bytes = static_cast<qsizetype>(m_dirty.width()) * 4;
+    for (int y = m_dirty.top(); y <= m_dirty.bottom(); ++y)
+        std::memset(m_overlay.scanLine(y) + m_dirty.left() * 4, 0, static_cast<size_t>(bytes));
+}
+
+void PointCloudRaster::draw(QPainter *painter, const float *xy, int n, QRgb color)
+{
+    if (n <= 0)
+        return;
+    begin(painter);
+    drawPoints(xy, n, color);
+    end();
+}
@@ -0,0 +1,129 @@
+#include "PointCloudTrail.h"
+#include "PointCloudRaster.h"
+#include <QLineF>
+
+void PointCloudTrail::setLimits(int maxScans, qint64 maxBytes)
+{
+    maxScans = qMax(0, maxScans);
+    m_maxBytes = qMax<qint64>(0, maxBytes);
+    if (maxScans == static_cast<int>(m_slots.size()))
+    {
+        // 帧数不变时只按新的内存上限收缩
+        while (m_count > 0 && bytes() > m_maxBytes)
+            dropOldest(true);
+        return;
+    }
+
+    // 帧数变化时重新分配槽位，历史帧丢弃
+    clear();
+    std::vector<Scan>().swap(m_slots);
+    m_slots.resize(static_cast<size_t>(maxScans));
+}
+
+void PointCloudTrail::clear()
+{
+    m_head = 0;
+    m_count = 0;
+}
+
+qint64 PointCloudTrail::slotBytes(const Scan &scan)
+{
+    return static_cast<qint64>(scan.xy.capacity() * sizeof(float) + scan.pixels.capacity() * sizeof(qint32));
+}
+
+qint64 PointCloudTrail::bytes() const
+{
+    qint64 total = 0;
+    for (const Scan &scan : m_slots)
+        total += slotBytes(scan);
+    return total;
+}
+
+void PointCloudTrail::dropOldest(bool release)
+{
+    if (m_count == 0)
+        return;
+    if (release)
+    {
+        Scan &oldest = slot(0);
+        std::vector<float>().swap(oldest.xy);
+        std::vector<qint32>().swap(oldest.pixels);
+        oldest.pixelsValid = false;
+    }
+    m_head = (m_head + 1) % static_cast<int>(m_slots.size());
+    --m_count;
+}
+
+void PointCloudTrail::push(const PointCloudBuffer &cloud, const QPointF &pos, double rad, qint64 nowMs)
+{
+    if (m_slots.empty())
+        return;
+
+    // 位姿跳变（重定位、定位丢失后恢复）：历史帧的世界坐标已不可信
+    if (m_count > 0 && QLineF(slot(m_count - 1).pos, pos).length() > POSE_JUMP_M)
+        clear();
+
+    // 坐标与像素缓存各占 8 字节/点
+    const qint64 need = static_cast<qint64>(cloud.size()) * 2 * (sizeof(float) + sizeof(qint32));
+    if (need > m_maxBytes)
+        return;
+
+    // 槽位已满时最旧的一帧让出槽位（保留其容量供新帧复用）
+    if (m_count == static_cast<int>(m_slots.size()))
+        dropOldest(false);
+
+    // 超出内存上限时从最旧的帧开始释放，空闲槽位保留的容量也计入
+    Scan &target = slot(m_count);
+    while (bytes() - slotBytes(target) + need > m_maxBytes)
+    {
+        if (m_count > 0)
+        {
+            dropOldest(true);
+            continue;
+        }
+        // 只剩空闲槽位：释放其余空闲槽位的容量
+        for (Scan &scan : m_slots)
+        {
+            if (&scan != &target)
+            {
+                std::vector<float>().swap(scan.xy);
+                std::vector<qint32>().swap(scan.pixels);
+            }
+        }
+        break;
+    }
+
+    target.xy.assign(cloud.xy(), cloud.xy() + 2 * cloud.size());
+    target.points = cloud.size();
+    target.pos = pos;
+    target.rad = rad;
+    target.timeMs = nowMs;
+    target.pixelsValid = false;
+    ++m_count;
+}
+
+void PointCloudTrail::draw(PointCloudRaster &raster, qint64 nowMs, QRgb color)
+{
+    // 超时的帧出队，槽位容量保留
+    while (m_count > 0 && nowMs - slot(0).timeMs >= FADE_MS)
+        dropOldest(false);
+
+    for (int age = 0; age < m_count; ++age)
+    {
+        Scan &scan = slot(age);
+        const double life = 1.0 - static_cast<double>(nowMs - scan.timeMs) / FADE_MS;
+        const int alpha = qBound(0, static_cast<int>(MAX_ALPHA * life), 255);
+        if (alpha == 0 || scan.points == 0)
+            continue;
+
+        // 每帧只在视图变换变化时变换一次
+        if (!scan.pixelsValid || scan.pixelTransform != raster.transform())
+        {
+            scan.pixels.resize(static_cast<size_t>(2 * scan.points));
+            PointCloudRaster::transformPoints(scan.xy.data(), scan.points, raster.transform(), scan.pixels.data());
+            scan.pixelTransform = raster.transform();
+            scan.pixelsValid = true;
+        }
+        raster.drawPixels(scan.pixels.data(), scan.points, qRgba(qRed(color), qGreen(color), qBlue(color), alpha));
+    }
+}
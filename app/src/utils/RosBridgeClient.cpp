@@ -1,19 +1,94 @@
 #include "utils/RosBridgeClient.h"
+#include "utils/TrafficRecorder.h"
+#include "utils/ConfigManager.h"
 #include <cmath>
 #include <QDateTime>
 #include <QtMath>
-#include <QJsonArray>
 
 RosBridgeClient::RosBridgeClient(QObject *parent) : QObject(parent), m_webSocket(nullptr)
 {
-    qRegisterMetaType<QVector<QPointF>>("QVector<QPointF>");
+    qRegisterMetaType<PointCloudBufferPtr>("PointCloudBufferPtr");
     qRegisterMetaType<QVector<int>>("QVector<int>");
+    qRegisterMetaType<OccupancyGridPatch>("OccupancyGridPatch");
 
     // 初始化定时器
     m_reconnectTimer = new QTimer(this);
     m_reconnectTimer->setSingleShot(true);
     m_reconnectTimer->setInterval(3000); // 设置重连间隔为 3 秒
     connect(m_reconnectTimer, &QTimer::timeout, this, &RosBridgeClient::doReconnect);
+
+    // 点云与位姿只供监控页面绘制，按需订阅；地图名称始终全速订阅；栅格地图只在启用实时地图时订阅
+    m_topics.append({QStringLiteral("/map"), QStringLiteral("nav_msgs/OccupancyGrid"), Policy::LiveMap});
+    m_topics.append({QStringLiteral("/map_updates"), QStringLiteral("map_msgs/OccupancyGridUpdate"), Policy::LiveMap});
+    m_topics.append({QStringLiteral("/laser_points"), QStringLiteral("std_msgs/Float32MultiArray"), Policy::OnDemand});
+    m_topics.append({QStringLiteral("/map_name"), QStringLiteral("std_msgs/String"), Policy::Always});
+    m_topics.append({QStringLiteral("/agv_state"), QStringLiteral("std_msgs/Int32MultiArray"), Policy::OnDemand});
+
+    initPoseFrame();
+}
+
+// PoseWithCovarianceStamped 发布帧，键名按 QJsonDocument 的顺序排列：
+// {"msg": {"header": {"frame_id": "map"},
+//          "pose": {"covariance": [0 x 36], "pose": {"orientation": {w, x, y, z}, "position": {x, y, z}}}},
+//  "op": "publish", "topic": "/baseinipose"}
+void RosBridgeClient::initPoseFrame()
+{
+    FrameEncoder &f = m_poseFrame;
+    f.beginObject(3);
+    f.key(QStringLiteral("msg"));
+    f.beginObject(2);
+
+    // Header，重定位在 map 坐标系下
+    f.key(QStringLiteral("header"));
+    f.beginObject(1);
+    f.key(QStringLiteral("frame_id"));
+    f.literal(QStringLiteral("map"));
+    f.endObject();
+
+    f.key(QStringLiteral("pose"));
+    f.beginObject(2);
+    // Covariance (标准重定位通常需要一个协方差矩阵，ROS 默认 36 个 0 即可)
+    f.key(QStringLiteral("covariance"));
+    f.beginArray(36);
+    for (int i = 0; i < 36; ++i)
+        f.literal(0.0);
+    f.endArray();
+
+    f.key(QStringLiteral("pose"));
+    f.beginObject(2);
+    // Orientation (Quaternion)
+    f.key(QStringLiteral("orientation"));
+    f.beginObject(4);
+    f.key(QStringLiteral("w"));
+    m_poseQw = f.doubleSlot();
+    f.key(QStringLiteral("x"));
+    f.literal(0.0);
+    f.key(QStringLiteral("y"));
+    f.literal(0.0);
+    f.key(QStringLiteral("z"));
+    m_poseQz = f.doubleSlot();
+    f.endObject();
+    // Position
+    f.key(QStringLiteral("position"));
+    f.beginObject(3);
+    f.key(QStringLiteral("x"));
+    m_poseX = f.doubleSlot();
+    f.key(QStringLiteral("y"));
+    m_poseY = f.doubleSlot();
+    f.key(QStringLiteral("z"));
+    f.literal(0.0);
+    f.endObject();
+    f.endObject(); // pose.pose
+
+    f.endObject(); // pose
+    f.endObject(); // msg
+
+    // ROSBridge 协议外壳
+    f.key(QStringLiteral("op"));
+    f.literal(QStringLiteral("publish"));
+    f.key(QStringLiteral("topic"));
+    f.literal(QStringLiteral("/baseinipose"));
+    f.endObject();
 }
 
 RosBridgeClient::~RosBridgeClient()
@@ -83,10 +158,60 @@ void RosBridgeClient::onConnected()
     m_reconnectTimer->stop(); // 连接成功，停止重连定时器
     emit connected();
 
-    // subscribe("/map", "nav_msgs/OccupancyGrid");
-    subscribe("/laser_points", "std_msgs/Float32MultiArray");
-    subscribe("/map_name", "std_msgs/String");
-    subscribe("/agv_state", "std_msgs/Int32MultiArray");
+    // 新连接上没有任何订阅，按当前界面显示状态重新订阅
+    for (TopicSubscription &sub : m_topics)
+    {
+        sub.sentRate = NOT_SENT;
+        applySubscription(sub);
+    }
+}
+
+void RosBridgeClient::setViewActive(bool active)
+{
+    if (m_viewActive == active)
+        return;
+    m_viewActive = active;
+    logger->log(QStringLiteral("RosBridgeClient"), spdlog::level::info,
+                active ? QStringLiteral("监控页面显示，点云与位姿恢复全速订阅")
+                       : QStringLiteral("监控页面隐藏，点云与位姿按空闲策略订阅"));
+    refreshSubscriptions();
+}
+
+void RosBridgeClient::refreshSubscriptions()
+{
+    for (TopicSubscription &sub : m_topics)
+        applySubscription(sub);
+}
+
+int RosBridgeClient::idleRate(const QString &topic) const
+{
+    // 配置值：-1 退订，0 保持全速，>0 为 throttle_rate（ms）
+    ConfigManager *cfg = ConfigManager::instance();
+    int rate = 0;
+    if (topic == QLatin1String("/laser_points"))
+        rate = cfg->rosIdleLaserPointsMs();
+    else if (topic == QLatin1String("/agv_state"))
+        rate = cfg->rosIdleAgvStateMs();
+    return rate < 0 ? NOT_SENT : rate;
+}
+
+void RosBridgeClient::applySubscription(TopicSubscription &sub)
+{
+    int wanted = 0;
+    if (sub.policy == Policy::LiveMap)
+        wanted = ConfigManager::instance()->rosLiveMap() ? 0 : NOT_SENT;
+    else if (sub.policy == Policy::OnDemand && !m_viewActive)
+        wanted = idleRate(sub.topic);
+    // 未连接时只记录状态，连接后由 onConnected 统一订阅
+    if (!m_webSocket || !m_webSocket->isValid() || wanted == sub.sentRate)
+        return;
+
+    // rosbridge 同一话题的多次订阅取最快的节流，修改节流前先退订
+    if (sub.sentRate != NOT_SENT)
+        unsubscribe(sub.topic);
+    if (wanted != NOT_SENT)
+        subscribe(sub.topic, sub.type, wanted);
+    sub.sentRate = wanted;
 }
 
 // 处理 Socket 断开
@@ -143,66 +268,45 @@ void RosBridgeClient::setInitialPose(const QPointF &pos, double angle)
     double qz = std::sin(angle / 2.0);
     double qw = std::cos(angle / 2.0);
 
-    // 2. 构造 ROS 消息体 (PoseWithCovarianceStamped 格式)
-    QJsonObject msg;
-
-    // Header
-    QJsonObject header;
-    header["frame_id"] = "map"; // 通常重定位是在 map 坐标系下
-    msg["header"] = header;
-
-    // Pose
-    QJsonObject pose;
-    QJsonObject poseInner;
-
-    // Position
-    QJsonObject position;
-    position["x"] = pos.x();
-    position["y"] = pos.y();
-    position["z"] = 0.0;
-    poseInner["position"] = position;
-
-    // Orientation (Quaternion)
-    QJsonObject orientation;
-    orientation["x"] = 0.0;
-    orientation["y"] = 0.0;
-    orientation["z"] = qz;
-    orientation["w"] = qw;
-    poseInner["orientation"] = orientation;
-
-    pose["pose"] = poseInner;
-
-    // Covariance (标准重定位通常需要一个协方差矩阵，ROS 默认 36 个 0 即可)
-    QJsonArray covariance;
-    for (int i = 0; i < 36; ++i)
-        covariance.append(0.0);
-    pose["covariance"] = covariance;
-
-    msg["pose"] = pose;
-
-    // 3. 构造 ROSBridge 协议外壳
-    QJsonObject publishOp;
-    publishOp["op"] = "publish";
-    publishOp["topic"] = "/baseinipose"; // 对应你要求的 topic
-    publishOp["msg"] = msg;
-
-    // 4. 发送
-    QJsonDocument doc(publishOp);
-    m_webSocket->sendTextMessage(doc.toJson(QJsonDocument::Compact));
+    // 2. 写入模板并发送
+    m_poseFrame.setDouble(m_poseX, pos.x());
+    m_poseFrame.setDouble(m_poseY, pos.y());
+    m_poseFrame.setDouble(m_poseQz, qz);
+    m_poseFrame.setDouble(m_poseQw, qw);
+    m_webSocket->sendTextMessage(m_poseFrame.encodeJson());
 
     logger->log(QStringLiteral("RosBridgeClient"), spdlog::level::warn, QStringLiteral("Sent initial pose x: %1, y: %2, yaw: %3").arg(pos.x()).arg(pos.y()).arg(angle));
 }
 
 // 订阅
-void RosBridgeClient::subscribe(const QString &topic, const QString &type)
+void RosBridgeClient::subscribe(const QString &topic, const QString &type, int throttleMs)
 {
     if (m_webSocket)
     {
         QJsonObject json;
         json["op"] = "subscribe";
+        json["id"] = QStringLiteral("ruinap:%1").arg(topic); // 退订时按 id 只取消本客户端的这一路订阅
         json["topic"] = topic;
         json["type"] = type;
         json["compression"] = "cbor"; // 保持 CBOR 压缩
+        if (throttleMs > 0)
+        {
+            json["throttle_rate"] = throttleMs;
+            json["queue_length"] = 1;
+        }
+        QJsonDocument doc(json);
+        m_webSocket->sendTextMessage(doc.toJson(QJsonDocument::Compact));
+    }
+}
+
+void RosBridgeClient::unsubscribe(const QString &topic)
+{
+    if (m_webSocket)
+    {
+        QJsonObject json;
+        json["op"] = "unsubscribe";
+        json["id"] = QStringLiteral("ruinap:%1").arg(topic);
+        json["topic"] = topic;
         QJsonDocument doc(json);
         m_webSocket->sendTextMessage(doc.toJson(QJsonDocument::Compact));
     }
@@ -215,158 +319,58 @@ void RosBridgeClient::onTextMessageReceived(const QString &message)
 
 void RosBridgeClient::onBinaryMessageReceived(const QByteArray &message)
 {
+    TrafficRecorder::instance()->record(TrafficCapture::Channel::RosBridge, message);
+
     // 直接在当前线程 (子线程) 解析，不涉及跨线程拷贝
     processCborMessage(message);
 }
 
-// --- 下面是原 RosDataWorker 的逻辑，合并进来 ---
-
-void RosBridgeClient::processCborMessage(const QByteArray &rawData)
+void RosBridgeClient::injectBinaryMessage(const QByteArray &message)
 {
-    QCborParserError error;
-    QCborValue val = QCborValue::fromCbor(rawData, &error);
-    if (error.error != QCborError::NoError)
-        return;
-
-    if (val.isMap())
-    {
-        QCborMap map = val.toMap();
-        QString op = map[QStringLiteral("op")].toString();
-        if (op != "publish")
-            return;
-
-        QString topic = map[QStringLiteral("topic")].toString();
-        QCborValue msg = map[QStringLiteral("msg")];
-
-        if (topic == "/map")
-        {
-            // qDebug() << "Parsing Map in Thread:" << QThread::currentThreadId();
-            // parseMapCbor(msg);
-        }
-        else if (topic == "/laser_points")
-        {
-            parsePointCloudCbor(msg);
-        }
-        // 处理 map_name
-        else if (topic == "/map_name")
-        {
-            parseMapNameCbor(msg);
-        }
-        // 处理 agv_state
-        else if (topic == "/agv_state")
-        {
-            parseAgvStateCbor(msg);
-        }
-    }
+    processCborMessage(message);
 }
 
-QByteArray RosBridgeClient::extractByteArray(const QCborValue &val)
-{
-    if (val.isByteArray())
-        return val.toByteArray();
-    if (val.isTag())
-    {
-        QCborValue taggedVal = val.taggedValue();
-        if (taggedVal.isByteArray())
-            return taggedVal.toByteArray();
-    }
-    return QByteArray();
-}
+// --- 下面是原 RosDataWorker 的逻辑，合并进来 ---
 
-void RosBridgeClient::parsePointCloudCbor(const QCborValue &msgVal)
+void RosBridgeClient::processCborMessage(const QByteArray &rawData)
 {
-    QVector<QPointF> points;
-    if (!msgVal.isMap())
+    // 流式解码：按 op / topic 分派，点云数据直接读入池化缓冲区
+    if (!m_decoder.decode(rawData, m_message))
         return;
 
-    QCborMap msg = msgVal.toMap();
-    if (msg.contains(QStringLiteral("data")))
+    switch (m_message.topic)
     {
-        QCborValue dataVal = msg[QStringLiteral("data")];
-        QByteArray byteArray = extractByteArray(dataVal);
-
-        if (!byteArray.isEmpty())
-        {
-            // Float32 占用 4 字节，每 3 个值为一组 (x, y, 0)
-            int floatCount = byteArray.size() / 4;
-            const float *raw = reinterpret_cast<const float *>(byteArray.constData());
-            for (int i = 0; i + 2 < floatCount; i += 3)
-            {
-                // 单位为 m
-                points.append(QPointF(raw[i], raw[i + 1]));
-            }
-        }
-        else if (dataVal.isArray())
-        {
-            QCborArray arr = dataVal.toArray();
-            for (int i = 0; i + 2 < arr.size(); i += 3)
-            {
-                points.append(QPointF(arr[i].toDouble(), arr[i + 1].toDouble()));
-            }
-        }
-        emit pointCloudReceived(points);
+    case RosBridgeMessage::Topic::LaserPoints:
+        m_message.cloud->seq = ++m_cloudSeq;
+        m_rawCloud = std::move(m_message.cloud);
+        m_cloudBucket = PointCloudDecimator::viewBucket();
+        emit pointCloudReceived(m_decimator.decimate(m_rawCloud, m_cloudBucket));
+        break;
+    case RosBridgeMessage::Topic::MapName:
+        emit mapNameReceived(m_message.mapName);
+        break;
+    case RosBridgeMessage::Topic::AgvState:
+        emit agvStateReceived(m_message.agvState);
+        break;
+    case RosBridgeMessage::Topic::Map:
+    case RosBridgeMessage::Topic::MapUpdate:
+        // 地图与其局部更新必须按顺序逐帧送达，不经过只保留最新帧的邮箱
+        emit occupancyGridReceived(m_message.grid);
+        // 不再持有图像，MapLayer 是唯一持有者，写入局部更新时无需整幅复制
+        m_message.grid.image = QImage();
+        break;
+    default:
+        break;
     }
 }
 
-void RosBridgeClient::parseMapNameCbor(const QCborValue &msgVal)
+void RosBridgeClient::redecimateCloud()
 {
-    // msgVal 对应 ROS 消息体
-    if (msgVal.isMap())
-    {
-        QCborMap msg = msgVal.toMap();
-        // std_msgs/String 只有一个字段: "data"
-        if (msg.contains(QStringLiteral("data")))
-        {
-            QString mapName = msg[QStringLiteral("data")].toString();
+    // 期间已有新帧按当前档位处理过时无需重复
+    const int bucket = PointCloudDecimator::viewBucket();
+    if (!m_rawCloud || bucket == m_cloudBucket)
+        return;
 
-            // 发送信号
-            emit mapNameReceived(mapName);
-        }
-    }
+    m_cloudBucket = bucket;
+    emit pointCloudReceived(m_decimator.decimate(m_rawCloud, bucket));
 }
-
-void RosBridgeClient::parseAgvStateCbor(const QCborValue &msgVal)
-{
-    QVector<int> agvState;
-
-    if (msgVal.isMap())
-    {
-        QCborMap msg = msgVal.toMap();
-
-        // 检查是否存在 "data" 字段
-        if (msg.contains(QStringLiteral("data")))
-        {
-            QCborValue dataVal = msg[QStringLiteral("data")];
-
-            // 1. 尝试作为二进制数据解析 (Rosbridge 可能会将 int32[] 压缩为字节流)
-            QByteArray byteArray = extractByteArray(dataVal);
-            if (!byteArray.isEmpty())
-            {
-                // Int32 占用 4 字节
-                int count = byteArray.size() / 4;
-                agvState.reserve(count);
-
-                // 重新解释内存为 int32_t 指针
-                const int32_t *raw = reinterpret_cast<const int32_t *>(byteArray.constData());
-                for (int i = 0; i < count; ++i)
-                {
-                    agvState.append(static_cast<int>(raw[i]));
-                }
-            }
-            // 2. 尝试作为普通 CBOR 数组解析 (即标准 JSON 数组格式 [1, 2, 3])
-            else if (dataVal.isArray())
-            {
-                QCborArray arr = dataVal.toArray();
-                agvState.reserve(arr.size());
-                for (const QCborValue &v : arr)
-                {
-                    agvState.append(v.toInteger());
-                }
-            }
-
-            // 仅当解析出数据或确定为空数组时发送信号
-            // 这里的条件可以根据你的需求调整，是否允许发送空状态
-            emit agvStateReceived(agvState);
-        }
-    }
-}
\ No newline at end of file
@@ -0,0 +1,598 @@
+#include "RosBridgeDecoder.h"
+#include <QCborStreamReader>
+#include <QCborValue>
+#include <QCborMap>
+#include <QCborArray>
+#include <cstring>
+
+using Topic = RosBridgeMessage::Topic;
+
+namespace
+{
+    // 已订阅话题表，topic 字符串按字节比较后直接得到分派目标
+    struct TopicEntry
+    {
+        QLatin1String name;
+        Topic topic;
+    };
+
+    const TopicEntry TOPICS[] = {
+        {QLatin1String("/laser_points"), Topic::LaserPoints},
+        {QLatin1String("/map_name"), Topic::MapName},
+        {QLatin1String("/agv_state"), Topic::AgvState},
+        {QLatin1String("/map"), Topic::Map},
+        {QLatin1String("/map_updates"), Topic::MapUpdate},
+    };
+
+    Topic lookupTopic(QLatin1String name)
+    {
+        for (const TopicEntry &entry : TOPICS)
+        {
+            if (entry.name == name)
+                return entry.topic;
+        }
+        return Topic::Unknown;
+    }
+
+    Topic lookupTopic(const QString &name)
+    {
+        for (const TopicEntry &entry : TOPICS)
+        {
+            if (entry.name == name)
+                return entry.topic;
+        }
+        return Topic::Unknown;
+    }
+
+    // 读取短文本（键名、op、topic）到 buf，返回字节数，不分配内存
+    // 不是文本或超过 cap 时跳过整个值并返回 -1
+    qsizetype readShortText(QCborStreamReader &r, char *buf, qsizetype cap)
+    {
+        if (!r.isString() || r.currentStringChunkSize() > cap)
+        {
+            r.next();
+            return -1;
+        }
+
+        qsizetype len = 0;
+        bool overflow = false;
+        for (;;)
+        {
+            const qsizetype chunk = r.currentStringChunkSize();
+            if (chunk > cap - len)
+            {
+                // 分段文本总长超出：余下的段落读出丢弃
+                overflow = true;
+                auto rest = r.readString();
+                while (rest.status == QCborStreamReader::Ok)
+                    rest = r.readString();
+                break;
+            }
+            auto res = r.readStringChunk(buf + len, cap - len);
+            if (res.status != QCborStreamReader::Ok)
+            {
+                if (res.status == QCborStreamReader::Error)
+                    return -1;
+                break;
+            }
+            len += res.data;
+        }
+        return overflow ? -1 : len;
+    }
+
+    // 读取一个数值并前进到下一个值；不是数值时按 0 处理
+    double readNumber(QCborStreamReader &r)
+    {
+        double v = 0.0;
+        if (r.isInteger())
+            v = static_cast<double>(r.toInteger());
+        else if (r.isFloat())
+            v = r.toFloat();
+        else if (r.isDouble())
+            v = r.toDouble();
+        else if (r.isFloat16())
+            v = r.toFloat16();
+        r.next();
+        return v;
+    }
+
+    // 把当前字节串整体读入 storage(needBytes) 提供的缓冲区，返回读入的字节数，出错时返回 -1
+    // 分段字节串逐段追加，storage 需保留已写入的内容
+    template <typename Storage>
+    qsizetype readByteStringInto(QCborStreamReader &r, Storage storage)
+    {
+        qsizetype total = 0;
+        for (;;)
+        {
+            const qsizetype chunk = qMax<qsizetype>(0, r.currentStringChunkSize());
+            char *dst = storage(total + chunk) + total;
+            auto res = r.readStringChunk(dst, chunk);
+            if (res.status == QCborStreamReader::EndOfString)
+                return total;
+            if (res.status == QCborStreamReader::Error)
+                return -1;
+            total += res.data;
+        }
+    }
+
+    // 在 map 中逐个读取键名并交给 onKey 处理值；onKey 未处理的值被跳过
+    template <typename OnKey>
+    bool readMap(QCborStreamReader &r, OnKey onKey)
+    {
+        if (!r.isMap())
+        {
+            r.next();
+            return false;
+        }
+        r.enterContainer();
+        char key[32];
+        while (r.hasNext() && r.lastError() == QCborError::NoError)
+        {
+            const qsizetype len = readShortText(r, key, sizeof(key));
+            if (len < 0 || !onKey(QLatin1String(key, static_cast<int>(len))))
+                r.next();
+        }
+        if (r.lastError() != QCborError::NoError)
+            return false;
+        r.leaveContainer();
+        return true;
+    }
+}
+
+bool RosBridgeDecoder::decode(const QByteArray &frame, RosBridgeMessage &out)
+{
+    out.topic = Topic::Unknown;
+
+    QCborStreamReader r(frame);
+    if (!r.isMap())
+        return false;
+    r.enterContainer();
+
+    bool publish = false;
+    Topic topic = Topic::Unknown;
+    char key[32];
+    char text[64];
+    while (r.hasNext() && r.lastError() == QCborError::NoError)
+    {
+        const qsizetype keyLen = readShortText(r, key, sizeof(key));
+        if (keyLen < 0)
+        {
+            r.next();
+            continue;
+        }
+        const QLatin1String k(key, static_cast<int>(keyLen));
+
+        if (k == QLatin1String("op"))
+        {
+            const qsizetype n = readShortText(r, text, sizeof(text));
+            publish = QLatin1String(text, static_cast<int>(qMax<qsizetype>(0, n))) == QLatin1String("publish");
+            if (!publish)
+                return false;
+        }
+        else if (k == QLatin1String("topic"))
+        {
+            const qsizetype n = readShortText(r, text, sizeof(text));
+            topic = n < 0 ? Topic::Unknown : lookupTopic(QLatin1String(text, static_cast<int>(n)));
+            if (topic == Topic::Unknown)
+                return false;
+        }
+        else if (k == QLatin1String("msg"))
+        {
+            // rosbridge 总是先发 op 和 topic；顺序不同的帧交给 DOM 路径
+            if (!publish || topic == Topic::Unknown)
+                return decodeDom(frame, out);
+
+            bool ok = false;
+            switch (topic)
+            {
+            case Topic::LaserPoints:
+                ok = readLaserPoints(r, out);
+                break;
+            case Topic::MapName:
+                ok = readMapName(r, out);
+                break;
+            case Topic::AgvState:
+                ok = readAgvState(r, out);
+                break;
+            case Topic::Map:
+            case Topic::MapUpdate:
+                ok = readOccupancyGrid(r, out, topic == Topic::Map);
+                break;
+            default:
+                break;
+            }
+            if (!ok || r.lastError() != QCborError::NoError)
+                return false;
+            // msg 之后的键与解码结果无关，不再读取
+            out.topic = topic;
+            return true;
+        }
+        else
+        {
+            r.next();
+        }
+    }
+    return false;
+}
+
+bool RosBridgeDecoder::readLaserPoints(QCborStreamReader &r, RosBridgeMessage &out)
+{
+    std::shared_ptr<PointCloudBuffer> cloud;
+    qint64 stampUs = -1;
+    bool ok = true;
+
+    const bool isMap = readMap(r, [&](QLatin1String key)
+                               {
+        if (key == QLatin1String("data"))
+        {
+            cloud = PointCloudPool::instance()->acquire(0);
+            // float32[] 通常带 RFC 8746 类型数组标签（小端 float32 为 85）
+            if (r.isTag())
+                r.next();
+
+            if (r.isByteArray())
+            {
+                // x y z 三个 float32 一组，字节串直接读入缓冲区后原地压缩为 x y
+                const qsizetype bytes = readByteStringInto(r, [&cloud](qsizetype need)
+                                                           { return reinterpret_cast<char *>(cloud->rawStorage(static_cast<int>((need + 3) / 4))); });
+                if (bytes < 0)
+                {
+                    ok = false;
+                    return true;
+                }
+                cloud->packFromStride(static_cast<int>(bytes / 12), 3);
+            }
+            else if (r.isArray())
+            {
+                int n = 0;
+                if (r.isLengthKnown())
+                    cloud->rawStorage(static_cast<int>(r.length()));
+                r.enterContainer();
+                while (r.hasNext() && r.lastError() == QCborError::NoError)
+                {
+                    const float v = static_cast<float>(readNumber(r));
+                    cloud->rawStorage(n + 1)[n] = v;
+                    ++n;
+                }
+                r.leaveContainer();
+                cloud->packFromStride(n / 3, 3);
+            }
+            else
+            {
+                r.next();
+            }
+            return true;
+        }
+        if (key == QLatin1String("sim_stamp_us"))
+        {
+            stampUs = r.isInteger() ? r.toInteger() : -1;
+            r.next();
+            return true;
+        }
+        return false; });
+
+    if (!isMap || !ok || !cloud)
+        return false;
+
+    cloud->stampUs = stampUs;
+    out.cloud = std::move(cloud);
+    return true;
+}
+
+bool RosBridgeDecoder::readMapName(QCborStreamReader &r, RosBridgeMessage &out)
+{
+    bool found = false;
+    const bool isMap = readMap(r, [&](QLatin1String key)
+                               {
+        if (key != QLatin1String("data"))
+            return false;
+
+        out.mapName.clear();
+        found = true;
+        if (!r.isString())
+            return false;
+
+        auto res = r.readString();
+        while (res.status == QCborStreamReader::Ok)
+        {
+            out.mapName += res.data;
+            res = r.readString();
+        }
+        found = res.status == QCborStreamReader::EndOfString;
+        return true; });
+    return isMap && found;
+}
+
+bool RosBridgeDecoder::readAgvState(QCborStreamReader &r, RosBridgeMessage &out)
+{
+    bool found = false;
+    const bool isMap = readMap(r, [&](QLatin1String key)
+                               {
+        if (key != QLatin1String("data"))
+            return false;
+
+        found = true;
+        out.agvState.clear();
+        // int32[] 可能是带类型数组标签（小端 int32 为 78）的字节串，也可能是普通数组
+        if (r.isTag())
+            r.next();
+
+        if (r.isByteArray())
+        {
+            const qsizetype bytes = readByteStringInto(r, [&out](qsizetype need)
+                                                       {
+                out.agvState.resize(static_cast<int>((need + 3) / 4));
+                return reinterpret_cast<char *>(out.agvState.data()); });
+            if (bytes < 0)
+                found = false;
+            else
+                out.agvState.resize(static_cast<int>(bytes / 4));
+        }
+        else if (r.isArray())
+        {
+            r.enterContainer();
+            while (r.hasNext() && r.lastError() == QCborError::NoError)
+                out.agvState.append(static_cast<int>(readNumber(r)));
+            r.leaveContainer();
+        }
+        else
+        {
+            r.next();
+        }
+        return true; });
+    return isMap && found;
+}
+
+qsizetype RosBridgeDecoder::readGridCells(QCborStreamReader &r)
+{
+    // int8[] 通常是带类型数组标签（int8 为 72）的字节串，也可能是普通数组
+    if (r.isTag())
+        r.next();
+
+    if (r.isByteArray())
+    {
+        return readByteStringInto(r, [this](qsizetype need)
+                                  {
+            if (m_gridCells.size() < need)
+                m_gridCells.resize(static_cast<int>(need));
+            return m_gridCells.data(); });
+    }
+    if (r.isArray())
+    {
+        qsizetype n = 0;
+        if (r.isLengthKnown() && m_gridCells.size() < static_cast<qsizetype>(r.length()))
+            m_gridCells.resize(static_cast<int>(r.length()));
+        r.enterContainer();
+        while (r.hasNext() && r.lastError() == QCborError::NoError)
+        {
+            const qint8 v = static_cast<qint8>(readNumber(r));
+            if (n >= m_gridCells.size())
+                m_gridCells.resize(static_cast<int>(qMax<qsizetype>(64, 2 * n)));
+            m_gridCells.data()[n++] = static_cast<char>(v);
+        }
+        r.leaveContainer();
+        return n;
+    }
+    r.next();
+    return -1;
+}
+
+bool RosBridgeDecoder::readOccupancyGrid(QCborStreamReader &r, RosBridgeMessage &out, bool full)
+{
+    OccupancyGridPatch &grid = out.grid;
+    grid.full = full;
+    grid.x = grid.y = 0;
+    grid.resolution = grid.originX = grid.originY = 0.0;
+    int width = 0, height = 0;
+    qsizetype cells = -1;
+
+    // 宽高等字段在 /map 的 info 中，在 /map_updates 中与 data 同级；data 可能先于宽高出现，读完整个 msg 后再转换
+    auto readDims = [&](QLatin1String key)
+    {
+        if (key == QLatin1String("width"))
+            width = static_cast<int>(readNumber(r));
+        else if (key == QLatin1String("height"))
+            height = static_cast<int>(readNumber(r));
+        else
+            return false;
+        return true;
+    };
+
+    const bool isMap = readMap(r, [&](QLatin1String key)
+                               {
+        if (key == QLatin1String("data"))
+        {
+            cells = readGridCells(r);
+            return true;
+        }
+        if (!full)
+        {
+            if (key == QLatin1String("x"))
+                grid.x = static_cast<int>(readNumber(r));
+            else if (key == QLatin1String("y"))
+                grid.y = static_cast<int>(readNumber(r));
+            else
+                return readDims(key);
+            return true;
+        }
+        if (key != QLatin1String("info"))
+            return false;
+
+        readMap(r, [&](QLatin1String infoKey)
+                {
+            if (infoKey == QLatin1String("resolution"))
+            {
+                grid.resolution = readNumber(r);
+                return true;
+            }
+            if (infoKey != QLatin1String("origin"))
+                return readDims(infoKey);
+            // origin 为 geometry_msgs/Pose，只取 position 的 x y，地图不旋转
+            readMap(r, [&](QLatin1String poseKey)
+                    {
+                if (poseKey != QLatin1String("position"))
+                    return false;
+                readMap(r, [&](QLatin1String axis)
+                        {
+                    if (axis == QLatin1String("x"))
+                        grid.originX = readNumber(r);
+                    else if (axis == QLatin1String("y"))
+                        grid.originY = readNumber(r);
+                    else
+                        return false;
+                    return true; });
+                return true; });
+            return true; });
+        return true; });
+
+    if (!isMap || cells < 0 || r.lastError() != QCborError::NoError)
+        return false;
+    return OccupancyGrid::toGray(reinterpret_cast<const qint8 *>(m_gridCells.constData()), cells, width, height, grid.image);
+}
+
+// ---- DOM 路径 ----
+
+QByteArray RosBridgeDecoder::extractByteArray(const QCborValue &val)
+{
+    if (val.isByteArray())
+        return val.toByteArray();
+    if (val.isTag())
+    {
+        QCborValue taggedVal = val.taggedValue();
+        if (taggedVal.isByteArray())
+            return taggedVal.toByteArray();
+    }
+    return QByteArray();
+}
+
+bool RosBridgeDecoder::decodeDom(const QByteArray &frame, RosBridgeMessage &out)
+{
+    out.topic = Topic::Unknown;
+
+    QCborParserError error;
+    QCborValue val = QCborValue::fromCbor(frame, &error);
+    if (error.error != QCborError::NoError || !val.isMap())
+        return false;
+
+    QCborMap map = val.toMap();
+    if (map[QStringLiteral("op")].toString() != QLatin1String("publish"))
+        return false;
+
+    const Topic topic = lookupTopic(map[QStringLiteral("topic")].toString());
+    QCborValue msgVal = map[QStringLiteral("msg")];
+    if (topic == Topic::Unknown || !msgVal.isMap())
+        return false;
+
+    QCborMap msg = msgVal.toMap();
+    // 各话题的数据都在 "data" 字段中（栅格地图另有宽高与原点）
+    if (!msg.contains(QStringLiteral("data")))
+        return false;
+    QCborValue dataVal = msg[QStringLiteral("data")];
+
+    switch (topic)
+    {
+    case Topic::LaserPoints:
+    {
+        QByteArray byteArray = extractByteArray(dataVal);
+        std::shared_ptr<PointCloudBuffer> cloud;
+
+        if (!byteArray.isEmpty())
+        {
+            // Float32 占用 4 字节，每 3 个值为一组 (x, y, 0)，单位为 m；只保留 x y
+            const int count = byteArray.size() / 12;
+            cloud = PointCloudPool::instance()->acquire(count);
+            const char *src = byteArray.constData();
+            float *dst = cloud->xy();
+            for (int i = 0; i < count; ++i, src += 12, dst += 2)
+                std::memcpy(dst, src, 2 * sizeof(float));
+        }
+        else if (dataVal.isArray())
+        {
+            QCborArray arr = dataVal.toArray();
+            const int count = static_cast<int>(arr.size() / 3);
+            cloud = PointCloudPool::instance()->acquire(count);
+            float *dst = cloud->xy();
+            for (int i = 0; i < count; ++i)
+            {
+                *dst++ = static_cast<float>(arr[3 * i].toDouble());
+                *dst++ = static_cast<float>(arr[3 * i + 1].toDouble());
+            }
+        }
+        else
+        {
+            cloud = PointCloudPool::instance()->acquire(0);
+        }
+
+        cloud->stampUs = msg.value(QStringLiteral("sim_stamp_us")).toInteger(-1);
+        out.cloud = std::move(cloud);
+        break;
+    }
+    case Topic::MapName:
+        // std_msgs/String 只有一个字段: "data"
+        out.mapName = dataVal.toString();
+        break;
+    case Topic::AgvState:
+    {
+        out.agvState.clear();
+        // 1. 尝试作为二进制数据解析 (Rosbridge 可能会将 int32[] 压缩为字节流)
+        QByteArray byteArray = extractByteArray(dataVal);
+        if (!byteArray.isEmpty())
+        {
+            // Int32 占用 4 字节
+            const int count = byteArray.size() / 4;
+            out.agvState.resize(count);
+            std::memcpy(out.agvState.data(), byteArray.constData(), static_cast<size_t>(count) * 4);
+        }
+        // 2. 尝试作为普通 CBOR 数组解析 (即标准 JSON 数组格式 [1, 2, 3])
+        else if (dataVal.isArray())
+        {
+            QCborArray arr = dataVal.toArray();
+            out.agvState.reserve(arr.size());
+            for (const QCborValue &v : arr)
+                out.agvState.append(static_cast<int>(v.toInteger()));
+        }
+        break;
+    }
+    case Topic::Map:
+    case Topic::MapUpdate:
+    {
+        OccupancyGridPatch &grid = out.grid;
+        grid.full = topic == Topic::Map;
+        grid.x = grid.y = 0;
+
+        QByteArray cells = extractByteArray(dataVal);
+        if (cells.isEmpty() && dataVal.isArray())
+        {
+            const QCborArray arr = dataVal.toArray();
+            cells.resize(static_cast<int>(arr.size()));
+            for (int i = 0; i < cells.size(); ++i)
+                cells[i] = static_cast<char>(arr[i].toInteger());
+        }
+
+        QCborMap dims = msg;
+        if (grid.full)
+        {
+            dims = msg.value(QStringLiteral("info")).toMap();
+            grid.resolution = dims.value(QStringLiteral("resolution")).toDouble();
+            const QCborMap position = dims.value(QStringLiteral("origin")).toMap().value(QStringLiteral("position")).toMap();
+            grid.originX = position.value(QStringLiteral("x")).toDouble();
+            grid.originY = position.value(QStringLiteral("y")).toDouble();
+        }
+        else
+        {
+            grid.x = static_cast<int>(msg.value(QStringLiteral("x")).toInteger());
+            grid.y = static_cast<int>(msg.value(QStringLiteral("y")).toInteger());
+        }
+        const int width = static_cast<int>(dims.value(QStringLiteral("width")).toInteger());
+        const int height = static_cast<int>(dims.value(QStringLiteral("height")).toInteger());
+        if (!OccupancyGrid::toGray(reinterpret_cast<const qint8 *>(cells.constData()), cells.size(), width, height, grid.image))
+            return false;
+        break;
+    }
+    default:
+        return false;
+    }
+
+    out.topic = topic;
+    return true;
+}
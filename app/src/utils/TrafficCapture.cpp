@@ -0,0 +1,170 @@
+#include "TrafficCapture.h"
+#include <QDir>
+#include <QFileInfo>
+#include <QtEndian>
+#include <cstring>
+
+const char TrafficCapture::MAGIC[4] = {'R', 'T', 'R', 'C'};
+const char TrafficCapture::FILE_SUFFIX[] = ".rtrc";
+
+QByteArray TrafficCapture::fileHeader(qint64 wallMs, qint64 startNs)
+{
+    QByteArray out(FILE_HEADER_SIZE, '\0');
+    char *p = out.data();
+    std::memcpy(p, MAGIC, 4);
+    qToLittleEndian<quint16>(VERSION, p + 4);
+    qToLittleEndian<qint64>(wallMs, p + 8);
+    qToLittleEndian<qint64>(startNs, p + 16);
+    return out;
+}
+
+void TrafficCapture::appendRecordHeader(QByteArray &out, Channel channel, Kind kind, qint64 timeNs, int length)
+{
+    char header[RECORD_HEADER_SIZE] = {};
+    qToLittleEndian<quint32>(static_cast<quint32>(length), header);
+    header[4] = static_cast<char>(channel);
+    header[5] = static_cast<char>(kind);
+    qToLittleEndian<qint64>(timeNs, header + 8);
+    out.append(header, RECORD_HEADER_SIZE);
+}
+
+const char *TrafficCapture::channelName(Channel channel)
+{
+    switch (channel)
+    {
+    case Channel::Comm:
+        return "comm";
+    case Channel::RosBridge:
+        return "rosbridge";
+    case Channel::Truck:
+        return "truck";
+    }
+    return "unknown";
+}
+
+// ---- 读取 ----
+
+TrafficCaptureReader::~TrafficCaptureReader()
+{
+    closeFile();
+}
+
+bool TrafficCaptureReader::open(const QString &path, QString &error)
+{
+    closeFile();
+    m_files.clear();
+    m_fileIndex = -1;
+    m_truncated = false;
+
+    QFileInfo info(path);
+    if (info.isDir())
+    {
+        QDir dir(path);
+        const QStringList names = dir.entryList({QStringLiteral("*") + QLatin1String(TrafficCapture::FILE_SUFFIX)},
+                                                QDir::Files, QDir::Name);
+        for (const QString &name : names)
+            m_files.append(dir.filePath(name));
+    }
+    else if (info.isFile())
+    {
+        m_files.append(path);
+    }
+
+    if (m_files.isEmpty())
+    {
+        error = QStringLiteral("找不到录制文件: %1").arg(path);
+        return false;
+    }
+    return true;
+}
+
+void TrafficCaptureReader::closeFile()
+{
+    if (m_map)
+    {
+        m_file.unmap(const_cast<uchar *>(m_map));
+        m_map = nullptr;
+    }
+    m_file.close();
+    m_size = 0;
+    m_pos = 0;
+}
+
+bool TrafficCaptureReader::openNextFile()
+{
+    while (++m_fileIndex < m_files.size())
+    {
+        closeFile();
+        m_file.setFileName(m_files.at(m_fileIndex));
+        if (!m_file.open(QIODevice::ReadOnly))
+        {
+            m_truncated = true;
+            continue;
+        }
+
+        m_size = m_file.size();
+        if (m_size < TrafficCapture::FILE_HEADER_SIZE)
+        {
+            // 刚创建就崩溃的段，没有任何记录
+            m_truncated = m_truncated || m_size > 0;
+            continue;
+        }
+
+        m_map = m_file.map(0, m_size);
+        if (!m_map || std::memcmp(m_map, TrafficCapture::MAGIC, 4) != 0 ||
+            qFromLittleEndian<quint16>(m_map + 4) != TrafficCapture::VERSION)
+        {
+            m_truncated = true;
+            continue;
+        }
+
+        m_pos = TrafficCapture::FILE_HEADER_SIZE;
+        return true;
+    }
+    closeFile();
+    return false;
+}
+
+bool TrafficCaptureReader::next(Record &record)
+{
+    for (;;)
+    {
+        if (!m_map && !openNextFile())
+            return false;
+
+        const qint64 remain = m_size - m_pos;
+        if (remain == 0)
+        {
+            closeFile();
+            continue;
+        }
+        if (remain < TrafficCapture::RECORD_HEADER_SIZE)
+        {
+            m_truncated = true;
+            closeFile();
+            continue;
+        }
+
+        const uchar *header = m_map + m_pos;
+        const quint32 length = qFromLittleEndian<quint32>(header);
+        const bool valid = length <= 0x7fffffffu &&
+                           header[4] <= static_cast<uchar>(TrafficCapture::Channel::Truck) &&
+                           header[5] <= static_cast<uchar>(TrafficCapture::Kind::Binary);
+        const qint64 total = TrafficCapture::RECORD_HEADER_SIZE + qint64(length) +
+                             (valid ? TrafficCapture::paddingFor(static_cast<int>(length)) : 0);
+        if (!valid || total > remain)
+        {
+            m_truncated = true;
+            closeFile();
+            continue;
+        }
+
+        record.channel = static_cast<TrafficCapture::Channel>(header[4]);
+        record.kind = static_cast<TrafficCapture::Kind>(header[5]);
+        record.timeNs = qFromLittleEndian<qint64>(header + 8);
+        record.data = reinterpret_cast<const char *>(header + TrafficCapture::RECORD_HEADER_SIZE);
+        record.size = static_cast<int>(length);
+        m_pos += total;
+        return true;
+    }
+}
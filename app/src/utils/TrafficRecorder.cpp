@@ -0,0 +1,212 @@
+#include "TrafficRecorder.h"
+#include <QDateTime>
+#include <QDir>
+
+TrafficRecorder *TrafficRecorder::instance()
+{
+    static TrafficRecorder instance;
+    return &instance;
+}
+
+TrafficRecorder::~TrafficRecorder()
+{
+    // 静态析构阶段日志可能已不可用，这里只结束写线程并关闭文件；正常退出时由 main 调用 stop
+    stopWriter();
+    m_file.close();
+}
+
+void TrafficRecorder::start(Mode mode, const QString &folder, int ringMinutes)
+{
+    QMutexLocker locker(&m_mutex);
+    if (m_writer || mode == Mode::Off)
+        return;
+
+    const QString stamp = QDateTime::currentDateTime().toString(QStringLiteral("yyyyMMdd-hhmmss"));
+    m_mode = mode;
+    m_clock.start();
+    m_records = 0;
+    m_bytes = 0;
+    m_dropped.store(0, std::memory_order_relaxed);
+    m_buffer.reserve(64 * 1024); // 预留后 resize(0) 不释放容量
+    // 两侧队列预留满容量，交换后 clear 保留容量，入队不再分配
+    m_pending.reserve(MAX_PENDING);
+    m_writing.reserve(MAX_PENDING);
+
+    bool ok;
+    if (mode == Mode::Ring)
+    {
+        // 每次启动使用独立的目录，目录下的段按序号排列，回放时直接指定目录
+        m_folder = QDir(folder).filePath(QStringLiteral("ring-%1").arg(stamp));
+        m_ringSegments = qMax(1, ringMinutes) + 1; // 多留一段，保证完整覆盖 N 分钟
+        m_segmentIndex = 0;
+        m_segments.clear();
+        ok = QDir().mkpath(m_folder) && rotateSegment(0);
+    }
+    else
+    {
+        m_folder = folder;
+        ok = QDir().mkpath(m_folder) &&
+             openFile(QDir(m_folder).filePath(QStringLiteral("capture-%1%2").arg(stamp, QLatin1String(TrafficCapture::FILE_SUFFIX))), 0);
+    }
+
+    if (!ok)
+    {
+        logger->log(QStringLiteral("TrafficRecorder"), spdlog::level::err, QStringLiteral("无法创建录制文件: %1").arg(m_folder));
+        m_file.close();
+        return;
+    }
+
+    m_stopWriter = false;
+    m_recording.store(true, std::memory_order_relaxed);
+    m_writer = QThread::create([this]
+                               { writerLoop(); });
+    m_writer->setObjectName(QStringLiteral("TrafficRecorder"));
+    m_writer->start(QThread::LowPriority);
+    logger->log(QStringLiteral("TrafficRecorder"), spdlog::level::info,
+                mode == Mode::Ring ? QStringLiteral("开始环形录制入站流量，保留最近 %1 分钟: %2").arg(m_ringSegments - 1).arg(m_folder)
+                                   : QStringLiteral("开始录制入站流量: %1").arg(m_file.fileName()));
+}
+
+void TrafficRecorder::stop()
+{
+    QMutexLocker locker(&m_mutex);
+    if (!m_writer)
+        return;
+    // 写线程先写完队列中剩余的帧再退出
+    stopWriter();
+    m_file.close();
+
+    logger->log(QStringLiteral("TrafficRecorder"), spdlog::level::info,
+                QStringLiteral("停止录制，共 %1 帧，%2 KB，队列满丢弃 %3 帧")
+                    .arg(m_records)
+                    .arg(m_bytes / 1024)
+                    .arg(m_dropped.load(std::memory_order_relaxed)));
+}
+
+void TrafficRecorder::stopWriter()
+{
+    if (!m_writer)
+        return;
+
+    {
+        QMutexLocker locker(&m_queueMutex);
+        m_recording.store(false, std::memory_order_relaxed);
+        m_stopWriter = true;
+        m_queueNotEmpty.wakeOne();
+    }
+    m_writer->wait();
+    delete m_writer;
+    m_writer = nullptr;
+}
+
+bool TrafficRecorder::openFile(const QString &path, qint64 startNs)
+{
+    m_file.close();
+    m_file.setFileName(path);
+    // 不经过 QFile 的写缓冲，写线程每批记录一次 write 直接进入内核，进程崩溃时不会丢失已写出的帧
+    if (!m_file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Unbuffered))
+        return false;
+
+    const QByteArray header = TrafficCapture::fileHeader(QDateTime::currentMSecsSinceEpoch(), startNs);
+    return m_file.write(header) == header.size();
+}
+
+bool TrafficRecorder::rotateSegment(qint64 nowNs)
+{
+    const QString path = QDir(m_folder).filePath(
+        QStringLiteral("seg-%1%2").arg(m_segmentIndex++, 6, 10, QLatin1Char('0')).arg(QLatin1String(TrafficCapture::FILE_SUFFIX)));
+    if (!openFile(path, nowNs))
+        return false;
+
+    m_segmentStartNs = nowNs;
+    m_segments.enqueue(path);
+    while (m_segments.size() > m_ringSegments)
+        QFile::remove(m_segments.dequeue());
+    return true;
+}
+
+void TrafficRecorder::write(TrafficCapture::Channel channel, TrafficCapture::Kind kind, const QByteArray &payload)
+{
+    // 调用方只入队，锁内没有 I/O；时间戳在锁内取，保证队列内单调
+    QMutexLocker locker(&m_queueMutex);
+    if (!m_recording.load(std::memory_order_relaxed))
+        return;
+    if (m_pending.size() >= MAX_PENDING)
+    {
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    m_pending.append(PendingRecord{channel, kind, m_clock.nsecsElapsed(), payload});
+    if (m_pending.size() == 1)
+        m_queueNotEmpty.wakeOne();
+}
+
+void TrafficRecorder::writerLoop()
+{
+    forever
+    {
+        {
+            QMutexLocker locker(&m_queueMutex);
+            while (m_pending.isEmpty() && !m_stopWriter)
+                m_queueNotEmpty.wait(&m_queueMutex);
+            if (m_pending.isEmpty())
+                return; // 已请求停止且队列已写完
+            m_writing.swap(m_pending);
+        }
+
+        const bool ok = writeBatch();
+        m_writing.clear();
+        if (!ok)
+        {
+            QMutexLocker locker(&m_queueMutex);
+            m_recording.store(false, std::memory_order_relaxed);
+            m_pending.clear();
+            return;
+        }
+    }
+}
+
+bool TrafficRecorder::writeBatch()
+{
+    // 一批记录拼进同一个缓冲区，一次 write 写出；缓冲区容量只增不减，稳定后不再分配
+    m_buffer.resize(0);
+    for (const PendingRecord &record : qAsConst(m_writing))
+    {
+        if (m_mode == Mode::Ring && record.ns - m_segmentStartNs >= SEGMENT_NS)
+        {
+            if (!flushBuffer())
+                return false;
+            if (!rotateSegment(record.ns))
+            {
+                logger->log(QStringLiteral("TrafficRecorder"), spdlog::level::err, QStringLiteral("无法切换录制分段，停止录制: %1").arg(m_folder));
+                return false;
+            }
+        }
+
+        TrafficCapture::appendRecordHeader(m_buffer, record.channel, record.kind, record.ns, record.payload.size());
+        m_buffer.append(record.payload);
+        m_buffer.append(TrafficCapture::paddingFor(record.payload.size()), '\0');
+        ++m_records;
+
+        if (m_buffer.size() >= FLUSH_BYTES && !flushBuffer())
+            return false;
+    }
+    return flushBuffer();
+}
+
+bool TrafficRecorder::flushBuffer()
+{
+    if (m_buffer.isEmpty())
+        return true;
+
+    if (m_file.write(m_buffer) != m_buffer.size())
+    {
+        logger->log(QStringLiteral("TrafficRecorder"), spdlog::level::err, QStringLiteral("写入录制文件失败，停止录制: %1").arg(m_file.fileName()));
+        m_file.close();
+        return false;
+    }
+    m_bytes += static_cast<quint64>(m_buffer.size());
+    m_buffer.resize(0);
+    return true;
+}
@@ -0,0 +1,106 @@
+#include "TrafficReplay.h"
+#include "TrafficCapture.h"
+#include <QElapsedTimer>
+
+static TrafficReplay *s_active = nullptr;
+
+TrafficReplay::TrafficReplay(const QString &path, double speed, QObject *parent)
+    : QThread(parent), m_path(path), m_speed(speed)
+{
+    setObjectName(QStringLiteral("Replay"));
+    s_active = this;
+}
+
+TrafficReplay::~TrafficReplay()
+{
+    stop();
+    wait();
+    if (s_active == this)
+        s_active = nullptr;
+}
+
+TrafficReplay *TrafficReplay::active()
+{
+    return s_active;
+}
+
+void TrafficReplay::stop()
+{
+    m_stop.store(true, std::memory_order_relaxed);
+}
+
+void TrafficReplay::waitUntil(qint64 dueNs, const QElapsedTimer &clock)
+{
+    for (;;)
+    {
+        const qint64 remainNs = dueNs - clock.nsecsElapsed();
+        if (remainNs <= 0 || m_stop.load(std::memory_order_relaxed))
+            return;
+        if (remainNs > 2000000)
+            QThread::msleep(static_cast<unsigned long>(qMin<qint64>(remainNs / 1000000 - 1, 100)));
+        else
+            QThread::yieldCurrentThread();
+    }
+}
+
+void TrafficReplay::run()
+{
+    TrafficCaptureReader reader;
+    QString error;
+    if (!reader.open(m_path, error))
+    {
+        logger->log(QStringLiteral("TrafficReplay"), spdlog::level::err, error);
+        return;
+    }
+
+    const QString speedText = m_speed > 0 ? QStringLiteral("%1x").arg(m_speed) : QStringLiteral("最快速度");
+    logger->log(QStringLiteral("TrafficReplay"), spdlog::level::info,
+                QStringLiteral("开始回放 %1（%2 个文件），%3").arg(m_path).arg(reader.fileCount()).arg(speedText));
+
+    quint64 counts[3] = {0, 0, 0};
+    qint64 firstNs = -1;
+    qint64 lastNs = 0;
+    QElapsedTimer clock;
+    clock.start();
+
+    TrafficCaptureReader::Record rec;
+    while (!m_stop.load(std::memory_order_relaxed) && reader.next(rec))
+    {
+        if (firstNs < 0)
+            firstNs = rec.timeNs;
+        lastNs = rec.timeNs;
+        if (m_speed > 0)
+            waitUntil(static_cast<qint64>((rec.timeNs - firstNs) / m_speed), clock);
+
+        const bool text = rec.kind == TrafficCapture::Kind::Text;
+        switch (rec.channel)
+        {
+        case TrafficCapture::Channel::Comm:
+            if (text)
+                emit commTextMessage(QString::fromUtf8(rec.data, rec.size));
+            else
+                emit commBinaryMessage(QByteArray(rec.data, rec.size));
+            break;
+        case TrafficCapture::Channel::RosBridge:
+            emit rosBinaryMessage(QByteArray(rec.data, rec.size));
+            break;
+        case TrafficCapture::Channel::Truck:
+            emit truckTextMessage(QString::fromUtf8(rec.data, rec.size));
+            break;
+        }
+        ++counts[static_cast<int>(rec.channel)];
+    }
+
+    const double elapsedMs = clock.nsecsElapsed() / 1e6;
+    const double spanMs = firstNs < 0 ? 0.0 : (lastNs - firstNs) / 1e6;
+    const quint64 total = counts[0] + counts[1] + counts[2];
+    logger->log(QStringLiteral("TrafficReplay"), reader.truncated() ? spdlog::level::warn : spdlog::level::info,
+                QStringLiteral("回放结束：comm %1 帧，rosbridge %2 帧，truck %3 帧；录制时长 %4 ms，回放用时 %5 ms，%6 帧/s%7")
+                    .arg(counts[0])
+                    .arg(counts[1])
+                    .arg(counts[2])
+                    .arg(spanMs, 0, 'f', 0)
+                    .arg(elapsedMs, 0, 'f', 0)
+                    .arg(elapsedMs > 0 ? total * 1000.0 / elapsedMs : 0.0, 0, 'f', 0)
+                    .arg(reader.truncated() ? QStringLiteral("（录制文件末尾不完整，已忽略）") : QString()));
+}
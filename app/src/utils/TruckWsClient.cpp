@@ -1,7 +1,8 @@
 #include "TruckWsClient.h"
+#include "TrafficRecorder.h"
 
 TruckWsClient::TruckWsClient(QObject *parent)
-    : QObject(parent), m_client(nullptr), m_thread(nullptr)
+    : QObject(parent), m_client(nullptr)
 {
     // 初始化数据戳
     dataStamps = 0;
@@ -32,21 +33,28 @@ void TruckWsClient::initalReqJson()
     // requestState["Event"] = "REQUEST_AGV_STATE";
     // requestState["Body"] = "";
     // requestState["ErrorMessage"] = "";
+
+    // {"DateTime": "...", "Event": "REQUEST_TRUCK_SIZE"}
+    truckSizeReq.beginObject(2);
+    truckSizeReq.key(QStringLiteral("DateTime"));
+    truckSizeReq.dateTimeSlot();
+    truckSizeReq.key(QStringLiteral("Event"));
+    truckSizeReq.literal(QStringLiteral("REQUEST_TRUCK_SIZE"));
+    truckSizeReq.endObject();
 }
 
 void TruckWsClient::start()
 {
-    if (m_thread && m_thread->isRunning())
+    if (m_client)
     {
         return; // 避免重复启动
     }
 
-    // 1. 创建对象和线程
-    m_thread = new QThread(this);
+    // 1. 创建对象
     m_client = new WebsocketClient(); // 注意：不能加 parent，因为要 moveToThread
 
-    // 2. 移动到子线程
-    m_client->moveToThread(m_thread);
+    // 2. 托管到网络 I/O 线程
+    NetworkReactor::instance()->attach(m_client);
 
     // 3. 读取配置
     QString ip = cfg->truckLoadingIp();
@@ -54,13 +62,6 @@ void TruckWsClient::start()
     QString url = QStringLiteral("ws://%1:%2").arg(ip).arg(port);
 
     // 4. 绑定信号槽
-    // 4.1 线程启动 -> 执行连接
-    connect(m_thread, &QThread::started, m_client, [this, url]()
-            { m_client->connectToServer(url); });
-
-    // 4.2 线程结束 -> 销毁对象
-    connect(m_thread, &QThread::finished, m_client, &QObject::deleteLater);
-
     // 4.3 底层状态 -> 本类内部槽 -> 转发给外部
     connect(m_client, &WebsocketClient::connected, this, &TruckWsClient::onInternalConnected);
     connect(m_client, &WebsocketClient::disconnected, this, &TruckWsClient::onInternalDisconnected);
@@ -69,8 +70,10 @@ void TruckWsClient::start()
     // 4.4 发送数据：本类信号(主线程) -> 底层槽(子线程)
     connect(this, &TruckWsClient::sigInternalSendText, m_client, &WebsocketClient::sendTextMessage);
 
-    // 5. 启动线程
-    m_thread->start();
+    // 5. 在 I/O 线程中发起连接
+    WebsocketClient *client = m_client;
+    QMetaObject::invokeMethod(client, [client, url]()
+                              { client->connectToServer(url); }, Qt::QueuedConnection);
 }
 
 void TruckWsClient::stop()
@@ -79,14 +82,12 @@ void TruckWsClient::stop()
     if (m_pollTimer->isActive())
         m_pollTimer->stop();
 
-    if (m_thread && m_thread->isRunning())
+    if (m_client)
     {
-        // 请求子线程退出
-        m_thread->quit();
-        m_thread->wait();
+        // 在 I/O 线程中销毁底层客户端并等待完成
+        NetworkReactor::instance()->detach(m_client);
+        m_client = nullptr;
     }
-    // m_client 会自动析构，因为绑定了 finished->deleteLater
-    // m_thread 是 this 的子对象，也会自动析构，或者可以手动 delete
 }
 
 // --- 业务逻辑封装区域 ---
@@ -150,24 +151,19 @@ void TruckWsClient::onInternalDisconnected()
 void TruckWsClient::onInternalTextReceived(const QString &msg)
 {
     // logger->log("TruckWsClient", spdlog::level::info, msg);
+    TrafficRecorder::instance()->record(TrafficCapture::Channel::Truck, msg);
     // 解析接收到的消息
     parseMsg(msg);
 }
 
-void TruckWsClient::requestTruckSize()
+void TruckWsClient::injectTextMessage(const QString &msg)
 {
-    QJsonObject req;
-
-    QDateTime cur_time = QDateTime::currentDateTime();
-    QString timeStr = cur_time.toString("yyyy-MM-dd hh:mm:ss.zzz");
-
-    req.insert(QStringLiteral("DateTime"), timeStr);
-    req.insert(QStringLiteral("Event"), QStringLiteral("REQUEST_TRUCK_SIZE"));
-
-    QJsonDocument docReq(req);
-    QString jsonReqeStr = docReq.toJson(QJsonDocument::Compact);
+    parseMsg(msg);
+}
 
-    emit sigInternalSendText(jsonReqeStr);
+void TruckWsClient::requestTruckSize()
+{
+    emit sigInternalSendText(truckSizeReq.encodeJson());
 }
 
 void TruckWsClient::parseMsg(const QString &msg)
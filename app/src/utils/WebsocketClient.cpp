@@ -79,6 +79,44 @@ void WebsocketClient::sendTextMessage(const QString &message)
     }
 }
 
+void WebsocketClient::enqueueTextMessage(const QString &message, SendPriority priority)
+{
+    OutboundQueue::Frame frame;
+    frame.text = message;
+    enqueueFrame(frame, priority);
+}
+
+void WebsocketClient::enqueueBinaryMessage(const QByteArray &data, SendPriority priority)
+{
+    OutboundQueue::Frame frame;
+    frame.binary = data;
+    frame.isBinary = true;
+    enqueueFrame(frame, priority);
+}
+
+void WebsocketClient::enqueueFrame(const OutboundQueue::Frame &frame, SendPriority priority)
+{
+    // 同一批次只投递一次，队列中的所有帧由一次 drainSendQueue 发出
+    if (m_sendQueue.push(frame, priority == SendPriority::Control))
+    {
+        QMetaObject::invokeMethod(this, &WebsocketClient::drainSendQueue, Qt::QueuedConnection);
+    }
+}
+
+void WebsocketClient::drainSendQueue()
+{
+    m_sendQueue.drain([this](const OutboundQueue::Frame &frame)
+                      { sendFrame(frame); });
+}
+
+void WebsocketClient::sendFrame(const OutboundQueue::Frame &frame)
+{
+    if (frame.isBinary)
+        sendBinaryMessage(frame.binary);
+    else
+        sendTextMessage(frame.text);
+}
+
 void WebsocketClient::sendBinaryMessage(const QByteArray &data)
 {
     if (m_webSocket && m_webSocket->isValid())
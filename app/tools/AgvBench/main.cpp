@@ -0,0 +1,368 @@
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QCborValue>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTextStream>
+#include <QVector>
+#include <cstdio>
+#include "AgvFrameDecoder.h"
+#include "FrameEncoder.h"
+#include "OutboundQueue.h"
+#include "TrafficCapture.h"
+#include "AllocCounter.h"
+
+// AGV 帧解码的微基准：对比 DOM 解析（QJsonDocument）与流式解析的单帧耗时和内存分配次数
+
+static bool sameSnapshot(const AgvSnapshot &a, const AgvSnapshot &b)
+{
+#define AGV_CMP_FIELD(type, member, getter, key, init) \
+    if (a.member != b.member)                           \
+        return false;
+    AGV_INFO_FIELDS(AGV_CMP_FIELD)
+    AGV_OPTIONAL_INFO_FIELDS(AGV_CMP_FIELD)
+    AGV_TASK_FIELDS(AGV_CMP_FIELD)
+#undef AGV_CMP_FIELD
+    return a.optionalInfo == b.optionalInfo;
+}
+
+static QJsonObject attr(const QJsonValue &value, const QString &color = QStringLiteral("#000000"))
+{
+    QJsonObject obj;
+    obj.insert(QStringLiteral("value"), value);
+    obj.insert(QStringLiteral("color"), color);
+    return obj;
+}
+
+// 合成帧：字段表中的全部 AGVInfo 字段，每帧只有位姿和速度变化，与现场轮询数据的特征一致
+// idle 为 true 时模拟车辆静止，所有帧除 DataStamps 外完全相同
+static QVector<QString> syntheticFrames(int count, bool idle)
+{
+    QVector<QString> frames;
+    for (int n = 0; n < count; ++n)
+    {
+        const int i = idle ? 0 : n;
+        QJsonObject info;
+#define AGV_SYN_FIELD(type, member, getter, key, init) info.insert(QStringLiteral(key), attr(type(init).value));
+        AGV_INFO_FIELDS(AGV_SYN_FIELD)
+#undef AGV_SYN_FIELD
+        info.insert(QStringLiteral("slam_x"), attr(5000 + i * 7));
+        info.insert(QStringLiteral("slam_y"), attr(-3000 + i * 3));
+        info.insert(QStringLiteral("slam_angle"), attr((i * 11) % 36000));
+        info.insert(QStringLiteral("v_x"), attr(600 + i % 20, QStringLiteral("#00FF00")));
+
+        QJsonObject optional;
+        optional.insert(QStringLiteral("lift_height"), attr(i / 100));
+
+        QJsonObject body;
+        body.insert(QStringLiteral("AGVInfo"), info);
+        body.insert(QStringLiteral("OptionalINFO"), optional);
+
+        QJsonObject root;
+        root.insert(QStringLiteral("Event"), QStringLiteral("AGV_STATE"));
+        root.insert(QStringLiteral("IsSucceed"), true);
+        root.insert(QStringLiteral("DataStamps"), n);
+        root.insert(QStringLiteral("Body"), body);
+        frames.append(QString::fromUtf8(QJsonDocument(root).toJson(QJsonDocument::Compact)));
+    }
+    return frames;
+}
+
+// 每行一帧 JSON，空行忽略
+static QVector<QString> loadFrames(const QString &path)
+{
+    QVector<QString> frames;
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+        return frames;
+
+    QTextStream in(&file);
+    in.setCodec("UTF-8");
+    while (!in.atEnd())
+    {
+        const QString line = in.readLine().trimmed();
+        if (!line.isEmpty())
+            frames.append(line);
+    }
+    return frames;
+}
+
+// 从流量录制文件（或环形录制目录）中取出数据通讯的 JSON 文本帧
+static QVector<QString> loadCapture(const QString &path)
+{
+    QVector<QString> frames;
+    TrafficCaptureReader reader;
+    QString error;
+    if (!reader.open(path, error))
+    {
+        std::fprintf(stderr, "%s\n", qPrintable(error));
+        return frames;
+    }
+
+    TrafficCaptureReader::Record rec;
+    while (reader.next(rec))
+    {
+        if (rec.channel == TrafficCapture::Channel::Comm && rec.kind == TrafficCapture::Kind::Text)
+            frames.append(QString::fromUtf8(rec.data, rec.size));
+    }
+    return frames;
+}
+
+struct BenchResult
+{
+    double nsPerFrame = 0;
+    double allocsPerFrame = 0;
+    AgvSnapshot finalSnapshot;
+    QVector<quint64> masks; // 第一轮每帧的变化位掩码，用于校验两条路径一致
+    AgvDecodeStats decodeStats;
+};
+
+template <typename Decode>
+static BenchResult runBench(const QVector<QString> &frames, int rounds, Decode decode)
+{
+    BenchResult result;
+    AgvFrameDecoder decoder;
+    AgvSnapshot snap = AgvSnapshot::initial();
+    AgvFrame frame;
+    QString error;
+
+    // 预热一轮，同时记录每帧的变化位掩码
+    for (const QString &msg : frames)
+    {
+        decode(decoder, msg, snap, frame, error);
+        result.masks.append(frame.changed);
+    }
+
+    const quint64 allocBefore = AllocCounter::count();
+    QElapsedTimer timer;
+    timer.start();
+    for (int r = 0; r < rounds; ++r)
+    {
+        for (const QString &msg : frames)
+            decode(decoder, msg, snap, frame, error);
+    }
+    const qint64 ns = timer.nsecsElapsed();
+    const quint64 allocs = AllocCounter::count() - allocBefore;
+
+    const double total = static_cast<double>(frames.size()) * rounds;
+    result.nsPerFrame = ns / total;
+    result.allocsPerFrame = allocs / total;
+    result.finalSnapshot = snap;
+    result.decodeStats = decoder.stats();
+    return result;
+}
+
+// ---- TOUCH_STATE 发送编码 ----
+
+// 第 i 次发送的 TOUCH_STATE 值，模拟手动控制时速度、方向不断变化
+struct TouchValues
+{
+    bool pageControl;
+    int manualDir;
+    int manualVx;
+    int manualVth;
+    int iniX;
+    int iniY;
+    int iniW;
+};
+
+static TouchValues touchValues(int i)
+{
+    TouchValues v;
+    v.pageControl = (i & 1) != 0;
+    v.manualDir = i % 9;
+    v.manualVx = (i % 2001) - 1000;
+    v.manualVth = (i % 61) - 30;
+    v.iniX = i * 7;
+    v.iniY = -i * 3;
+    v.iniW = i % 360;
+    return v;
+}
+
+// 改造前的做法：每次构建 QJsonObject 树再序列化
+static QJsonObject touchStateJson(int i)
+{
+    const TouchValues v = touchValues(i);
+    QJsonObject body;
+    body.insert("page_control", v.pageControl);
+    body.insert("task_cancel", false);
+    body.insert("task_start", false);
+    body.insert("task_pause", false);
+    body.insert("task_resume", false);
+    body.insert("charge_cmd", false);
+    body.insert("manual_dir", v.manualDir);
+    body.insert("manual_act", 0);
+    body.insert("manual_vy", 0);
+    body.insert("ini_x", v.iniX);
+    body.insert("ini_y", v.iniY);
+    body.insert("ini_w", v.iniW);
+    body.insert("music", 0);
+    body.insert("manual_vx", v.manualVx);
+    body.insert("manual_vth", v.manualVth);
+
+    QJsonObject frame;
+    frame["IsSucceed"] = true;
+    frame["DateTime"] = QDateTime::currentDateTime().toString("yyyy-MM-dd hh:mm:ss.zzz");
+    frame["DataStamps"] = i;
+    frame["Event"] = "TOUCH_STATE";
+    frame["Body"] = body;
+    frame["ErrorMessage"] = "";
+    return frame;
+}
+
+static void fillTouchState(FrameEncoder &enc, int i)
+{
+    using namespace ControllerFrames;
+    const TouchValues v = touchValues(i);
+    enc.setStamps(i);
+    enc.setBool(TouchPageControl, v.pageControl);
+    enc.setInt(TouchManualDir, v.manualDir);
+    enc.setInt(TouchManualVx, v.manualVx);
+    enc.setInt(TouchManualVth, v.manualVth);
+    enc.setInt(TouchIniX, v.iniX);
+    enc.setInt(TouchIniY, v.iniY);
+    enc.setInt(TouchIniW, v.iniW);
+}
+
+struct EncodeResult
+{
+    double nsPerFrame = 0;
+    double allocsPerFrame = 0;
+    quint64 allocs = 0;
+};
+
+// send(i) 完成第 i 次编码，并像发送队列一样持有结果直到本次发送结束
+template <typename Send>
+static EncodeResult runEncodeBench(int sends, Send send)
+{
+    // 预热：让缓冲区容量增长到最长帧所需
+    for (int i = 0; i < qMin(sends, 4096); ++i)
+        send(i);
+    send(sends - 1);
+
+    const quint64 allocBefore = AllocCounter::count();
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < sends; ++i)
+        send(i);
+    const qint64 ns = timer.nsecsElapsed();
+
+    EncodeResult result;
+    result.allocs = AllocCounter::count() - allocBefore;
+    result.nsPerFrame = static_cast<double>(ns) / sends;
+    result.allocsPerFrame = static_cast<double>(result.allocs) / sends;
+    return result;
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    app.setApplicationName("AgvBench");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("AGV 帧编解码微基准：DOM 解析与流式解析对比，TOUCH_STATE 发送编码的分配次数");
+    parser.addHelpOption();
+
+    QCommandLineOption framesOpt("frames", "录制的帧文件，每行一帧 JSON；不指定时使用合成帧", "file");
+    QCommandLineOption captureOpt("capture", "流量录制文件或环形录制目录，取其中数据通讯的 JSON 帧", "path");
+    QCommandLineOption countOpt("count", "合成帧数量", "n", "1000");
+    QCommandLineOption roundsOpt("rounds", "重复解码的轮数", "n", "200");
+    QCommandLineOption idleOpt("idle", "合成帧模拟车辆静止，各段落内容不变");
+    QCommandLineOption sendsOpt("sends", "TOUCH_STATE 编码次数", "n", "100000");
+    parser.addOption(framesOpt);
+    parser.addOption(captureOpt);
+    parser.addOption(countOpt);
+    parser.addOption(roundsOpt);
+    parser.addOption(idleOpt);
+    parser.addOption(sendsOpt);
+    parser.process(app);
+
+    QVector<QString> frames;
+    if (parser.isSet(captureOpt))
+        frames = loadCapture(parser.value(captureOpt));
+    else if (parser.isSet(framesOpt))
+        frames = loadFrames(parser.value(framesOpt));
+    else
+        frames = syntheticFrames(qMax(1, parser.value(countOpt).toInt()), parser.isSet(idleOpt));
+    const int rounds = qMax(1, parser.value(roundsOpt).toInt());
+    if (frames.isEmpty())
+    {
+        std::fprintf(stderr, "没有可用的帧\n");
+        return 1;
+    }
+
+    qint64 bytes = 0;
+    for (const QString &msg : frames)
+        bytes += msg.size();
+    std::printf("帧数 %d，平均 %lld 字符/帧，%d 轮\n", frames.size(), bytes / frames.size(), rounds);
+
+    const BenchResult dom = runBench(frames, rounds, [](AgvFrameDecoder &d, const QString &msg, AgvSnapshot &snap, AgvFrame &frame, QString &error)
+                                     { return d.decodeJsonDom(msg, snap, frame, error); });
+    const BenchResult stream = runBench(frames, rounds, [](AgvFrameDecoder &d, const QString &msg, AgvSnapshot &snap, AgvFrame &frame, QString &error)
+                                        { return d.decodeJson(msg, snap, frame, error); });
+
+    const char *allocNote = AllocCounter::available() ? "" : "（非 glibc 平台，未统计）";
+    std::printf("%-8s %12s %14s%s\n", "路径", "ns/帧", "分配次数/帧", allocNote);
+    std::printf("%-8s %12.0f %14.2f\n", "DOM", dom.nsPerFrame, dom.allocsPerFrame);
+    std::printf("%-8s %12.0f %14.2f\n", "流式", stream.nsPerFrame, stream.allocsPerFrame);
+
+    // 流式路径中因原文未变化而跳过的段落
+    const AgvDecodeStats &ds = stream.decodeStats;
+    std::printf("流式跳过: AGVInfo %llu/%llu，OptionalINFO %llu/%llu，AGV_TASK %llu/%llu\n",
+                ds.agvInfoSkipped, ds.agvInfoSections, ds.optionalInfoSkipped, ds.optionalInfoSections,
+                ds.agvTaskSkipped, ds.agvTaskSections);
+
+    // 两条路径必须得到相同的快照和变化位掩码
+    const bool same = sameSnapshot(dom.finalSnapshot, stream.finalSnapshot) && dom.masks == stream.masks;
+    std::printf("结果一致性: %s\n", same ? "一致" : "不一致");
+
+    // TOUCH_STATE 发送编码：QJsonObject 构建 + 序列化，与预编译模板对比
+    const int sends = qMax(1, parser.value(sendsOpt).toInt());
+    FrameEncoder touch = ControllerFrames::touchState();
+    qint64 sink = 0;
+
+    const EncodeResult oldJson = runEncodeBench(sends, [&sink](int i)
+                                                { const QString sent = QString::fromUtf8(QJsonDocument(touchStateJson(i)).toJson(QJsonDocument::Compact));
+                                                  sink += sent.size(); });
+    const EncodeResult oldCbor = runEncodeBench(sends, [&sink](int i)
+                                                { const QByteArray sent = QCborValue::fromJsonValue(touchStateJson(i)).toCbor();
+                                                  sink += sent.size(); });
+    const EncodeResult newJson = runEncodeBench(sends, [&touch, &sink](int i)
+                                                { fillTouchState(touch, i);
+                                                  const QString sent = touch.encodeJson();
+                                                  sink += sent.size(); });
+    const EncodeResult newCbor = runEncodeBench(sends, [&touch, &sink](int i)
+                                                { fillTouchState(touch, i);
+                                                  const QByteArray sent = touch.encodeCbor();
+                                                  sink += sent.size(); });
+
+    // 与 CommunicationWsClient::sendTouchState 相同的交接路径：模板编码后放入 WebsocketClient 使用的发送队列，
+    // 再像 drainSendQueue 一样取出；每批次投递 drainSendQueue 的事件与 QWebSocket 组帧不在统计范围内
+    OutboundQueue queue;
+    const EncodeResult newQueued = runEncodeBench(sends, [&touch, &queue, &sink](int i)
+                                                  { fillTouchState(touch, i);
+                                                    OutboundQueue::Frame frame;
+                                                    frame.text = touch.encodeJson();
+                                                    queue.push(frame, true);
+                                                    queue.drain([&sink](const OutboundQueue::Frame &sent)
+                                                                { sink += sent.text.size(); }); });
+
+    std::printf("\nTOUCH_STATE 编码 %d 次（校验和 %lld）\n", sends, sink);
+    std::printf("%-18s %12s %14s%s\n", "路径", "ns/帧", "分配次数/帧", allocNote);
+    std::printf("%-18s %12.0f %14.2f\n", "QJsonObject", oldJson.nsPerFrame, oldJson.allocsPerFrame);
+    std::printf("%-18s %12.0f %14.2f\n", "QJsonObject+CBOR", oldCbor.nsPerFrame, oldCbor.allocsPerFrame);
+    std::printf("%-18s %12.0f %14.2f\n", "模板 JSON", newJson.nsPerFrame, newJson.allocsPerFrame);
+    std::printf("%-18s %12.0f %14.2f\n", "模板 CBOR", newCbor.nsPerFrame, newCbor.allocsPerFrame);
+    std::printf("%-18s %12.0f %14.2f\n", "模板 JSON+发送队列", newQueued.nsPerFrame, newQueued.allocsPerFrame);
+
+    // 稳态下编码与发送队列交接不允许有任何堆分配（不含投递 drainSendQueue 的事件与 socket 写入）
+    const bool allocFree = !AllocCounter::available() || (newJson.allocs == 0 && newCbor.allocs == 0 && newQueued.allocs == 0);
+    std::printf("编码与入队零分配: %s\n", AllocCounter::available() ? (allocFree ? "是" : "否") : "未统计");
+
+    if (!same)
+        return 2;
+    return allocFree ? 0 : 3;
+}
@@ -0,0 +1,334 @@
+#include "SimControllerServer.h"
+#include "SimTrajectory.h"
+#include <QJsonDocument>
+#include <QJsonArray>
+#include <QCborValue>
+#include <QDateTime>
+#include <QTextStream>
+#include <QtMath>
+
+// 生成 { "value": v, "color": c } 结构
+static QJsonObject attr(const QJsonValue &value, const QString &color = QStringLiteral("#000000"))
+{
+    QJsonObject obj;
+    obj.insert("value", value);
+    obj.insert("color", color);
+    return obj;
+}
+
+SimControllerServer::SimControllerServer(const Options &opt, SimTrajectory *trajectory, QObject *parent)
+    : QObject(parent), m_opt(opt), m_trajectory(trajectory)
+{
+    m_server = new QWebSocketServer(QStringLiteral("AgvSimulator"), QWebSocketServer::NonSecureMode, this);
+    connect(m_server, &QWebSocketServer::newConnection, this, &SimControllerServer::onNewConnection);
+
+    m_tickTimer = new QTimer(this);
+    m_tickTimer->setInterval(m_opt.tickMs);
+    connect(m_tickTimer, &QTimer::timeout, this, &SimControllerServer::onTick);
+
+    // 每 5 秒打印一次流量统计
+    m_reportTimer = new QTimer(this);
+    m_reportTimer->setInterval(5000);
+    connect(m_reportTimer, &QTimer::timeout, this, &SimControllerServer::onReport);
+}
+
+SimControllerServer::~SimControllerServer()
+{
+    m_server->close();
+    qDeleteAll(m_clients.keys());
+}
+
+bool SimControllerServer::start()
+{
+    if (!m_server->listen(QHostAddress::Any, m_opt.port))
+    {
+        QTextStream(stderr) << "Controller: listen on " << m_opt.port << " failed: " << m_server->errorString() << "\n";
+        return false;
+    }
+    QTextStream(stdout) << "Controller: listening on ws://0.0.0.0:" << m_opt.port
+                        << (m_opt.supportSubscribe ? " (SUBSCRIBE supported)" : " (SUBSCRIBE ignored)")
+                        << (m_opt.supportCbor ? " (CBOR supported)" : " (JSON only)")
+                        << (m_opt.idle ? " idle" : "") << "\n";
+    m_tickTimer->start();
+    m_reportTimer->start();
+    return true;
+}
+
+void SimControllerServer::onNewConnection()
+{
+    while (QWebSocket *client = m_server->nextPendingConnection())
+    {
+        connect(client, &QWebSocket::textMessageReceived, this, &SimControllerServer::onTextMessage);
+        connect(client, &QWebSocket::binaryMessageReceived, this, &SimControllerServer::onBinaryMessage);
+        connect(client, &QWebSocket::disconnected, this, &SimControllerServer::onClientDisconnected);
+        m_clients.insert(client, Subscription());
+        QTextStream(stdout) << "Controller: client connected " << client->peerAddress().toString() << "\n";
+    }
+}
+
+void SimControllerServer::onClientDisconnected()
+{
+    QWebSocket *client = qobject_cast<QWebSocket *>(sender());
+    if (!client)
+        return;
+    m_clients.remove(client);
+    m_cborClients.remove(client);
+    client->deleteLater();
+    QTextStream(stdout) << "Controller: client disconnected\n";
+}
+
+void SimControllerServer::onTextMessage(const QString &msg)
+{
+    QWebSocket *client = qobject_cast<QWebSocket *>(sender());
+    if (!client)
+        return;
+
+    const QByteArray data = msg.toUtf8();
+    m_msgIn++;
+    m_bytesIn += static_cast<quint64>(data.size());
+
+    handleFrame(client, QJsonDocument::fromJson(data).object());
+}
+
+void SimControllerServer::onBinaryMessage(const QByteArray &data)
+{
+    QWebSocket *client = qobject_cast<QWebSocket *>(sender());
+    if (!client)
+        return;
+
+    m_msgIn++;
+    m_bytesIn += static_cast<quint64>(data.size());
+
+    handleFrame(client, QCborValue::fromCbor(data).toMap().toJsonObject());
+}
+
+void SimControllerServer::handleFrame(QWebSocket *client, const QJsonObject &root)
+{
+    QString event = root.value("Event").toString();
+    qint64 stamps = root.value("DataStamps").toVariant().toLongLong();
+
+    if (event == "REQUEST_AGV_STATE" || event == "REQUEST_AGV_TASK")
+    {
+        replyRequest(client, event, stamps);
+    }
+    else if (event == "SUBSCRIBE")
+    {
+        handleSubscribe(client, root);
+    }
+    else if (event == "SET_ENCODING")
+    {
+        handleSetEncoding(client, root);
+    }
+    // TOUCH_STATE 等其他事件只计入统计
+}
+
+void SimControllerServer::replyRequest(QWebSocket *client, const QString &event, qint64 stamps)
+{
+    auto reply = [this, client, event, stamps]()
+    {
+        if (event == "REQUEST_AGV_STATE")
+            sendFrame(client, makeFrame("AGV_STATE", agvStateBody(), stamps));
+        else
+            sendFrame(client, makeFrame("AGV_TASK", agvTaskBody(), stamps));
+    };
+
+    // 模拟控制器处理耗时，用于验证客户端的往返时延统计
+    if (m_opt.replyDelayMs > 0)
+        QTimer::singleShot(m_opt.replyDelayMs, client, reply);
+    else
+        reply();
+}
+
+void SimControllerServer::handleSubscribe(QWebSocket *client, const QJsonObject &root)
+{
+    // 模拟旧控制器：不认识 SUBSCRIBE，直接忽略，由客户端超时回退
+    if (!m_opt.supportSubscribe)
+        return;
+
+    QJsonObject body = root.value("Body").toObject();
+    Subscription &sub = m_clients[client];
+    sub.active = true;
+    sub.rateMs = qMax(0, body.value("RateMs").toInt());
+
+    delete sub.timer;
+    sub.timer = nullptr;
+    if (sub.rateMs > 0)
+    {
+        sub.timer = new QTimer(client);
+        sub.timer->setInterval(sub.rateMs);
+        connect(sub.timer, &QTimer::timeout, this, [this, client]()
+                { pushState(client); });
+        sub.timer->start();
+    }
+
+    QJsonObject ackBody;
+    ackBody.insert("Events", body.value("Events"));
+    ackBody.insert("RateMs", sub.rateMs);
+    sendFrame(client, makeFrame("SUBSCRIBE_ACK", ackBody, root.value("DataStamps").toVariant().toLongLong()));
+
+    // 订阅后立即推送一次完整状态
+    pushState(client);
+
+    QTextStream(stdout) << "Controller: client subscribed, rate " << sub.rateMs << " ms\n";
+}
+
+void SimControllerServer::handleSetEncoding(QWebSocket *client, const QJsonObject &root)
+{
+    QString encoding = root.value("Body").toObject().value("Encoding").toString().toUpper();
+    bool accepted = m_opt.supportCbor && (encoding == "CBOR" || encoding == "JSON");
+
+    QJsonObject ackBody;
+    ackBody.insert("Encoding", accepted ? encoding : QStringLiteral("JSON"));
+
+    // 应答仍按切换前的编码发出，之后的帧使用新编码
+    sendFrame(client, makeFrame("SET_ENCODING_ACK", ackBody, root.value("DataStamps").toVariant().toLongLong(), accepted));
+    if (accepted && encoding == "CBOR")
+        m_cborClients.insert(client);
+    else
+        m_cborClients.remove(client);
+
+    QTextStream(stdout) << "Controller: client encoding " << (m_cborClients.contains(client) ? "CBOR" : "JSON") << "\n";
+}
+
+void SimControllerServer::onTick()
+{
+    if (m_opt.idle)
+        return;
+
+    // 位姿取自共用轨迹，与 rosbridge 模拟端的 /agv_state 和点云保持一致
+    m_tick++;
+    const SimTrajectory::Pose pose = m_trajectory->now();
+    m_slamX = qRound(pose.x * 1000.0);
+    m_slamY = qRound(pose.y * 1000.0);
+    m_slamAngle = (qRound(qRadiansToDegrees(pose.theta) * 100.0) + 36000) % 36000;
+    if (m_tick % 200 == 0)
+        m_battery = m_battery > 20 ? m_battery - 1 : 90;
+
+    // ON_CHANGE 订阅者：状态变化即推送
+    for (auto it = m_clients.begin(); it != m_clients.end(); ++it)
+    {
+        if (it.value().active && it.value().rateMs == 0)
+            pushState(it.key());
+    }
+}
+
+void SimControllerServer::onReport()
+{
+    const double sec = m_reportTimer->interval() / 1000.0;
+    QTextStream(stdout) << QStringLiteral("Controller: in %1 msg/s %2 B/s, out %3 msg/s %4 B/s, clients %5\n")
+                               .arg(m_msgIn / sec, 0, 'f', 1)
+                               .arg(m_bytesIn / sec, 0, 'f', 0)
+                               .arg(m_msgOut / sec, 0, 'f', 1)
+                               .arg(m_bytesOut / sec, 0, 'f', 0)
+                               .arg(m_clients.size());
+    m_msgIn = m_msgOut = m_bytesIn = m_bytesOut = 0;
+}
+
+void SimControllerServer::pushState(QWebSocket *client)
+{
+    m_pushStamps++;
+    sendFrame(client, makeFrame("AGV_STATE", agvStateBody(), static_cast<qint64>(m_pushStamps)));
+    sendFrame(client, makeFrame("AGV_TASK", agvTaskBody(), static_cast<qint64>(m_pushStamps)));
+}
+
+void SimControllerServer::sendFrame(QWebSocket *client, const QJsonObject &frame)
+{
+    m_msgOut++;
+    if (m_cborClients.contains(client))
+    {
+        QByteArray data = QCborValue::fromJsonValue(frame).toCbor();
+        m_bytesOut += static_cast<quint64>(data.size());
+        client->sendBinaryMessage(data);
+        return;
+    }
+
+    QByteArray data = QJsonDocument(frame).toJson(QJsonDocument::Compact);
+    m_bytesOut += static_cast<quint64>(data.size());
+    client->sendTextMessage(QString::fromUtf8(data));
+}
+
+QJsonObject SimControllerServer::makeFrame(const QString &event, const QJsonValue &body, qint64 dataStamps, bool isSucceed) const
+{
+    QJsonObject frame;
+    frame.insert("IsSucceed", isSucceed);
+    frame.insert("DateTime", QDateTime::currentDateTime().toString("yyyy-MM-dd hh:mm:ss.zzz"));
+    frame.insert("DataStamps", dataStamps);
+    frame.insert("Event", event);
+    frame.insert("Body", body);
+    frame.insert("ErrorMessage", "");
+    return frame;
+}
+
+QJsonObject SimControllerServer::agvStateBody() const
+{
+    QJsonObject info;
+    info.insert("AGV_Err_Msg", attr(QJsonValue::Null));
+    info.insert("Xin1", attr(0x0f, "#00FF00"));
+    info.insert("Xin2", attr(0x00));
+    info.insert("Xin3", attr(0x00));
+    info.insert("Yout1", attr(0x01, "#00FF00"));
+    info.insert("Yout2", attr(0x00));
+    info.insert("Yout3", attr(0x00));
+    info.insert("agv_id", attr(1));
+    info.insert("agv_name", attr("SIM-AGV"));
+    info.insert("battery", attr(m_battery, m_battery > 30 ? "#00FF00" : "#FF0000"));
+    info.insert("map_id", attr(1));
+    info.insert("slam_x", attr(m_slamX));
+    info.insert("slam_y", attr(m_slamY));
+    info.insert("slam_angle", attr(m_slamAngle));
+    info.insert("slam_cov", attr(12));
+    info.insert("v_x", attr(m_opt.idle ? 0 : 1570));
+    info.insert("v_y", attr(0));
+    info.insert("v_angle", attr(m_opt.idle ? 0 : 1800));
+    info.insert("agv_mode", attr(1));
+    info.insert("agv_state", attr(m_opt.idle ? 0 : 1));
+    info.insert("light", attr(2));
+    info.insert("front_area", attr(0));
+    info.insert("front_left", attr(0));
+    info.insert("front_right", attr(0));
+    info.insert("back_area", attr(0));
+    info.insert("back_left", attr(0));
+    info.insert("back_right", attr(0));
+    info.insert("bump_back", attr(0));
+    info.insert("bump_front", attr(0));
+    info.insert("bump_left", attr(0));
+    info.insert("bump_right", attr(0));
+    info.insert("estop_state", attr(0));
+    info.insert("goods_state", attr(0));
+    info.insert("move_dir", attr(m_opt.idle ? 0 : 1));
+    info.insert("point_id", attr(static_cast<int>(m_tick / 40 % 100)));
+    info.insert("task_act", attr(0));
+    info.insert("task_param", attr(0));
+    info.insert("task_description", attr("simulated circle"));
+    info.insert("run_length", attr(static_cast<int>(m_tick * m_opt.tickMs / 1000)));
+    info.insert("run_time", attr(static_cast<int>(m_tick * m_opt.tickMs / 1000)));
+
+    QJsonObject optional;
+    optional.insert("lift_height", attr(0));
+
+    QJsonObject body;
+    body.insert("AGVInfo", info);
+    body.insert("OptionalINFO", optional);
+    return body;
+}
+
+QJsonObject SimControllerServer::agvTaskBody() const
+{
+    QJsonObject body;
+    body.insert("task_state", attr(1));
+    body.insert("task_id", attr("SIM-TASK-1"));
+    body.insert("task_start_id", attr(1));
+    body.insert("task_start_x", attr(5000));
+    body.insert("task_start_y", attr(0));
+    body.insert("task_end_id", attr(2));
+    body.insert("task_end_x", attr(-5000));
+    body.insert("task_end_y", attr(0));
+    body.insert("path_start_id", attr(1));
+    body.insert("path_start_x", attr(5000));
+    body.insert("path_start_y", attr(0));
+    body.insert("path_end_id", attr(2));
+    body.insert("path_end_x", attr(-5000));
+    body.insert("path_end_y", attr(0));
+    body.insert("TASK_Err_Msg", attr(QJsonValue::Null));
+    return body;
+}
@@ -0,0 +1,87 @@
+#ifndef SIMCONTROLLERSERVER_H
+#define SIMCONTROLLERSERVER_H
+
+#include <QObject>
+#include <QWebSocketServer>
+#include <QWebSocket>
+#include <QJsonObject>
+#include <QHash>
+#include <QSet>
+#include <QTimer>
+
+class SimTrajectory;
+
+// 模拟 AGV 控制器（数据通讯端口，Event/Body JSON）
+// 支持 REQUEST_AGV_STATE / REQUEST_AGV_TASK 轮询应答，SUBSCRIBE 订阅推送，以及 SET_ENCODING 切换 CBOR 二进制帧
+class SimControllerServer : public QObject
+{
+    Q_OBJECT
+public:
+    struct Options
+    {
+        quint16 port = 9001;           // 监听端口
+        bool supportSubscribe = true;  // false 时忽略 SUBSCRIBE，模拟不支持订阅的旧控制器
+        bool supportCbor = true;       // false 时拒绝 SET_ENCODING，始终使用 JSON
+        bool idle = false;             // true 时车辆静止，状态不再变化
+        int tickMs = 50;               // 模拟状态的更新周期
+        int replyDelayMs = 0;          // 轮询应答的延迟，模拟控制器处理耗时
+    };
+
+    // trajectory 与 rosbridge 模拟端共用，由调用方持有
+    SimControllerServer(const Options &opt, SimTrajectory *trajectory, QObject *parent = nullptr);
+    ~SimControllerServer();
+
+    bool start();
+
+private slots:
+    void onNewConnection();
+    void onTextMessage(const QString &msg);
+    void onBinaryMessage(const QByteArray &data);
+    void onClientDisconnected();
+    void onTick();
+    void onReport();
+
+private:
+    // 每个客户端的订阅状态
+    struct Subscription
+    {
+        bool active = false;
+        int rateMs = 0;           // 0 表示变化即推送
+        QTimer *timer = nullptr;  // RATE 模式的推送定时器
+    };
+
+    Options m_opt;
+    SimTrajectory *m_trajectory;
+    QWebSocketServer *m_server;
+    QHash<QWebSocket *, Subscription> m_clients;
+    QSet<QWebSocket *> m_cborClients; // 已协商为 CBOR 二进制帧的客户端
+
+    QTimer *m_tickTimer;
+    QTimer *m_reportTimer;
+
+    // 模拟状态
+    quint64 m_tick = 0;
+    quint64 m_pushStamps = 0;
+    int m_slamX = 0;
+    int m_slamY = 0;
+    int m_slamAngle = 0;
+    int m_battery = 90;
+
+    // 流量统计（统计周期内累计）
+    quint64 m_msgIn = 0;
+    quint64 m_msgOut = 0;
+    quint64 m_bytesIn = 0;
+    quint64 m_bytesOut = 0;
+
+    QJsonObject makeFrame(const QString &event, const QJsonValue &body, qint64 dataStamps, bool isSucceed = true) const;
+    QJsonObject agvStateBody() const;
+    QJsonObject agvTaskBody() const;
+    void sendFrame(QWebSocket *client, const QJsonObject &frame);
+    void pushState(QWebSocket *client);
+    void handleFrame(QWebSocket *client, const QJsonObject &root);
+    void replyRequest(QWebSocket *client, const QString &event, qint64 stamps);
+    void handleSubscribe(QWebSocket *client, const QJsonObject &root);
+    void handleSetEncoding(QWebSocket *client, const QJsonObject &root);
+};
+
+#endif // SIMCONTROLLERSERVER_H
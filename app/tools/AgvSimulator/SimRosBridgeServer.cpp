@@ -0,0 +1,335 @@
+#include "SimRosBridgeServer.h"
+#include "SimTrajectory.h"
+#include <QCborStreamWriter>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTextStream>
+#include <QtMath>
+#include <chrono>
+#include <limits>
+
+// 模拟场地：以原点为中心的 20 m x 12 m 矩形房间
+static constexpr float ROOM_HALF_W = 10.0f;
+static constexpr float ROOM_HALF_H = 6.0f;
+// rosbridge 对 float32[] / int32[] 使用 RFC 8746 小端类型数组标签
+static constexpr quint64 TAG_FLOAT32_LE = 85;
+static constexpr quint64 TAG_INT32_LE = 78;
+
+// 发出时刻（墙钟 µs），上位机与模拟器在同一主机时可直接相减
+static qint64 wallClockUs()
+{
+    using namespace std::chrono;
+    return duration_cast<microseconds>(system_clock::now().time_since_epoch()).count();
+}
+
+SimRosBridgeServer::SimRosBridgeServer(const Options &opt, SimTrajectory *trajectory, QObject *parent)
+    : QObject(parent), m_opt(opt), m_trajectory(trajectory)
+{
+    m_server = new QWebSocketServer(QStringLiteral("AgvSimulator-RosBridge"), QWebSocketServer::NonSecureMode, this);
+    connect(m_server, &QWebSocketServer::newConnection, this, &SimRosBridgeServer::onNewConnection);
+
+    m_scan.topic = QStringLiteral("/laser_points");
+    m_scan.periodNs = static_cast<qint64>(1e9 / qMax(0.1, m_opt.scanHz));
+    m_state.topic = QStringLiteral("/agv_state");
+    m_state.periodNs = static_cast<qint64>(1e9 / qMax(0.1, m_opt.stateHz));
+
+    // 40 Hz 时周期只有 25 ms，默认的 CoarseTimer 误差可达 5%，改用 PreciseTimer
+    for (Channel *ch : {&m_scan, &m_state})
+    {
+        ch->timer = new QTimer(this);
+        ch->timer->setSingleShot(true);
+        ch->timer->setTimerType(Qt::PreciseTimer);
+        connect(ch->timer, &QTimer::timeout, this, [this, ch]()
+                { fire(*ch); });
+    }
+
+    m_mapNameTimer = new QTimer(this);
+    m_mapNameTimer->setInterval(1000);
+    connect(m_mapNameTimer, &QTimer::timeout, this, [this]()
+            { publishMapName(); });
+
+    m_reportTimer = new QTimer(this);
+    m_reportTimer->setInterval(5000);
+    connect(m_reportTimer, &QTimer::timeout, this, &SimRosBridgeServer::onReport);
+
+    // 射线在车体坐标系下均匀覆盖 360°
+    const int n = qMax(1, m_opt.scanPoints);
+    m_rayCos.resize(n);
+    m_raySin.resize(n);
+    for (int i = 0; i < n; ++i)
+    {
+        const double a = 2.0 * M_PI * i / n;
+        m_rayCos[i] = static_cast<float>(qCos(a));
+        m_raySin[i] = static_cast<float>(qSin(a));
+    }
+    m_scanBuf.resize(n * 3 * static_cast<int>(sizeof(float)));
+    m_frameBuf.reserve(m_scanBuf.size() + 128);
+}
+
+SimRosBridgeServer::~SimRosBridgeServer()
+{
+    m_server->close();
+    qDeleteAll(m_clients.keys());
+}
+
+bool SimRosBridgeServer::start()
+{
+    if (!m_server->listen(QHostAddress::Any, m_opt.port))
+    {
+        QTextStream(stderr) << "RosBridge: listen on " << m_opt.port << " failed: " << m_server->errorString() << "\n";
+        return false;
+    }
+    QTextStream(stdout) << QStringLiteral("RosBridge: listening on ws://0.0.0.0:%1, scan %2 pts @ %3 Hz, state @ %4 Hz, jitter %5 ms\n")
+                               .arg(m_opt.port)
+                               .arg(m_opt.scanPoints)
+                               .arg(m_opt.scanHz)
+                               .arg(m_opt.stateHz)
+                               .arg(m_opt.jitterMs);
+
+    m_clock.start();
+    schedule(m_scan);
+    schedule(m_state);
+    m_mapNameTimer->start();
+    m_reportTimer->start();
+    return true;
+}
+
+void SimRosBridgeServer::onNewConnection()
+{
+    while (QWebSocket *client = m_server->nextPendingConnection())
+    {
+        connect(client, &QWebSocket::textMessageReceived, this, &SimRosBridgeServer::onTextMessage);
+        connect(client, &QWebSocket::disconnected, this, &SimRosBridgeServer::onClientDisconnected);
+        m_clients.insert(client, QHash<QString, Subscription>());
+        QTextStream(stdout) << "RosBridge: client connected " << client->peerAddress().toString() << "\n";
+    }
+}
+
+void SimRosBridgeServer::onClientDisconnected()
+{
+    QWebSocket *client = qobject_cast<QWebSocket *>(sender());
+    if (!client)
+        return;
+    m_clients.remove(client);
+    client->deleteLater();
+    QTextStream(stdout) << "RosBridge: client disconnected\n";
+}
+
+void SimRosBridgeServer::onTextMessage(const QString &msg)
+{
+    QWebSocket *client = qobject_cast<QWebSocket *>(sender());
+    if (!client)
+        return;
+    m_msgIn++;
+
+    const QJsonObject root = QJsonDocument::fromJson(msg.toUtf8()).object();
+    const QString op = root.value("op").toString();
+    const QString topic = root.value("topic").toString();
+
+    if (op == "subscribe")
+    {
+        Subscription sub;
+        sub.throttleMs = qMax(0, root.value("throttle_rate").toInt());
+        m_clients[client].insert(topic, sub);
+        QTextStream(stdout) << "RosBridge: client subscribed " << topic << " throttle " << sub.throttleMs << " ms\n";
+        if (topic == "/map_name")
+            publishMapName(client);
+    }
+    else if (op == "unsubscribe")
+    {
+        m_clients[client].remove(topic);
+    }
+    else if (op == "publish" && topic == "/baseinipose")
+    {
+        // 重定位：轨迹整体平移到指定位置，控制器端的 slam_x / slam_y 随之变化
+        const QJsonObject position = root.value("msg").toObject().value("pose").toObject().value("pose").toObject().value("position").toObject();
+        const double x = position.value("x").toDouble();
+        const double y = position.value("y").toDouble();
+        m_trajectory->relocate(x, y);
+        QTextStream(stdout) << "RosBridge: relocated to (" << x << ", " << y << ")\n";
+    }
+}
+
+void SimRosBridgeServer::schedule(Channel &ch)
+{
+    const qint64 now = m_clock.nsecsElapsed();
+    if (ch.nextNs == 0)
+        ch.nextNs = now + ch.periodNs;
+
+    qint64 jitterNs = 0;
+    if (m_opt.jitterMs > 0)
+        jitterNs = std::uniform_int_distribution<qint64>(0, m_opt.jitterMs * 1000000LL)(m_rng);
+
+    ch.targetNs = ch.nextNs + jitterNs;
+    ch.timer->start(static_cast<int>(qMax<qint64>(0, (ch.targetNs - now) / 1000000)));
+}
+
+void SimRosBridgeServer::fire(Channel &ch)
+{
+    const qint64 now = m_clock.nsecsElapsed();
+    m_maxLateNs = qMax(m_maxLateNs, now - ch.targetNs);
+
+    if (&ch == &m_scan)
+        publishScan();
+    else
+        publishState();
+
+    // 名义节拍按周期推进；发布耗时超过一个周期时丢弃落后的节拍，而不是连续补发
+    ch.nextNs += ch.periodNs;
+    if (ch.nextNs < now)
+        ch.nextNs = now + ch.periodNs;
+    schedule(ch);
+}
+
+void SimRosBridgeServer::buildScan()
+{
+    const SimTrajectory::Pose pose = m_trajectory->now();
+    const float px = static_cast<float>(pose.x);
+    const float py = static_cast<float>(pose.y);
+    const float ct = static_cast<float>(qCos(pose.theta));
+    const float st = static_cast<float>(qSin(pose.theta));
+    std::normal_distribution<float> noise(0.0f, 0.01f); // 1 cm 测距噪声
+
+    float *out = reinterpret_cast<float *>(m_scanBuf.data());
+    const int n = m_rayCos.size();
+    for (int i = 0; i < n; ++i)
+    {
+        // 射线方向旋转到世界坐标系
+        const float c = ct * m_rayCos[i] - st * m_raySin[i];
+        const float s = st * m_rayCos[i] + ct * m_raySin[i];
+
+        // 与房间四壁求交，取最近的一面
+        float t = std::numeric_limits<float>::max();
+        if (c > 1e-6f)
+            t = qMin(t, (ROOM_HALF_W - px) / c);
+        else if (c < -1e-6f)
+            t = qMin(t, (-ROOM_HALF_W - px) / c);
+        if (s > 1e-6f)
+            t = qMin(t, (ROOM_HALF_H - py) / s);
+        else if (s < -1e-6f)
+            t = qMin(t, (-ROOM_HALF_H - py) / s);
+        t = qMax(0.0f, t + noise(m_rng));
+
+        *out++ = px + t * c;
+        *out++ = py + t * s;
+        *out++ = 0.0f;
+    }
+}
+
+void SimRosBridgeServer::publishScan()
+{
+    // 无人订阅时不生成点云，只保持节拍
+    bool subscribed = false;
+    for (const QHash<QString, Subscription> &topics : qAsConst(m_clients))
+        subscribed = subscribed || topics.contains(m_scan.topic);
+    if (!subscribed)
+        return;
+
+    buildScan();
+
+    // {"op": "publish", "topic": "/laser_points", "msg": {"data": tag85(bytes), "sim_stamp_us": us}}
+    m_frameBuf.resize(0);
+    QCborStreamWriter w(&m_frameBuf);
+    w.startMap(3);
+    w.append(QLatin1String("op"));
+    w.append(QLatin1String("publish"));
+    w.append(QLatin1String("topic"));
+    w.append(QLatin1String("/laser_points"));
+    w.append(QLatin1String("msg"));
+    w.startMap(2);
+    w.append(QLatin1String("data"));
+    w.append(QCborTag(TAG_FLOAT32_LE));
+    w.append(m_scanBuf);
+    // 时间戳放在最后写入，尽量贴近实际发出时刻
+    w.append(QLatin1String("sim_stamp_us"));
+    w.append(wallClockUs());
+    w.endMap();
+    w.endMap();
+
+    m_scanOut += broadcast(m_scan.topic, m_frameBuf);
+}
+
+void SimRosBridgeServer::publishState()
+{
+    const SimTrajectory::Pose pose = m_trajectory->now();
+    // [map_id, x(mm), y(mm), angle(mrad)]，与 MonitorWidget 读取的下标一致
+    const qint32 state[4] = {1, qRound(pose.x * 1000.0), qRound(pose.y * 1000.0), qRound(pose.theta * 1000.0)};
+    QByteArray data(reinterpret_cast<const char *>(state), sizeof(state));
+
+    m_frameBuf.resize(0);
+    QCborStreamWriter w(&m_frameBuf);
+    w.startMap(3);
+    w.append(QLatin1String("op"));
+    w.append(QLatin1String("publish"));
+    w.append(QLatin1String("topic"));
+    w.append(QLatin1String("/agv_state"));
+    w.append(QLatin1String("msg"));
+    w.startMap(1);
+    w.append(QLatin1String("data"));
+    w.append(QCborTag(TAG_INT32_LE));
+    w.append(data);
+    w.endMap();
+    w.endMap();
+
+    m_stateOut += broadcast(m_state.topic, m_frameBuf);
+}
+
+void SimRosBridgeServer::publishMapName(QWebSocket *only)
+{
+    QByteArray frame;
+    QCborStreamWriter w(&frame);
+    w.startMap(3);
+    w.append(QLatin1String("op"));
+    w.append(QLatin1String("publish"));
+    w.append(QLatin1String("topic"));
+    w.append(QLatin1String("/map_name"));
+    w.append(QLatin1String("msg"));
+    w.startMap(1);
+    w.append(QLatin1String("data"));
+    w.append(m_opt.mapName);
+    w.endMap();
+    w.endMap();
+
+    if (only)
+    {
+        m_bytesOut += static_cast<quint64>(frame.size());
+        only->sendBinaryMessage(frame);
+        return;
+    }
+    broadcast(QStringLiteral("/map_name"), frame);
+}
+
+int SimRosBridgeServer::broadcast(const QString &topic, const QByteArray &frame)
+{
+    int sent = 0;
+    const qint64 nowNs = m_clock.nsecsElapsed();
+    for (auto it = m_clients.begin(); it != m_clients.end(); ++it)
+    {
+        auto sub = it.value().find(topic);
+        if (sub == it.value().end())
+            continue;
+        // 节流：间隔不足时丢弃本帧（queue_length 按 1 处理，只发最新帧）
+        if (sub->throttleMs > 0 && sub->lastSentNs >= 0 && nowNs - sub->lastSentNs < sub->throttleMs * 1000000ll)
+            continue;
+        sub->lastSentNs = nowNs;
+        it.key()->sendBinaryMessage(frame);
+        m_bytesOut += static_cast<quint64>(frame.size());
+        ++sent;
+    }
+    return sent;
+}
+
+void SimRosBridgeServer::onReport()
+{
+    const double sec = m_reportTimer->interval() / 1000.0;
+    QTextStream(stdout) << QStringLiteral("RosBridge: in %1 msg/s, scan %2 msg/s (%3 pts), state %4 msg/s, out %5 MB/s, max late %6 ms, clients %7\n")
+                               .arg(m_msgIn / sec, 0, 'f', 1)
+                               .arg(m_scanOut / sec, 0, 'f', 1)
+                               .arg(m_rayCos.size())
+                               .arg(m_stateOut / sec, 0, 'f', 1)
+                               .arg(m_bytesOut / sec / 1e6, 0, 'f', 2)
+                               .arg(m_maxLateNs / 1e6, 0, 'f', 1)
+                               .arg(m_clients.size());
+    m_msgIn = m_scanOut = m_stateOut = m_bytesOut = 0;
+    m_maxLateNs = 0;
+}
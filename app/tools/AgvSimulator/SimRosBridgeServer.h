@@ -0,0 +1,96 @@
+#ifndef SIMROSBRIDGESERVER_H
+#define SIMROSBRIDGESERVER_H
+
+#include <QObject>
+#include <QWebSocketServer>
+#include <QWebSocket>
+#include <QHash>
+#include <QTimer>
+#include <QVector>
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <random>
+
+class SimTrajectory;
+
+// 模拟 rosbridge（CBOR publish）
+// 按 subscribe 的话题推送 /laser_points（float32 xyz 点云）、/agv_state（int32 数组）与 /map_name，
+// 点云由车辆位姿向矩形房间做射线求交生成；每帧附带 sim_stamp_us 发出时刻，供上位机统计端到端时延
+class SimRosBridgeServer : public QObject
+{
+    Q_OBJECT
+public:
+    struct Options
+    {
+        quint16 port = 9090;           // 监听端口
+        int scanPoints = 2000;         // 每帧点云的点数
+        double scanHz = 10.0;          // 点云发布频率
+        double stateHz = 20.0;         // /agv_state 发布频率
+        int jitterMs = 0;              // 每次发布叠加 [0, jitterMs] 的随机延迟，模拟网络与 ROS 调度抖动
+        QString mapName = QStringLiteral("sim_map");
+    };
+
+    // trajectory 与控制器模拟端共用，由调用方持有
+    SimRosBridgeServer(const Options &opt, SimTrajectory *trajectory, QObject *parent = nullptr);
+    ~SimRosBridgeServer();
+
+    bool start();
+
+private slots:
+    void onNewConnection();
+    void onTextMessage(const QString &msg);
+    void onClientDisconnected();
+    void onReport();
+
+private:
+    // 按固定节拍调度的发布通道：节拍不受抖动累积影响，抖动只作用于单次发出时刻
+    struct Channel
+    {
+        QString topic;
+        qint64 periodNs = 0;
+        qint64 nextNs = 0;     // 下一次名义发布时刻（相对 m_clock）
+        qint64 targetNs = 0;   // 本次定时器应触发的时刻（名义时刻 + 抖动）
+        QTimer *timer = nullptr;
+    };
+
+    Options m_opt;
+    SimTrajectory *m_trajectory;
+    QWebSocketServer *m_server;
+    // 订阅参数：throttle_rate 为两次发送的最小间隔（ms），0 表示不节流
+    struct Subscription
+    {
+        int throttleMs = 0;
+        qint64 lastSentNs = -1;
+    };
+    QHash<QWebSocket *, QHash<QString, Subscription>> m_clients; // 客户端 -> 已订阅话题
+
+    QElapsedTimer m_clock;
+    Channel m_scan;
+    Channel m_state;
+    QTimer *m_mapNameTimer;
+    QTimer *m_reportTimer;
+    std::mt19937 m_rng{20261017};
+
+    // 预先计算的扫描射线方向（车体坐标系）
+    QVector<float> m_rayCos;
+    QVector<float> m_raySin;
+    QByteArray m_scanBuf; // 复用的点云与帧缓冲，避免每帧重新分配
+    QByteArray m_frameBuf;
+
+    // 统计（统计周期内累计）
+    quint64 m_msgIn = 0;
+    quint64 m_scanOut = 0;
+    quint64 m_stateOut = 0;
+    quint64 m_bytesOut = 0;
+    qint64 m_maxLateNs = 0; // 定时器实际触发相对名义时刻（含抖动）的最大滞后
+
+    void schedule(Channel &ch);
+    void fire(Channel &ch);
+    void publishScan();
+    void publishState();
+    void publishMapName(QWebSocket *only = nullptr);
+    void buildScan();
+    int broadcast(const QString &topic, const QByteArray &frame);
+};
+
+#endif // SIMROSBRIDGESERVER_H
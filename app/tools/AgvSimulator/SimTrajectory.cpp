@@ -0,0 +1,68 @@
+#include "SimTrajectory.h"
+#include <QtMath>
+
+SimTrajectory::SimTrajectory(Shape shape, double radiusM, double periodS)
+    : m_shape(shape), m_radius(radiusM), m_period(qMax(0.1, periodS))
+{
+    m_clock.start();
+}
+
+bool SimTrajectory::parseShape(const QString &name, Shape &shape)
+{
+    const QString lower = name.toLower();
+    if (lower == QLatin1String("static"))
+        shape = Shape::Static;
+    else if (lower == QLatin1String("circle"))
+        shape = Shape::Circle;
+    else if (lower == QLatin1String("line"))
+        shape = Shape::Line;
+    else
+        return false;
+    return true;
+}
+
+SimTrajectory::Pose SimTrajectory::now() const
+{
+    return at(m_clock.nsecsElapsed() / 1e9);
+}
+
+SimTrajectory::Pose SimTrajectory::at(double seconds) const
+{
+    Pose pose;
+    const double phase = seconds / m_period; // 已完成的周期数
+    switch (m_shape)
+    {
+    case Shape::Static:
+        break;
+    case Shape::Circle:
+    {
+        // 逆时针，车头沿切线方向
+        const double a = phase * 2.0 * M_PI;
+        pose.x = m_radius * qCos(a);
+        pose.y = m_radius * qSin(a);
+        pose.theta = a + M_PI / 2.0;
+        break;
+    }
+    case Shape::Line:
+    {
+        // 一个周期内从 -R 走到 R 再返回
+        const double f = phase - qFloor(phase);
+        const bool forward = f < 0.5;
+        pose.x = forward ? m_radius * (4.0 * f - 1.0) : m_radius * (3.0 - 4.0 * f);
+        pose.theta = forward ? 0.0 : M_PI;
+        break;
+    }
+    }
+
+    pose.x += m_offsetX;
+    pose.y += m_offsetY;
+    pose.theta = std::remainder(pose.theta, 2.0 * M_PI);
+    return pose;
+}
+
+void SimTrajectory::relocate(double x, double y)
+{
+    const Pose base = at(m_clock.nsecsElapsed() / 1e9);
+    m_offsetX += x - base.x;
+    m_offsetY += y - base.y;
+}
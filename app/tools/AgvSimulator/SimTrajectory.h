@@ -0,0 +1,48 @@
+#ifndef SIMTRAJECTORY_H
+#define SIMTRAJECTORY_H
+
+#include <QElapsedTimer>
+#include <QString>
+
+// 模拟车辆的位姿轨迹，控制器与 rosbridge 两个模拟端共用，保证 AGV_STATE、/agv_state 与点云一致
+class SimTrajectory
+{
+public:
+    enum class Shape
+    {
+        Static, // 停在原点
+        Circle, // 绕原点做圆周运动
+        Line    // 沿 x 轴往返
+    };
+
+    struct Pose
+    {
+        double x = 0.0;     // m
+        double y = 0.0;     // m
+        double theta = 0.0; // rad
+    };
+
+    SimTrajectory(Shape shape, double radiusM, double periodS);
+
+    // 解析 "static" / "circle" / "line"，无法识别时返回 false
+    static bool parseShape(const QString &name, Shape &shape);
+
+    // 当前时刻的位姿（以构造时刻为零点）
+    Pose now() const;
+    Pose at(double seconds) const;
+
+    // 收到 /baseinipose 等重定位时，把轨迹整体平移到指定位置
+    void relocate(double x, double y);
+
+    bool isStatic() const { return m_shape == Shape::Static; }
+
+private:
+    Shape m_shape;
+    double m_radius;
+    double m_period;
+    double m_offsetX = 0.0;
+    double m_offsetY = 0.0;
+    QElapsedTimer m_clock;
+};
+
+#endif // SIMTRAJECTORY_H
@@ -0,0 +1,85 @@
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QTextStream>
+#include "SimControllerServer.h"
+#include "SimRosBridgeServer.h"
+#include "SimTrajectory.h"
+
+// 本地 AGV 模拟器，用于脱离真车进行联调与压测
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    app.setApplicationName("AgvSimulator");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Ruinap 本地 AGV 控制器与 rosbridge 模拟器");
+    parser.addHelpOption();
+
+    QCommandLineOption commPortOpt("comm-port", "控制器数据通讯端口", "port", "9001");
+    QCommandLineOption noSubscribeOpt("no-subscribe", "忽略 SUBSCRIBE，模拟不支持订阅的旧控制器");
+    QCommandLineOption noCborOpt("no-cbor", "拒绝 SET_ENCODING，始终使用 JSON 文本帧");
+    QCommandLineOption idleOpt("idle", "车辆静止，状态保持不变");
+    QCommandLineOption tickOpt("tick-ms", "模拟状态的更新周期", "ms", "50");
+    QCommandLineOption delayOpt("reply-delay-ms", "轮询应答的延迟，模拟控制器处理耗时", "ms", "0");
+    QCommandLineOption rosPortOpt("ros-port", "rosbridge 端口", "port", "9090");
+    QCommandLineOption noRosOpt("no-ros", "不启动 rosbridge 模拟端");
+    QCommandLineOption scanPointsOpt("scan-points", "每帧点云的点数", "n", "2000");
+    QCommandLineOption scanHzOpt("scan-hz", "点云发布频率", "hz", "10");
+    QCommandLineOption stateHzOpt("state-hz", "/agv_state 发布频率", "hz", "20");
+    QCommandLineOption jitterOpt("jitter-ms", "每次 rosbridge 发布叠加 0~N ms 的随机延迟", "ms", "0");
+    QCommandLineOption trajectoryOpt("trajectory", "车辆轨迹：circle / line / static", "shape", "circle");
+    QCommandLineOption radiusOpt("radius-m", "圆周半径或直线往返的半程", "m", "5");
+    QCommandLineOption periodOpt("period-s", "轨迹一个周期的时长", "s", "20");
+    parser.addOption(commPortOpt);
+    parser.addOption(noSubscribeOpt);
+    parser.addOption(noCborOpt);
+    parser.addOption(idleOpt);
+    parser.addOption(tickOpt);
+    parser.addOption(delayOpt);
+    parser.addOption(rosPortOpt);
+    parser.addOption(noRosOpt);
+    parser.addOption(scanPointsOpt);
+    parser.addOption(scanHzOpt);
+    parser.addOption(stateHzOpt);
+    parser.addOption(jitterOpt);
+    parser.addOption(trajectoryOpt);
+    parser.addOption(radiusOpt);
+    parser.addOption(periodOpt);
+    parser.process(app);
+
+    SimControllerServer::Options opt;
+    opt.port = static_cast<quint16>(parser.value(commPortOpt).toUInt());
+    opt.supportSubscribe = !parser.isSet(noSubscribeOpt);
+    opt.supportCbor = !parser.isSet(noCborOpt);
+    opt.idle = parser.isSet(idleOpt);
+    opt.tickMs = qMax(1, parser.value(tickOpt).toInt());
+    opt.replyDelayMs = qMax(0, parser.value(delayOpt).toInt());
+
+    // --idle 沿用旧语义：车辆静止
+    SimTrajectory::Shape shape = SimTrajectory::Shape::Circle;
+    if (!SimTrajectory::parseShape(parser.value(trajectoryOpt), shape))
+    {
+        QTextStream(stderr) << "Unknown trajectory: " << parser.value(trajectoryOpt) << "\n";
+        return 1;
+    }
+    if (opt.idle)
+        shape = SimTrajectory::Shape::Static;
+    SimTrajectory trajectory(shape, parser.value(radiusOpt).toDouble(), parser.value(periodOpt).toDouble());
+
+    SimControllerServer controller(opt, &trajectory);
+    if (!controller.start())
+        return 1;
+
+    SimRosBridgeServer::Options rosOpt;
+    rosOpt.port = static_cast<quint16>(parser.value(rosPortOpt).toUInt());
+    rosOpt.scanPoints = qBound(1, parser.value(scanPointsOpt).toInt(), 200000);
+    rosOpt.scanHz = qMax(0.1, parser.value(scanHzOpt).toDouble());
+    rosOpt.stateHz = qMax(0.1, parser.value(stateHzOpt).toDouble());
+    rosOpt.jitterMs = qMax(0, parser.value(jitterOpt).toInt());
+
+    SimRosBridgeServer rosBridge(rosOpt, &trajectory);
+    if (!parser.isSet(noRosOpt) && !rosBridge.start())
+        return 1;
+
+    return app.exec();
+}
@@ -0,0 +1,1085 @@
+#include <QGuiApplication>
+#include <QCommandLineParser>
+#include <QCborStreamWriter>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QHash>
+#include <QImage>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QPainter>
+#include <QPixmap>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QTemporaryDir>
+#include <QThread>
+#include <QTimer>
+#include <QtMath>
+#include <atomic>
+#include <cstdio>
+#include <functional>
+#ifdef Q_OS_LINUX
+#include <sys/resource.h>
+#endif
+#include "Version.h"
+#include "AgvData.h"
+#include "RosBridgeClient.h"
+#include "RosBridgeDecoder.h"
+#include "PointCloudDecimator.h"
+#include "PointCloudRaster.h"
+#include "PointCloudTrail.h"
+#include "MapDistanceField.h"
+#include "TrafficCapture.h"
+#include "AllocCounter.h"
+#include "monitor/MapDataManager.h"
+#include "layers/GridLayer.h"
+#include "layers/MapLayer.h"
+#include "layers/PointPathLayer.h"
+#include "layers/AgvLayer.h"
+#include "layers/PointCloudLayer.h"
+#include "layers/RelocationLayer.h"
+#include "layers/FixedRelocationLayer.h"
+
+// 接收与绘制热点路径的基准：AGV_STATE 解析、rosbridge CBOR 解码、地图 JSON 载入、各图层离屏绘制
+// 结果以 JSON 输出（--output 或标准输出），进度与对比表输出到标准错误；
+// 指定 --baseline 时与上一版本的结果逐项对比，超出 --max-regression 时返回非零
+
+// 离屏绘制的画布尺寸，与工控屏上 MonitorWidget 的绘图区相当
+static const int CANVAS_W = 1280;
+static const int CANVAS_H = 800;
+
+struct CaseResult
+{
+    QString id;         // 唯一标识，用于与基线对比
+    QJsonObject params;
+    qint64 iterations = 0;
+    double nsPerOp = 0;
+    double allocsPerOp = 0;
+    QJsonObject extra;  // 用例附带的其他测量值，原样写入结果
+};
+
+// 预热一次后反复执行 op，直到累计耗时达到 minNs；op 的参数为迭代序号
+static CaseResult runCase(const QString &id, const QJsonObject &params, qint64 minNs, const std::function<void(qint64)> &op)
+{
+    op(0);
+
+    CaseResult result;
+    result.id = id;
+    result.params = params;
+
+    const quint64 allocBefore = AllocCounter::count();
+    QElapsedTimer timer;
+    timer.start();
+    qint64 n = 0;
+    qint64 ns = 0;
+    do
+    {
+        op(n++);
+        ns = timer.nsecsElapsed();
+    } while (ns < minNs);
+    const quint64 allocs = AllocCounter::count() - allocBefore;
+
+    result.iterations = n;
+    result.nsPerOp = static_cast<double>(ns) / n;
+    result.allocsPerOp = static_cast<double>(allocs) / n;
+    std::fprintf(stderr, "%-44s %10lld 次 %14.0f ns/次 %10.1f 分配/次\n",
+                 qPrintable(id), static_cast<long long>(n), result.nsPerOp, result.allocsPerOp);
+    return result;
+}
+
+// 与 runCase 相同，但每次迭代分为两段：background(i) 代表在其他线程完成的工作，不计时；
+// foreground(i) 代表主线程上的工作，只累计这一段的耗时与分配
+static CaseResult splitCase(const QString &id, const QJsonObject &params, qint64 minNs,
+                            const std::function<void(qint64)> &background, const std::function<void(qint64)> &foreground)
+{
+    background(0);
+    foreground(0);
+
+    CaseResult result;
+    result.id = id;
+    result.params = params;
+
+    QElapsedTimer timer;
+    qint64 n = 0;
+    qint64 ns = 0;
+    quint64 allocs = 0;
+    do
+    {
+        background(n);
+        const quint64 allocBefore = AllocCounter::count();
+        timer.start();
+        foreground(n++);
+        ns += timer.nsecsElapsed();
+        allocs += AllocCounter::count() - allocBefore;
+    } while (ns < minNs);
+
+    result.iterations = n;
+    result.nsPerOp = static_cast<double>(ns) / n;
+    result.allocsPerOp = static_cast<double>(allocs) / n;
+    std::fprintf(stderr, "%-44s %10lld 次 %14.0f ns/次 %10.1f 分配/次\n",
+                 qPrintable(id), static_cast<long long>(n), result.nsPerOp, result.allocsPerOp);
+    return result;
+}
+
+// ---- 负载生成 ----
+
+static QJsonObject attr(const QJsonValue &value, const QString &color = QStringLiteral("#000000"))
+{
+    QJsonObject obj;
+    obj.insert(QStringLiteral("value"), value);
+    obj.insert(QStringLiteral("color"), color);
+    return obj;
+}
+
+// 合成 AGV_STATE 帧：字段表中的全部 AGVInfo 字段，每帧只有位姿和速度变化
+static QVector<QString> syntheticStateFrames(int count)
+{
+    QVector<QString> frames;
+    for (int i = 0; i < count; ++i)
+    {
+        QJsonObject info;
+#define AGV_SYN_FIELD(type, member, getter, key, init) info.insert(QStringLiteral(key), attr(type(init).value));
+        AGV_INFO_FIELDS(AGV_SYN_FIELD)
+#undef AGV_SYN_FIELD
+        info.insert(QStringLiteral("slam_x"), attr(5000 + i * 7));
+        info.insert(QStringLiteral("slam_y"), attr(-3000 + i * 3));
+        info.insert(QStringLiteral("slam_angle"), attr((i * 11) % 36000));
+        info.insert(QStringLiteral("v_x"), attr(600 + i % 20, QStringLiteral("#00FF00")));
+
+        QJsonObject optional;
+        optional.insert(QStringLiteral("lift_height"), attr(i / 100));
+
+        QJsonObject body;
+        body.insert(QStringLiteral("AGVInfo"), info);
+        body.insert(QStringLiteral("OptionalINFO"), optional);
+
+        QJsonObject root;
+        root.insert(QStringLiteral("Event"), QStringLiteral("AGV_STATE"));
+        root.insert(QStringLiteral("IsSucceed"), true);
+        root.insert(QStringLiteral("DataStamps"), i);
+        root.insert(QStringLiteral("Body"), body);
+        frames.append(QString::fromUtf8(QJsonDocument(root).toJson(QJsonDocument::Compact)));
+    }
+    return frames;
+}
+
+// 从流量录制中取出数据通讯的 JSON 帧与 rosbridge 的点云帧
+static bool loadCapture(const QString &path, QVector<QString> &stateFrames, QVector<QByteArray> &rosFrames)
+{
+    TrafficCaptureReader reader;
+    QString error;
+    if (!reader.open(path, error))
+    {
+        std::fprintf(stderr, "%s\n", qPrintable(error));
+        return false;
+    }
+
+    TrafficCaptureReader::Record rec;
+    while (reader.next(rec))
+    {
+        if (rec.channel == TrafficCapture::Channel::Comm && rec.kind == TrafficCapture::Kind::Text)
+            stateFrames.append(QString::fromUtf8(rec.data, rec.size));
+        else if (rec.channel == TrafficCapture::Channel::RosBridge)
+            rosFrames.append(QByteArray(rec.data, rec.size));
+    }
+    return true;
+}
+
+// rosbridge publish 帧外壳，msg 只有一个 data 字段（RFC 8746 小端类型数组）
+static QByteArray rosPublishFrame(const QString &topic, quint64 tag, const QByteArray &data)
+{
+    QByteArray frame;
+    QCborStreamWriter w(&frame);
+    w.startMap(3);
+    w.append(QLatin1String("op"));
+    w.append(QLatin1String("publish"));
+    w.append(QLatin1String("topic"));
+    w.append(topic);
+    w.append(QLatin1String("msg"));
+    w.startMap(1);
+    w.append(QLatin1String("data"));
+    w.append(QCborTag(tag));
+    w.append(data);
+    w.endMap();
+    w.endMap();
+    return frame;
+}
+
+// 车辆位于 20 m x 12 m 房间内时的一圈扫描
+static QVector<QPointF> scanPoints(int count)
+{
+    QVector<QPointF> points;
+    points.reserve(count);
+    for (int i = 0; i < count; ++i)
+    {
+        const double a = 2.0 * M_PI * i / count;
+        const double c = qCos(a), s = qSin(a);
+        double t = 1e9;
+        if (qAbs(c) > 1e-6)
+            t = qMin(t, ((c > 0 ? 10.0 : -10.0) - 2.0) / c);
+        if (qAbs(s) > 1e-6)
+            t = qMin(t, ((s > 0 ? 6.0 : -6.0) - 1.0) / s);
+        points.append(QPointF(2.0 + t * c, 1.0 + t * s));
+    }
+    return points;
+}
+
+static PointCloudBufferPtr toBuffer(const QVector<QPointF> &points)
+{
+    auto cloud = std::make_shared<PointCloudBuffer>();
+    cloud->resize(points.size());
+    float *xy = cloud->xy();
+    for (const QPointF &p : points)
+    {
+        *xy++ = static_cast<float>(p.x());
+        *xy++ = static_cast<float>(p.y());
+    }
+    return cloud;
+}
+
+static QByteArray laserFrame(const QVector<QPointF> &points)
+{
+    QByteArray data(points.size() * 3 * static_cast<int>(sizeof(float)), Qt::Uninitialized);
+    float *out = reinterpret_cast<float *>(data.data());
+    for (const QPointF &p : points)
+    {
+        *out++ = static_cast<float>(p.x());
+        *out++ = static_cast<float>(p.y());
+        *out++ = 0.0f;
+    }
+    return rosPublishFrame(QStringLiteral("/laser_points"), 85, data);
+}
+
+// 合成占据栅格：未知区包围的房间，内有货架，0.05 m 分辨率；y 行 0 在下
+static QByteArray occupancyCells(int width, int height)
+{
+    QByteArray cells(width * height, Qt::Uninitialized);
+    for (int y = 0; y < height; ++y)
+    {
+        char *row = cells.data() + static_cast<qsizetype>(y) * width;
+        for (int x = 0; x < width; ++x)
+        {
+            const bool inside = x > width / 20 && x < width - width / 20 && y > height / 20 && y < height - height / 20;
+            const bool shelf = inside && (x / 20) % 4 == 0 && (y / 200) % 2 == 0;
+            row[x] = static_cast<char>(!inside ? -1 : shelf ? 100 : (x ^ y) % 7 == 0 ? 30 : 0);
+        }
+    }
+    return cells;
+}
+
+// /map（nav_msgs/OccupancyGrid）或 /map_updates（map_msgs/OccupancyGridUpdate）发布帧，data 为 int8 类型数组（标签 72）
+static QByteArray occupancyGridFrame(bool full, int x, int y, int width, int height)
+{
+    QByteArray frame;
+    QCborStreamWriter w(&frame);
+    w.startMap(3);
+    w.append(QLatin1String("op"));
+    w.append(QLatin1String("publish"));
+    w.append(QLatin1String("topic"));
+    w.append(full ? QLatin1String("/map") : QLatin1String("/map_updates"));
+    w.append(QLatin1String("msg"));
+    if (full)
+    {
+        w.startMap(2);
+        w.append(QLatin1String("info"));
+        w.startMap(4);
+        w.append(QLatin1String("resolution"));
+        w.append(0.05f);
+        w.append(QLatin1String("width"));
+        w.append(static_cast<qint64>(width));
+        w.append(QLatin1String("height"));
+        w.append(static_cast<qint64>(height));
+        w.append(QLatin1String("origin"));
+        w.startMap(1);
+        w.append(QLatin1String("position"));
+        w.startMap(3);
+        w.append(QLatin1String("x"));
+        w.append(-width * 0.025);
+        w.append(QLatin1String("y"));
+        w.append(-height * 0.025);
+        w.append(QLatin1String("z"));
+        w.append(0.0);
+        w.endMap();
+        w.endMap();
+        w.endMap();
+    }
+    else
+    {
+        w.startMap(5);
+        w.append(QLatin1String("x"));
+        w.append(static_cast<qint64>(x));
+        w.append(QLatin1String("y"));
+        w.append(static_cast<qint64>(y));
+        w.append(QLatin1String("width"));
+        w.append(static_cast<qint64>(width));
+        w.append(QLatin1String("height"));
+        w.append(static_cast<qint64>(height));
+    }
+    w.append(QLatin1String("data"));
+    w.append(QCborTag(72));
+    w.append(occupancyCells(width, height));
+    w.endMap();
+    w.endMap();
+    return frame;
+}
+
+// 合成地图 JSON：cols x rows 的站点网格，每个站点连向右侧与上方的邻点，直线与贝塞尔路径交替
+static bool writeSyntheticMap(const QString &path, int pointCount)
+{
+    const int cols = qMax(1, static_cast<int>(qSqrt(pointCount)));
+    const int rows = (pointCount + cols - 1) / cols;
+    QJsonArray points;
+    for (int i = 0; i < pointCount; ++i)
+    {
+        const int cx = i % cols, cy = i / cols;
+        QJsonObject p;
+        p.insert("id", i + 1);
+        p.insert("x", cx * 2000);
+        p.insert("y", cy * 2000);
+        p.insert("charge", i % 50 == 0);
+        p.insert("loading", i % 17 == 0);
+        p.insert("unloading", false);
+
+        QJsonArray targets;
+        auto addTarget = [&](int target, int type)
+        {
+            const int tx = target % cols, ty = target / cols;
+            QJsonObject t;
+            t.insert("id", target + 1);
+            t.insert("type", type);
+            t.insert("ctl_1", QJsonObject{{"x", (cx * 2 + tx) * 1000 / 3 * 2}, {"y", cy * 2000 + 500}});
+            t.insert("ctl_2", QJsonObject{{"x", (cx + tx * 2) * 1000 / 3 * 2}, {"y", ty * 2000 - 500}});
+            targets.append(t);
+        };
+        if (cx + 1 < cols && i + 1 < pointCount)
+            addTarget(i + 1, 1 + i % 3);
+        if (cy + 1 < rows && i + cols < pointCount)
+            addTarget(i + cols, 1);
+        p.insert("targets", targets);
+        points.append(p);
+    }
+
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+        return false;
+    file.write(QJsonDocument(QJsonObject{{"point", points}}).toJson(QJsonDocument::Compact));
+    return true;
+}
+
+// 合成栅格地图：50 m x 30 m，0.05 m 分辨率，未知区包围的房间与若干货架
+static QPixmap syntheticMapPixmap()
+{
+    QImage img(1000, 600, QImage::Format_Grayscale8);
+    img.fill(205);
+    QPainter p(&img);
+    p.fillRect(QRect(50, 50, 900, 500), QColor(254, 254, 254));
+    p.setPen(QPen(Qt::black, 2));
+    p.drawRect(QRect(50, 50, 900, 500));
+    for (int x = 120; x < 900; x += 80)
+        p.fillRect(QRect(x, 120, 20, 360), Qt::black);
+    p.end();
+    return QPixmap::fromImage(img);
+}
+
+// 对照：PointCloudRaster 之前逐点 drawEllipse 的绘制方式
+class EllipseCloudLayer : public BaseLayer
+{
+public:
+    explicit EllipseCloudLayer(const PointCloudBufferPtr &cloud) : m_cloud(cloud) {}
+
+    void draw(QPainter *painter) override
+    {
+        painter->save();
+        painter->setPen(Qt::NoPen);
+        painter->setBrush(Qt::red);
+        const double pointRadius = 2.0 / qSqrt(qAbs(painter->transform().determinant()));
+        const float *xy = m_cloud->xy();
+        for (int i = 0; i < m_cloud->size(); ++i, xy += 2)
+            painter->drawEllipse(QPointF(xy[0], -xy[1]), pointRadius, pointRadius);
+        painter->restore();
+    }
+
+private:
+    PointCloudBufferPtr m_cloud;
+};
+
+// 当前帧加 N 帧历史轨迹：与 PointCloudLayer::draw 相同的批次，时间固定在最后一帧入队时，
+// 避免计时过程中历史帧淡出；历史帧逐帧平移，模拟行驶中的扫描
+class TrailCloudLayer : public BaseLayer
+{
+public:
+    TrailCloudLayer(const PointCloudBufferPtr &cloud, int scans) : m_cloud(cloud)
+    {
+        m_trail.setLimits(scans, 64ll * 1024 * 1024);
+        std::shared_ptr<PointCloudBuffer> shifted = PointCloudPool::instance()->acquire(cloud->size());
+        for (int k = 0; k < scans; ++k)
+        {
+            for (int i = 0; i < cloud->size(); ++i)
+            {
+                shifted->xy()[2 * i] = cloud->xy()[2 * i] - 0.05f * (scans - k);
+                shifted->xy()[2 * i + 1] = cloud->xy()[2 * i + 1];
+            }
+            m_trail.push(*shifted, QPointF(-0.05 * (scans - k), 0.0), 0.0, k * 100);
+        }
+        m_nowMs = scans * 100;
+    }
+
+    void draw(QPainter *painter) override
+    {
+        m_raster.begin(painter);
+        m_trail.draw(m_raster, m_nowMs, qRgb(255, 0, 0));
+        m_raster.drawPoints(m_cloud->xy(), m_cloud->size(), qRgb(255, 0, 0));
+        m_raster.end();
+    }
+
+private:
+    PointCloudBufferPtr m_cloud;
+    PointCloudTrail m_trail;
+    PointCloudRaster m_raster;
+    qint64 m_nowMs = 0;
+};
+
+// 带裁剪的绘制，模拟 MonitorWidget 只在左侧绘图区内绘制：PointCloudRaster 走叠加层路径
+class ClippedLayer : public BaseLayer
+{
+public:
+    ClippedLayer(BaseLayer *inner, const QRect &clip) : m_inner(inner), m_clip(clip) {}
+
+    void draw(QPainter *painter) override
+    {
+        painter->save();
+        const QTransform t = painter->transform();
+        painter->resetTransform();
+        painter->setClipRect(m_clip);
+        painter->setTransform(t);
+        m_inner->draw(painter);
+        painter->restore();
+    }
+
+private:
+    BaseLayer *m_inner;
+    QRect m_clip;
+};
+
+// 离屏绘制：与 MonitorWidget::paintEvent 相同的视口变换（画布中心为世界原点）
+static CaseResult renderCase(const QString &layerName, BaseLayer *layer, double scale, const QJsonObject &extra, qint64 minNs)
+{
+    QImage canvas(CANVAS_W, CANVAS_H, QImage::Format_ARGB32_Premultiplied);
+    QJsonObject params = extra;
+    params.insert("layer", layerName);
+    params.insert("scale", scale);
+    params.insert("width", CANVAS_W);
+    params.insert("height", CANVAS_H);
+
+    QString id = QStringLiteral("render/%1").arg(layerName);
+    for (auto it = extra.constBegin(); it != extra.constEnd(); ++it)
+        id += QStringLiteral("/%1=%2").arg(it.key(), it.value().toVariant().toString());
+    id += QStringLiteral("/x%1").arg(scale);
+
+    return runCase(id, params, minNs, [&](qint64)
+                   {
+                       canvas.fill(Qt::white);
+                       QPainter painter(&canvas);
+                       painter.setRenderHint(QPainter::Antialiasing, true);
+                       painter.translate(CANVAS_W / 2.0, CANVAS_H / 2.0);
+                       painter.scale(scale, scale);
+                       layer->draw(&painter); });
+}
+
+// ---- 网络线程布局 ----
+
+#ifdef Q_OS_LINUX
+// 线程级资源统计：CPU 时间与主动 / 被动上下文切换次数（主动切换即每次因等待事件而睡眠，近似唤醒次数）
+struct ThreadUsage
+{
+    qint64 cpuNs = 0;
+    qint64 voluntary = 0;
+    qint64 involuntary = 0;
+};
+
+static ThreadUsage currentThreadUsage()
+{
+    rusage ru;
+    getrusage(RUSAGE_THREAD, &ru);
+    ThreadUsage usage;
+    usage.cpuNs = (static_cast<qint64>(ru.ru_utime.tv_sec + ru.ru_stime.tv_sec) * 1000000LL +
+                   ru.ru_utime.tv_usec + ru.ru_stime.tv_usec) *
+                  1000LL;
+    usage.voluntary = ru.ru_nvcsw;
+    usage.involuntary = ru.ru_nivcsw;
+    return usage;
+}
+
+// 与 NetworkReactor 的两种布局相同的接收端：clients 个 QTcpSocket，threads 为 0 时每个连接独占一个线程，
+// 否则轮询分配到 threads 个共享线程。发送端在独立线程中经本机回环按 hz 向每个连接错开相位写入 frameBytes 字节，
+// 接收端在 readyRead 中读出全部数据。只统计接收线程的 CPU 时间与上下文切换，发送端两种布局相同，不计入
+static CaseResult netLayoutCase(int clients, int threads, int hz, int frameBytes, qint64 durationNs)
+{
+    const int threadCount = threads > 0 ? threads : clients;
+    const QString id = threads > 0 ? QStringLiteral("NetworkReactor/shared-%1/%2-clients").arg(threads).arg(clients)
+                                    : QStringLiteral("NetworkReactor/dedicated/%1-clients").arg(clients);
+
+    // 发送端
+    QThread senderThread;
+    senderThread.setObjectName(QStringLiteral("BenchSender"));
+    QObject senderCtx;
+    senderCtx.moveToThread(&senderThread);
+    senderThread.start();
+
+    const QByteArray frame(frameBytes, 'x');
+    const int periodMs = qMax(1, 1000 / qMax(1, hz));
+    QTcpServer *server = nullptr;
+    quint16 port = 0;
+    int accepted = 0;
+    QMetaObject::invokeMethod(&senderCtx, [&]()
+                              {
+        server = new QTcpServer;
+        server->listen(QHostAddress::LocalHost, 0);
+        port = server->serverPort();
+        QObject::connect(server, &QTcpServer::newConnection, server, [server, frame, periodMs, clients, &accepted]()
+                         {
+            while (QTcpSocket *peer = server->nextPendingConnection())
+            {
+                // 各连接错开相位，模拟互不相关的数据源
+                const int index = accepted++;
+                QTimer *timer = new QTimer(peer);
+                timer->setTimerType(Qt::PreciseTimer);
+                QObject::connect(timer, &QTimer::timeout, peer, [peer, frame]()
+                                 { peer->write(frame); });
+                QTimer::singleShot(index * periodMs / qMax(1, clients), timer, [timer, periodMs]()
+                                   { timer->start(periodMs); });
+            } }); }, Qt::BlockingQueuedConnection);
+
+    // 接收端：每个线程一个探针对象，用于在该线程中采样资源统计与销毁连接
+    QVector<QThread *> ioThreads;
+    QVector<QObject *> probes;
+    for (int i = 0; i < threadCount; ++i)
+    {
+        QThread *thread = new QThread;
+        thread->setObjectName(QStringLiteral("NetIO-%1").arg(i));
+        QObject *probe = new QObject;
+        probe->moveToThread(thread);
+        thread->start();
+        ioThreads.append(thread);
+        probes.append(probe);
+    }
+
+    std::atomic<int> connected{0};
+    std::atomic<qint64> received{0};
+    QVector<QVector<QTcpSocket *>> sockets(threadCount);
+    for (int c = 0; c < clients; ++c)
+    {
+        const int t = c % threadCount;
+        QMetaObject::invokeMethod(probes[t], [&, t]()
+                                  {
+            QTcpSocket *socket = new QTcpSocket;
+            sockets[t].append(socket);
+            QObject::connect(socket, &QTcpSocket::connected, socket, [&connected]()
+                             { connected.fetch_add(1); });
+            QObject::connect(socket, &QTcpSocket::readyRead, socket, [socket, &received]()
+                             { received.fetch_add(socket->readAll().size(), std::memory_order_relaxed); });
+            socket->connectToHost(QHostAddress::LocalHost, port); }, Qt::BlockingQueuedConnection);
+    }
+
+    QElapsedTimer waitTimer;
+    waitTimer.start();
+    while (connected.load() < clients && waitTimer.elapsed() < 5000)
+        QThread::msleep(10);
+    QThread::msleep(200); // 等待各连接的发送定时器都已启动
+
+    auto sample = [&]()
+    {
+        ThreadUsage total;
+        for (QObject *probe : qAsConst(probes))
+        {
+            ThreadUsage usage;
+            QMetaObject::invokeMethod(probe, [&usage]()
+                                      { usage = currentThreadUsage(); }, Qt::BlockingQueuedConnection);
+            total.cpuNs += usage.cpuNs;
+            total.voluntary += usage.voluntary;
+            total.involuntary += usage.involuntary;
+        }
+        return total;
+    };
+
+    const ThreadUsage before = sample();
+    const qint64 bytesBefore = received.load();
+    QElapsedTimer timer;
+    timer.start();
+    QThread::usleep(static_cast<unsigned long>(durationNs / 1000));
+    const ThreadUsage after = sample();
+    const qint64 bytes = received.load() - bytesBefore;
+    const double seconds = timer.nsecsElapsed() / 1e9;
+
+    // 清理：连接在各自线程中销毁，再停止线程
+    QMetaObject::invokeMethod(&senderCtx, [&server]()
+                              { delete server; }, Qt::BlockingQueuedConnection);
+    senderThread.quit();
+    senderThread.wait();
+    for (int t = 0; t < threadCount; ++t)
+    {
+        QMetaObject::invokeMethod(probes[t], [&sockets, t]()
+                                  { qDeleteAll(sockets[t]); }, Qt::BlockingQueuedConnection);
+        ioThreads[t]->quit();
+        ioThreads[t]->wait();
+        delete probes[t];
+        delete ioThreads[t];
+    }
+
+    CaseResult result;
+    result.id = id;
+    result.params = QJsonObject{{"clients", clients}, {"threads", threadCount}, {"hz", hz}, {"frame_bytes", frameBytes}};
+    result.iterations = bytes / qMax(1, frameBytes);
+    const qint64 cpuNs = after.cpuNs - before.cpuNs;
+    result.nsPerOp = result.iterations > 0 ? static_cast<double>(cpuNs) / result.iterations : 0.0;
+    const double cpuPercent = cpuNs / 1e9 / seconds * 100.0;
+    const double wakeupsPerSec = (after.voluntary - before.voluntary) / seconds;
+    const double preemptPerSec = (after.involuntary - before.involuntary) / seconds;
+    result.extra = QJsonObject{{"seconds", seconds},
+                               {"cpu_percent", cpuPercent},
+                               {"voluntary_cs_per_s", wakeupsPerSec},
+                               {"involuntary_cs_per_s", preemptPerSec}};
+    std::fprintf(stderr, "%-44s %10lld 帧 %14.0f CPU ns/帧 %6.2f%% CPU %8.0f 次唤醒/s\n",
+                 qPrintable(id), static_cast<long long>(result.iterations), result.nsPerOp, cpuPercent, wakeupsPerSec);
+    return result;
+}
+#endif
+
+// ---- 结果输出与基线对比 ----
+
+static QJsonObject resultJson(const CaseResult &r)
+{
+    QJsonObject obj;
+    obj.insert("id", r.id);
+    obj.insert("params", r.params);
+    obj.insert("iterations", r.iterations);
+    obj.insert("ns_per_op", r.nsPerOp);
+    obj.insert("allocs_per_op", AllocCounter::available() ? QJsonValue(r.allocsPerOp) : QJsonValue());
+    // 解码类用例按输入字节数折算为每 MB（2^20 字节）耗时，便于不同规模之间比较
+    const double bytes = r.params.value("bytes").toDouble();
+    if (bytes > 0)
+        obj.insert("ms_per_mb", r.nsPerOp / bytes * 1048576.0 / 1e6);
+    for (auto it = r.extra.constBegin(); it != r.extra.constEnd(); ++it)
+        obj.insert(it.key(), it.value());
+    return obj;
+}
+
+// 返回超出阈值的项数；基线中不存在的项只提示不计入
+static int compareBaseline(const QString &path, const QVector<CaseResult> &results, double maxRegression)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        std::fprintf(stderr, "无法打开基线文件 %s\n", qPrintable(path));
+        return 0;
+    }
+    const QJsonObject root = QJsonDocument::fromJson(file.readAll()).object();
+    QHash<QString, double> base;
+    for (const QJsonValue &v : root.value("results").toArray())
+        base.insert(v.toObject().value("id").toString(), v.toObject().value("ns_per_op").toDouble());
+
+    std::fprintf(stderr, "\n与基线 %s（版本 %s）对比，阈值 +%.0f%%\n",
+                 qPrintable(path), qPrintable(root.value("version").toString()), maxRegression * 100.0);
+    int regressions = 0;
+    for (const CaseResult &r : results)
+    {
+        const double old = base.value(r.id, 0.0);
+        if (old <= 0.0)
+        {
+            std::fprintf(stderr, "%-44s %10s\n", qPrintable(r.id), "新增");
+            continue;
+        }
+        const double ratio = r.nsPerOp / old;
+        const bool regressed = ratio > 1.0 + maxRegression;
+        regressions += regressed ? 1 : 0;
+        std::fprintf(stderr, "%-44s %+9.1f%%%s\n", qPrintable(r.id), (ratio - 1.0) * 100.0, regressed ? "  退化" : "");
+    }
+    return regressions;
+}
+
+int main(int argc, char *argv[])
+{
+    // 图层绘制需要 QPixmap，没有显示设备时使用 offscreen 平台
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+
+    QGuiApplication app(argc, argv);
+    app.setApplicationName("RuinapControlBench");
+    app.setApplicationVersion(APP_VERSION);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Ruinap 接收与绘制热点路径基准，结果以 JSON 输出");
+    parser.addHelpOption();
+    parser.addVersionOption();
+
+    QCommandLineOption outputOpt("output", "JSON 结果文件，不指定时输出到标准输出", "file");
+    QCommandLineOption baselineOpt("baseline", "上一版本的 JSON 结果，逐项对比耗时", "file");
+    QCommandLineOption maxRegOpt("max-regression", "允许的耗时增幅，超出时返回 4", "ratio", "0.2");
+    QCommandLineOption minTimeOpt("min-time-ms", "每项至少运行的时长", "ms", "300");
+    QCommandLineOption captureOpt("capture", "流量录制文件或目录，以录制的 AGV_STATE 与点云帧代替合成帧", "path");
+    QCommandLineOption mapOpt("map", "地图 JSON 文件，不指定时使用合成地图", "file");
+    QCommandLineOption mapPointsOpt("map-points", "合成地图的站点数", "n", "1000");
+    QCommandLineOption scanSizesOpt("scan-points", "点云规模，逗号分隔", "list", "2000,20000");
+    QCommandLineOption scalesOpt("scales", "绘制缩放（像素/米），逗号分隔", "list", "10,50,200");
+    QCommandLineOption gridSizeOpt("grid-size", "栅格地图（/map）边长，单位为格", "n", "4000");
+    QCommandLineOption netClientsOpt("net-clients", "网络线程布局对比的连接数", "n", "3");
+    QCommandLineOption netHzOpt("net-hz", "网络线程布局对比中每个连接的帧率", "hz", "50");
+    QCommandLineOption netSecondsOpt("net-seconds", "网络线程布局对比每种布局的运行时长", "s", "3");
+    parser.addOption(outputOpt);
+    parser.addOption(baselineOpt);
+    parser.addOption(maxRegOpt);
+    parser.addOption(minTimeOpt);
+    parser.addOption(captureOpt);
+    parser.addOption(mapOpt);
+    parser.addOption(mapPointsOpt);
+    parser.addOption(scanSizesOpt);
+    parser.addOption(scalesOpt);
+    parser.addOption(gridSizeOpt);
+    parser.addOption(netClientsOpt);
+    parser.addOption(netHzOpt);
+    parser.addOption(netSecondsOpt);
+    parser.process(app);
+
+    // 日志只会干扰计时与 JSON 输出
+    spdlog::set_level(spdlog::level::off);
+
+    const qint64 minNs = qMax(1, parser.value(minTimeOpt).toInt()) * 1000000LL;
+    QVector<int> scanSizes;
+    for (const QString &s : parser.value(scanSizesOpt).split(',', QString::SkipEmptyParts))
+        scanSizes.append(qMax(1, s.toInt()));
+    QVector<double> scales;
+    for (const QString &s : parser.value(scalesOpt).split(',', QString::SkipEmptyParts))
+        scales.append(qMax(0.1, s.toDouble()));
+
+    QVector<QString> stateFrames;
+    QVector<QByteArray> capturedRos;
+    if (parser.isSet(captureOpt) && !loadCapture(parser.value(captureOpt), stateFrames, capturedRos))
+        return 1;
+    if (stateFrames.isEmpty())
+        stateFrames = syntheticStateFrames(1000);
+
+    QVector<CaseResult> results;
+
+    // 1. AGV_STATE 解析：AgvData::parseMsg 完整路径（解码、发布快照、变化通知）
+    //    AgvData 构造时会在 I/O 线程中尝试连接 rosbridge，与计时无关
+    {
+        AgvData *data = AgvData::instance();
+        results.append(runCase(QStringLiteral("AgvData::parseMsg"),
+                               QJsonObject{{"frames", stateFrames.size()}, {"captured", parser.isSet(captureOpt)}}, minNs,
+                               [&](qint64 i)
+                               { data->parseMsg(stateFrames[static_cast<int>(i % stateFrames.size())]); }));
+
+        // 主线程每条消息的耗时：解析在主线程（旧布局）与在通讯子线程（现布局）对比
+        // 两种布局中主线程都要投递 fieldsChanged，并像各界面组件一样读取一次快照；
+        // 现布局下 parseMsg 在其他线程执行，这里不计时，主线程只处理投递过来的通知
+        qint64 sink = 0;
+        QObject::connect(data, &AgvData::fieldsChanged, [data, &sink](quint64 mask)
+                         { sink += static_cast<qint64>(mask) + (data->snapshot() ? 1 : 0); });
+        auto deliver = [data]()
+        { QCoreApplication::sendPostedEvents(data, QEvent::MetaCall); };
+        deliver();
+
+        const QJsonObject guiParams{{"frames", stateFrames.size()}, {"captured", parser.isSet(captureOpt)}};
+        results.append(splitCase(QStringLiteral("GuiThread/AGV_STATE/parse-on-gui"), guiParams, minNs, [](qint64) {}, [&](qint64 i)
+                                 { data->parseMsg(stateFrames[static_cast<int>(i % stateFrames.size())]);
+                                   deliver(); }));
+        results.append(splitCase(QStringLiteral("GuiThread/AGV_STATE/parse-on-worker"), guiParams, minNs, [&](qint64 i)
+                                 { data->parseMsg(stateFrames[static_cast<int>(i % stateFrames.size())]); }, [&](qint64)
+                                 { deliver(); }));
+        std::fprintf(stderr, "fieldsChanged 校验和 %lld\n", static_cast<long long>(sink));
+    }
+
+    // 2. rosbridge CBOR 解码：经 injectBinaryMessage 进入与 socket 相同的解析入口
+    {
+        RosBridgeClient ros;
+        qint64 sink = 0;
+        QObject::connect(&ros, &RosBridgeClient::pointCloudReceived, [&sink](const PointCloudBufferPtr &cloud)
+                         { sink += cloud->size(); });
+        QObject::connect(&ros, &RosBridgeClient::agvStateReceived, [&sink](const QVector<int> &state)
+                         { sink += state.size(); });
+
+        for (int n : scanSizes)
+        {
+            const QByteArray frame = laserFrame(scanPoints(n));
+            results.append(runCase(QStringLiteral("RosBridgeClient/laser_points/%1").arg(n),
+                                   QJsonObject{{"points", n}, {"bytes", frame.size()}}, minNs,
+                                   [&](qint64)
+                                   { ros.injectBinaryMessage(frame); }));
+        }
+
+        const qint32 state[4] = {1, 2000, 1000, 785};
+        const QByteArray stateFrame = rosPublishFrame(QStringLiteral("/agv_state"), 78,
+                                                      QByteArray(reinterpret_cast<const char *>(state), sizeof(state)));
+        results.append(runCase(QStringLiteral("RosBridgeClient/agv_state"), QJsonObject{{"bytes", stateFrame.size()}}, minNs,
+                               [&](qint64)
+                               { ros.injectBinaryMessage(stateFrame); }));
+
+        if (!capturedRos.isEmpty())
+        {
+            results.append(runCase(QStringLiteral("RosBridgeClient/captured"), QJsonObject{{"frames", capturedRos.size()}}, minNs,
+                                   [&](qint64 i)
+                                   { ros.injectBinaryMessage(capturedRos[static_cast<int>(i % capturedRos.size())]); }));
+        }
+        std::fprintf(stderr, "rosbridge 校验和 %lld，点云缓冲池 %d 个，复用 %llu 次，池满临时分配 %llu 次\n", sink,
+                     PointCloudPool::instance()->pooled(), PointCloudPool::instance()->reused(), PointCloudPool::instance()->overflow());
+    }
+
+    // 2b. rosbridge 解码器单独对比：流式（QCborStreamReader）与 DOM（QCborValue 建树）
+    //     额外加入 100000 点（约 1.2 MB）的大帧，结果中的 ms_per_mb 即每 MB 解析耗时
+    {
+        RosBridgeDecoder decoder;
+        RosBridgeMessage message;
+        QVector<int> sizes = scanSizes;
+        if (!sizes.contains(100000))
+            sizes.append(100000);
+
+        for (int n : sizes)
+        {
+            const QByteArray frame = laserFrame(scanPoints(n));
+            const QJsonObject params{{"points", n}, {"bytes", frame.size()}};
+            results.append(runCase(QStringLiteral("RosBridgeDecoder/laser_points/%1/dom").arg(n), params, minNs,
+                                   [&](qint64)
+                                   { decoder.decodeDom(frame, message); }));
+            results.append(runCase(QStringLiteral("RosBridgeDecoder/laser_points/%1/stream").arg(n), params, minNs,
+                                   [&](qint64)
+                                   { decoder.decode(frame, message); }));
+            std::fprintf(stderr, "  %d 点 %d 字节：%.2f MB/s（dom） %.2f MB/s（stream）\n", n, frame.size(),
+                         frame.size() / results[results.size() - 2].nsPerOp * 1e9 / 1048576.0,
+                         frame.size() / results.last().nsPerOp * 1e9 / 1048576.0);
+        }
+        message.cloud.reset();
+    }
+
+    // 2c. 点云变换内核：全部点一次变换到设备像素
+    {
+        QTransform t;
+        t.translate(CANVAS_W / 2.0, CANVAS_H / 2.0);
+        t.scale(50.0, 50.0);
+        for (int n : scanSizes)
+        {
+            const PointCloudBufferPtr cloud = toBuffer(scanPoints(n));
+            std::vector<qint32> pixels(static_cast<size_t>(2 * n));
+            results.append(runCase(QStringLiteral("PointCloudRaster::transformPoints/%1").arg(n), QJsonObject{{"points", n}}, minNs,
+                                   [&](qint64)
+                                   { PointCloudRaster::transformPoints(cloud->xy(), n, t, pixels.data()); }));
+        }
+    }
+
+    // 2d. 栅格地图：/map 整幅解码（含查表转灰度），/map_updates 局部更新解码并写入 MapLayer，
+    //     写入后只有相交的瓦片在下一次绘制时重新生成
+    {
+        const int gridSize = qMax(16, parser.value(gridSizeOpt).toInt());
+        const QString dims = QStringLiteral("%1x%1").arg(gridSize);
+        RosBridgeDecoder decoder;
+        RosBridgeMessage message;
+
+        const QByteArray mapFrame = occupancyGridFrame(true, 0, 0, gridSize, gridSize);
+        const QJsonObject mapParams{{"cells", gridSize * gridSize}, {"bytes", mapFrame.size()}};
+        results.append(runCase(QStringLiteral("RosBridgeDecoder/map/%1/dom").arg(dims), mapParams, minNs,
+                               [&](qint64)
+                               { decoder.decodeDom(mapFrame, message); }));
+        results.append(runCase(QStringLiteral("RosBridgeDecoder/map/%1/stream").arg(dims), mapParams, minNs,
+                               [&](qint64)
+                               { decoder.decode(mapFrame, message); }));
+
+        const QByteArray cells = occupancyCells(gridSize, gridSize);
+        QImage gray;
+        results.append(runCase(QStringLiteral("OccupancyGrid::toGray/%1").arg(dims), QJsonObject{{"cells", gridSize * gridSize}}, minNs,
+                               [&](qint64)
+                               { OccupancyGrid::toGray(reinterpret_cast<const qint8 *>(cells.constData()), cells.size(), gridSize, gridSize, gray); }));
+
+        if (decoder.decode(mapFrame, message) && message.topic == RosBridgeMessage::Topic::Map)
+        {
+            MapLayer map;
+            map.updateMap(message.grid.image, message.grid.resolution, message.grid.originX, -message.grid.originY);
+            message.grid.image = QImage(); // 与运行时一致，图层独占图像
+
+            const QByteArray updateFrame = occupancyGridFrame(false, gridSize / 2, gridSize / 2, 64, 64);
+            results.append(runCase(QStringLiteral("RosBridgeDecoder/map_updates/64x64/stream"), QJsonObject{{"bytes", updateFrame.size()}}, minNs,
+                                   [&](qint64)
+                                   { decoder.decode(updateFrame, message); }));
+            decoder.decode(updateFrame, message);
+            const OccupancyGridPatch patch = message.grid;
+            const QPoint topLeft = patch.imageRect(map.size().height()).topLeft();
+            // 局部更新写入后重绘：每次只重新生成变化的瓦片，与不更新时的重绘对比
+            QImage canvas(CANVAS_W, CANVAS_H, QImage::Format_ARGB32_Premultiplied);
+            results.append(runCase(QStringLiteral("MapLayer::updateRegion+draw/64x64"), QJsonObject{{"grid", gridSize}}, minNs,
+                                   [&](qint64)
+                                   {
+                                       map.updateRegion(patch.image, topLeft);
+                                       canvas.fill(Qt::white);
+                                       QPainter painter(&canvas);
+                                       painter.translate(CANVAS_W / 2.0, CANVAS_H / 2.0);
+                                       painter.scale(50.0, 50.0);
+                                       map.draw(&painter); }));
+            results.append(renderCase(QStringLiteral("MapLayer"), &map, 50.0, QJsonObject{{"grid", gridSize}}, minNs));
+        }
+        message.grid.image = QImage();
+    }
+
+    // 2e. 重定位吻合度：距离场每次载入地图时在工作线程中计算一次，评估在拖动时每帧执行
+    {
+        const QImage mapImage = syntheticMapPixmap().toImage();
+        MapDistanceFieldPtr field;
+        results.append(runCase(QStringLiteral("MapDistanceField::build/%1x%2").arg(mapImage.width()).arg(mapImage.height()),
+                               QJsonObject{{"cells", mapImage.width() * mapImage.height()}}, minNs,
+                               [&](qint64)
+                               { field = MapDistanceField::build(mapImage, 0.05, -25.0, 15.0); }));
+        for (int n : scanSizes)
+        {
+            // 扫描换算到车辆 (2, 1) 的局部坐标；只测评估耗时，与合成地图是否吻合无关
+            const PointCloudBufferPtr cloud = toBuffer(scanPoints(n));
+            std::vector<float> local(cloud->xy(), cloud->xy() + 2 * n);
+            for (int i = 0; i < n; ++i)
+            {
+                local[2 * i] -= 2.0f;
+                local[2 * i + 1] -= 1.0f;
+            }
+            // 每次换一个位姿，模拟拖动
+            results.append(runCase(QStringLiteral("MapDistanceField::fit/%1").arg(n), QJsonObject{{"points", n}}, minNs,
+                                   [&](qint64 i)
+                                   { field->fit(local.data(), n, QPointF(0.01 * (i % 16), 0.0), 0.001 * (i % 32)); }));
+        }
+    }
+
+    // 3. 地图 JSON 载入
+    QVector<MapPointData> mapPoints;
+    QVector<MapPathData> mapPaths;
+    {
+        QTemporaryDir tmp;
+        QString mapPath = parser.value(mapOpt);
+        const int synPoints = qMax(1, parser.value(mapPointsOpt).toInt());
+        if (mapPath.isEmpty())
+        {
+            mapPath = tmp.filePath(QStringLiteral("bench_map.json"));
+            if (!writeSyntheticMap(mapPath, synPoints))
+            {
+                std::fprintf(stderr, "无法写入合成地图 %s\n", qPrintable(mapPath));
+                return 1;
+            }
+        }
+
+        MapDataManager manager;
+        if (!manager.parseMapJson(mapPath, mapPoints, mapPaths))
+        {
+            std::fprintf(stderr, "地图解析失败 %s\n", qPrintable(mapPath));
+            return 1;
+        }
+        const QString id = parser.isSet(mapOpt) ? QStringLiteral("MapDataManager::parseMapJson/file")
+                                                : QStringLiteral("MapDataManager::parseMapJson/%1").arg(synPoints);
+        results.append(runCase(id, QJsonObject{{"points", mapPoints.size()}, {"paths", mapPaths.size()}}, minNs,
+                               [&](qint64)
+                               { manager.parseMapJson(mapPath, mapPoints, mapPaths); }));
+    }
+
+    // 4. 各图层离屏绘制
+    {
+        GridLayer grid;
+        MapLayer map;
+        map.updateMap(syntheticMapPixmap(), 0.05, -25.0, 15.0);
+        PointPathLayer path;
+        path.updateData(mapPoints, mapPaths);
+        AgvLayer agv;
+        agv.updatePose(2000, 1000, 785);
+        RelocationLayer relo;
+        relo.setPos(QPointF(2.0, -1.0));
+        relo.setAngle(0.785);
+        FixedRelocationLayer fixed; // 站点来自配置目录下的 initial_points.json，缺失时为空
+        fixed.update(1);
+
+        for (double scale : scales)
+        {
+            results.append(renderCase(QStringLiteral("GridLayer"), &grid, scale, QJsonObject(), minNs));
+            results.append(renderCase(QStringLiteral("MapLayer"), &map, scale, QJsonObject(), minNs));
+            results.append(renderCase(QStringLiteral("PointPathLayer"), &path, scale,
+                                      QJsonObject{{"points", mapPoints.size()}}, minNs));
+            results.append(renderCase(QStringLiteral("AgvLayer"), &agv, scale, QJsonObject(), minNs));
+            for (int n : scanSizes)
+            {
+                const PointCloudBufferPtr raw = toBuffer(scanPoints(n));
+                PointCloudLayer cloud;
+                cloud.updatePoints(raw);
+                results.append(renderCase(QStringLiteral("PointCloudLayer"), &cloud, scale, QJsonObject{{"points", n}}, minNs));
+                ClippedLayer clipped(&cloud, QRect(0, 0, CANVAS_W * 3 / 4, CANVAS_H));
+                results.append(renderCase(QStringLiteral("PointCloudLayer"), &clipped, scale,
+                                          QJsonObject{{"points", n}, {"clip", true}}, minNs));
+                EllipseCloudLayer ellipse(raw);
+                results.append(renderCase(QStringLiteral("PointCloudEllipse"), &ellipse, scale, QJsonObject{{"points", n}}, minNs));
+                // 历史轨迹：视图不变时各帧复用缓存的像素，耗时应接近单帧的写像素开销之和
+                TrailCloudLayer trail(raw, 10);
+                ClippedLayer clippedTrail(&trail, QRect(0, 0, CANVAS_W * 3 / 4, CANVAS_H));
+                results.append(renderCase(QStringLiteral("PointCloudLayer"), &clippedTrail, scale,
+                                          QJsonObject{{"points", n}, {"trail", 10}, {"clip", true}}, minNs));
+
+                // 按该缩放档位降采样：降采样本身的耗时与降采样后的绘制耗时
+                PointCloudDecimator decimator;
+                const int bucket = PointCloudDecimator::bucketForScale(scale);
+                results.append(runCase(QStringLiteral("PointCloudDecimator/%1/x%2").arg(n).arg(scale),
+                                       QJsonObject{{"points", n}, {"scale", scale}}, minNs,
+                                       [&](qint64)
+                                       { decimator.decimate(raw, bucket); }));
+                PointCloudLayer lod;
+                lod.updatePoints(decimator.decimate(raw, bucket));
+                std::fprintf(stderr, "  降采样 %d -> %d 点（网格 %.1f mm）\n", n, lod.pointCount(),
+                             PointCloudDecimator::cellSize(bucket) * 1000.0);
+                results.append(renderCase(QStringLiteral("PointCloudLayer"), &lod, scale,
+                                          QJsonObject{{"points", n}, {"lod", true}}, minNs));
+            }
+            results.append(renderCase(QStringLiteral("RelocationLayer"), &relo, scale, QJsonObject(), minNs));
+            results.append(renderCase(QStringLiteral("FixedRelocationLayer"), &fixed, scale, QJsonObject(), minNs));
+        }
+    }
+
+    // 5. 网络线程布局：每个连接独占一个线程（网络线程数为 0）与共享一个 I/O 线程对比，
+    //    报告接收线程的 CPU 占用与上下文切换次数（仅 Linux）
+#ifdef Q_OS_LINUX
+    {
+        const int clients = qMax(1, parser.value(netClientsOpt).toInt());
+        const int hz = qMax(1, parser.value(netHzOpt).toInt());
+        const qint64 durationNs = qMax(1, parser.value(netSecondsOpt).toInt()) * 1000000000LL;
+        results.append(netLayoutCase(clients, 0, hz, 1024, durationNs));
+        results.append(netLayoutCase(clients, 1, hz, 1024, durationNs));
+    }
+#endif
+
+    // 输出 JSON
+    QJsonArray arr;
+    for (const CaseResult &r : results)
+        arr.append(resultJson(r));
+    QJsonObject root;
+    root.insert("benchmark", QStringLiteral("RuinapControlBench"));
+    root.insert("version", QStringLiteral(APP_VERSION));
+    root.insert("qt", QString::fromLatin1(qVersion()));
+    root.insert("time", QDateTime::currentDateTime().toString(Qt::ISODate));
+    root.insert("min_time_ms", minNs / 1000000);
+    root.insert("allocs_counted", AllocCounter::available());
+    root.insert("results", arr);
+    const QByteArray json = QJsonDocument(root).toJson(QJsonDocument::Indented);
+
+    if (parser.isSet(outputOpt))
+    {
+        QFile out(parser.value(outputOpt));
+        if (!out.open(QIODevice::WriteOnly | QIODevice::Truncate))
+        {
+            std::fprintf(stderr, "无法写入 %s\n", qPrintable(parser.value(outputOpt)));
+            return 1;
+        }
+        out.write(json);
+    }
+    else
+    {
+        std::fwrite(json.constData(), 1, static_cast<size_t>(json.size()), stdout);
+    }
+
+    int regressions = 0;
+    if (parser.isSet(baselineOpt))
+        regressions = compareBaseline(parser.value(baselineOpt), results, qMax(0.0, parser.value(maxRegOpt).toDouble()));
+
+    // 经由 aboutToQuit 让 NetworkReactor 在 QGuiApplication 析构前销毁 I/O 线程中的对象
+    QTimer::singleShot(0, &app, &QCoreApplication::quit);
+    app.exec();
+
+    return regressions > 0 ? 4 : 0;
+}
@@ -0,0 +1,45 @@
+#include "AllocCounter.h"
+#include <atomic>
+#include <cstddef>
+
+static std::atomic<quint64> s_allocCount{0};
+
+#if defined(__GLIBC__)
+extern "C"
+{
+    void *__libc_malloc(size_t size);
+    void *__libc_calloc(size_t n, size_t size);
+    void *__libc_realloc(void *ptr, size_t size);
+
+    void *malloc(size_t size)
+    {
+        s_allocCount.fetch_add(1, std::memory_order_relaxed);
+        return __libc_malloc(size);
+    }
+
+    void *calloc(size_t n, size_t size)
+    {
+        s_allocCount.fetch_add(1, std::memory_order_relaxed);
+        return __libc_calloc(n, size);
+    }
+
+    void *realloc(void *ptr, size_t size)
+    {
+        s_allocCount.fetch_add(1, std::memory_order_relaxed);
+        return __libc_realloc(ptr, size);
+    }
+}
+static const bool kAllocCounted = true;
+#else
+static const bool kAllocCounted = false;
+#endif
+
+bool AllocCounter::available()
+{
+    return kAllocCounted;
+}
+
+quint64 AllocCounter::count()
+{
+    return s_allocCount.load(std::memory_order_relaxed);
+}
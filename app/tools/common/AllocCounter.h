@@ -0,0 +1,16 @@
+#ifndef ALLOCCOUNTER_H
+#define ALLOCCOUNTER_H
+
+#include <QtGlobal>
+
+// 基准程序共用的分配计数：拦截 glibc 的 malloc 系列，operator new 最终也经过这里
+// 只编入基准程序，不放进 RuinapCore，否则主程序链接时也会被拦截
+namespace AllocCounter
+{
+    // 当前平台是否统计（非 glibc 平台不拦截，count() 恒为 0）
+    bool available();
+    // 进程启动以来的分配次数
+    quint64 count();
+}
+
+#endif // ALLOCCOUNTER_H